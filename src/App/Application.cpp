@@ -83,7 +83,10 @@ ErrorOr<void> App::Run() {
 
   TRY(m_bus.LoadRom(m_options.rom_path));
   m_cpu.Init();
+  m_cpu.SetEngine(m_options.engine);
+  m_cpu.SetPairProfilingEnabled(m_options.profile_pairs);
   m_ppu.Init();
+  m_bus.SetCatchUpEnabled(true);
 
   // Create the main screen window
   m_main_window = TRY(BNES::SDL::Window::FromSpec({
@@ -96,6 +99,9 @@ ErrorOr<void> App::Run() {
 
   // setup the m_screen
   TRY(m_screen.Init(m_main_window));
+  if (!m_options.palette_path.empty()) {
+    TRY(m_screen.LoadPalette(m_options.palette_path));
+  }
 
   auto time_point = std::chrono::system_clock::now();
 
@@ -155,8 +161,44 @@ ErrorOr<void> App::Run() {
       m_main_window.Present();
 
       while (m_cpu.Cycles() < target_cpu_cycles) {
-        m_cpu.RunInstruction(m_cpu.DecodeNextInstruction());
+        m_cpu.Step();
       }
+      // Bring the PPU up to date for the debug views
+      m_bus.Sync();
+      m_bus.DeliverCompletedFrame();
+    }
+  }
+
+  // The OS writes the save back on its own while we run, make sure it's all there before we go
+  if (auto result = m_bus.FlushSaveRam(); !result) {
+    m_logger->error("Could not write the save file: {}", result.error().Message());
+  } else if (m_bus.PrgRam().IsBatteryBacked()) {
+    m_logger->info("Game saved to {}", m_bus.PrgRam().Path().string());
+  }
+
+  const auto &icache_stats = m_cpu.GetInstructionCacheStats();
+  m_logger->info("Instruction cache: {} hits, {} misses, {} invalidations", icache_stats.hits, icache_stats.misses,
+                 icache_stats.invalidations);
+  if (m_cpu.Engine() == HW::CPU::ExecutionEngine::Block || m_cpu.Engine() == HW::CPU::ExecutionEngine::Dynarec) {
+    const auto &block_stats = m_cpu.GetBlockCacheStats();
+    m_logger->info("Block cache: {} blocks built (avg. {:.1f} instructions), {} executed, {} invalidations",
+                   block_stats.blocks_built, block_stats.AverageBlockLength(), block_stats.blocks_executed,
+                   block_stats.invalidations);
+  }
+  if (m_cpu.Engine() == HW::CPU::ExecutionEngine::Dynarec) {
+    const auto dynarec_stats = m_cpu.GetDynarecStats();
+    m_logger->info("Dynarec: {} blocks compiled, {} bytes of native code, {} flushes", dynarec_stats.compiled_blocks,
+                   dynarec_stats.arena_bytes_used, dynarec_stats.flushes);
+  }
+  const auto &idle_stats = m_cpu.GetIdleLoopStats();
+  m_logger->info("Idle loops: {} fast-forwards, {} cycles skipped", idle_stats.fast_forwards,
+                 idle_stats.skipped_cycles);
+  if (const auto *profile = m_cpu.GetPairProfile()) {
+    m_logger->info("Most frequent opcode pairs:");
+    for (const auto &pair : profile->MostFrequent(20)) {
+      m_logger->info("  {:>10}  ${:02X} ${:02X}  {} / {}", pair.count, pair.first, pair.second,
+                     m_cpu.DisassembleInstruction(m_cpu.DecodeInstruction(std::array<uint8_t, 3>{pair.first, 0, 0})),
+                     m_cpu.DisassembleInstruction(m_cpu.DecodeInstruction(std::array<uint8_t, 3>{pair.second, 0, 0})));
     }
   }
 
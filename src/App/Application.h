@@ -22,6 +22,9 @@ public:
     std::string rom_path{};
     bool batch{false};
     bool stepping{false};
+    HW::CPU::ExecutionEngine engine{HW::CPU::DefaultExecutionEngine};
+    bool profile_pairs{false};
+    std::string palette_path{};
   };
 
   explicit App(Options options) : m_options{std::move(options)}, m_logger{spdlog::stdout_color_st("App")} {}
@@ -0,0 +1,167 @@
+//
+// Created by Valerio Formato on 17-Oct-26.
+//
+
+#ifndef BNES_BLOCKCACHE_H
+#define BNES_BLOCKCACHE_H
+
+#include "HW/CodePageMap.h"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace BNES::HW {
+
+struct BlockCacheStats {
+  size_t blocks_built{0};
+  size_t instructions_built{0};
+  size_t blocks_executed{0};
+  size_t invalidations{0};
+  size_t flushes{0};
+
+  [[nodiscard]] double AverageBlockLength() const {
+    return blocks_built ? static_cast<double>(instructions_built) / static_cast<double>(blocks_built) : 0.0;
+  }
+};
+
+// Stores translated basic blocks by the address of their first instruction.
+// The same address rules of the InstructionCache apply: only internal RAM (folded onto its 2KB of physical memory) and
+// the cartridge space are cached. Blocks are also indexed by the 256-byte pages they overlap, so that a write only
+// looks at the few blocks around it and drops just the ones whose bytes it hits. Writes to pages without any block
+// are ignored right away, and if a CodePageMap is given the pages with blocks are marked there too.
+// BLOCK must expose `start` and `end` (one past the last byte) addresses.
+template <typename BLOCK> class BlockCache {
+public:
+  using Addr = std::uint16_t;
+
+  void TrackCodePages(CodePageMap &code_pages, uint8_t owner) {
+    m_code_pages = &code_pages;
+    m_owner = owner;
+  }
+
+  // Whether an instruction starting at the given address can be part of a block. Blocks never straddle the end of
+  // a RAM mirror or wrap around the address space, so that all their bytes map onto consecutive slots.
+  [[nodiscard]] static constexpr bool IsCacheable(Addr address) {
+    return address < 0x2000 ? (address & 0x7FF) <= 0x7FD : (address >= 0x6000 && address <= 0xFFFD);
+  }
+
+  // Whether a block starting at `start` can be extended with the instruction at `next`
+  [[nodiscard]] static constexpr bool CanExtend(Addr start, Addr next) {
+    return IsCacheable(next) && next > start && (start >= 0x2000 || (next >> 11) == (start >> 11));
+  }
+
+  [[nodiscard]] BLOCK *Find(Addr address) {
+    const auto it = m_blocks.find(Slot(address));
+    return it == m_blocks.end() ? nullptr : &it->second;
+  }
+
+  BLOCK &Insert(BLOCK block) {
+    const auto slot = Slot(block.start);
+    if (const auto it = m_blocks.find(slot); it != m_blocks.end()) {
+      Erase(it);
+    }
+
+    for (unsigned int page = slot >> 8; page <= Slot(block.end - 1) >> 8; ++page) {
+      m_page_blocks[page].push_back(slot);
+      if (m_code_pages) {
+        m_code_pages->Mark(m_owner, static_cast<Addr>(page << 8));
+      }
+    }
+
+    ++m_stats.blocks_built;
+    m_stats.instructions_built += block.instructions.size();
+
+    return m_blocks.emplace(slot, std::move(block)).first->second;
+  }
+
+  // Drops the blocks that contain the byte at the given address
+  void Invalidate(Addr address) {
+    if (address >= 0x2000 && address < 0x6000) {
+      return;
+    }
+
+    const auto slot = Slot(address);
+    auto &page_blocks = m_page_blocks[slot >> 8];
+    bool dropped = false;
+    // Erasing a block removes it from this list too, walking it backwards only skips entries already checked
+    for (size_t i = page_blocks.size(); i-- > 0;) {
+      const auto it = m_blocks.find(page_blocks[i]);
+      if (slot < Slot(it->second.start) || slot > Slot(it->second.end - 1)) {
+        continue;
+      }
+
+      Erase(it);
+      ++m_stats.invalidations;
+      dropped = true;
+    }
+
+    if (dropped) {
+      ++m_generation;
+    }
+  }
+
+  // Drops the blocks overlapping the pages from `first` to `last`, e.g. when a PRG bank is switched
+  void InvalidatePages(Addr first, Addr last) {
+    bool dropped = false;
+    for (unsigned int page = Slot(first) >> 8; page <= static_cast<unsigned int>(Slot(last) >> 8); ++page) {
+      auto &page_blocks = m_page_blocks[page];
+      while (!page_blocks.empty()) {
+        Erase(m_blocks.find(page_blocks.back()));
+        ++m_stats.invalidations;
+        dropped = true;
+      }
+    }
+
+    if (dropped) {
+      ++m_generation;
+    }
+  }
+
+  void Flush() {
+    m_blocks.clear();
+    for (auto &page_blocks : m_page_blocks) {
+      page_blocks.clear();
+    }
+    if (m_code_pages) {
+      m_code_pages->UnmarkAll(m_owner);
+    }
+    ++m_stats.flushes;
+    ++m_generation;
+  }
+
+  // Bumped every time blocks are dropped, so that whoever is running a block can tell it's gone
+  [[nodiscard]] size_t Generation() const { return m_generation; }
+
+  [[nodiscard]] const BlockCacheStats &GetStats() const { return m_stats; }
+  void CountExecution() { ++m_stats.blocks_executed; }
+
+private:
+  // RAM mirrors all map onto the same slots
+  static constexpr Addr Slot(Addr address) { return address < 0x2000 ? address & 0x7FF : address; }
+
+  void Erase(typename std::unordered_map<Addr, BLOCK>::iterator it) {
+    const auto slot = it->first;
+    for (unsigned int page = slot >> 8; page <= Slot(it->second.end - 1) >> 8; ++page) {
+      std::erase(m_page_blocks[page], slot);
+      if (m_code_pages && m_page_blocks[page].empty()) {
+        m_code_pages->Unmark(m_owner, static_cast<Addr>(page << 8));
+      }
+    }
+    m_blocks.erase(it);
+  }
+
+  std::unordered_map<Addr, BLOCK> m_blocks;
+  // Slots of the blocks overlapping each page
+  std::array<std::vector<Addr>, 256> m_page_blocks{};
+  CodePageMap *m_code_pages{nullptr};
+  uint8_t m_owner{0};
+  size_t m_generation{0};
+  BlockCacheStats m_stats{};
+};
+} // namespace BNES::HW
+
+#endif // BNES_BLOCKCACHE_H
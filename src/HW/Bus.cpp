@@ -5,6 +5,7 @@
 #include "HW/Bus.h"
 
 #include "HW/CPU.h"
+#include "HW/Mappers/Mapper.h"
 #include "HW/PPU.h"
 #include "HW/Screen.h"
 #include "Joypad.h"
@@ -12,10 +13,28 @@
 
 #include <spdlog/spdlog.h>
 
+#include <algorithm>
+#include <limits>
+
 namespace BNES::HW {
 
+Bus::Bus() {
+  MapDefaultPages();
+  // Until a ROM is loaded there is an empty NROM cartridge plugged in. A constructor has no way to hand the error
+  // back, but with no save file to open and mapper 0 nothing in there can fail.
+  if (auto result = OnCartridgeChanged(); !result) {
+    spdlog::error("Could not plug in the empty cartridge: {}", result.error().Message());
+  }
+}
+
+Bus::~Bus() = default;
+
 void Bus::Attach(CPU *cpu) { m_cpu = cpu; }
-void Bus::Attach(PPU *ppu) { m_ppu = ppu; }
+void Bus::Attach(PPU *ppu) {
+  m_ppu = ppu;
+  m_ppu_synced_at = m_scheduler.Now();
+  m_ppu->ScheduleEvents(m_scheduler);
+}
 void Bus::Attach(Joypad *joypad, unsigned int joy_no) {
   switch (joy_no) {
   case 1:
@@ -26,95 +45,283 @@ void Bus::Attach(Joypad *joypad, unsigned int joy_no) {
     break;
   }
 }
-void Bus::Attach(Screen *screen) { m_screen = screen; }
+void Bus::Attach(Screen *screen) {
+  SetFrameCompleteHook([screen](const PPU &ppu) { (void)screen->FillFromPPU(ppu); });
+}
 
-void Bus::PropagateNMI() {
-  m_cpu->ProcessNMI();
+void Bus::RaiseNMI() {
+  if (m_cpu) {
+    m_cpu->RaiseInterrupt(CPU::Interrupt::NMI);
+  }
+}
+
+void Bus::SetMapperIRQ(bool asserted) {
+  if (!m_cpu) {
+    return;
+  }
 
-  // Only fill screen if a screen is attached.
-  if (m_screen) {
-    m_screen->FillFromPPU(*m_ppu);
+  if (asserted) {
+    m_cpu->RaiseInterrupt(CPU::Interrupt::IRQ);
+  } else {
+    m_cpu->ClearInterrupt(CPU::Interrupt::IRQ);
   }
 }
 
-uint8_t Bus::Read(Addr address) {
-  if (address <= MAX_ADDRESSABLE_RAM_ADDRESS) {
-    // mask out bit 12 and 13 to simulate mirroring
-    address &= 0b11111111111;
-    return m_ram[address];
+void Bus::ClockScanlineCounter() { m_mapper->ClockScanlineCounter(); }
+
+void Bus::DeliverCompletedFrame() {
+  if (!m_frame_complete) {
+    return;
+  }
+
+  m_frame_complete = false;
+  if (m_frame_complete_hook) {
+    m_frame_complete_hook(*m_ppu);
   }
+}
 
-  if (address == 0x2000 || address == 0x2001 || address == 0x2003 || address == 0x2005 || address == 0x2006 ||
-      address == 0x4014) {
-    spdlog::error("Bus read request for address 0x{:04X}: Address is write-only", address);
-    throw std::runtime_error("Bus read request for write-only address");
+void Bus::MapPages(Addr first, Addr last, const uint8_t *read, uint8_t *write) {
+  const unsigned int first_page = first >> 8;
+  const unsigned int last_page = last >> 8;
+  for (unsigned int page = first_page; page <= last_page; ++page) {
+    const auto offset = (page - first_page) * PAGE_SIZE;
+    m_pages[page] = {read ? read + offset : nullptr, write ? write + offset : nullptr};
   }
-  if (address == 0x2002) {
-    return m_ppu->ReadPPUSTATUS();
+  UpdateFastPages(first_page, last_page);
+}
+
+void Bus::UnmapPages(Addr first, Addr last) { MapPages(first, last, nullptr, nullptr); }
+
+void Bus::AddReadHook(Addr first, Addr last, AccessHook hook) {
+  m_read_hooks.push_back({first, last, std::move(hook)});
+  UpdateFastPages(first >> 8, last >> 8);
+}
+
+void Bus::AddWriteHook(Addr first, Addr last, AccessHook hook) {
+  m_write_hooks.push_back({first, last, std::move(hook)});
+  UpdateFastPages(first >> 8, last >> 8);
+}
+
+void Bus::ClearHooks() {
+  m_read_hooks.clear();
+  m_write_hooks.clear();
+  UpdateFastPages(0, 0xFF);
+}
+
+void Bus::MapDefaultPages() {
+  m_pages.fill({});
+
+  // 2KB of internal RAM, mirrored up to $1FFF
+  for (unsigned int page = 0; page <= (MAX_ADDRESSABLE_RAM_ADDRESS >> 8); ++page) {
+    uint8_t *ram = m_ram.data() + (page & 0x7) * PAGE_SIZE;
+    m_pages[page] = {ram, ram};
   }
-  if (address == 0x2004) {
-    return m_ppu->ReadOAMDATA();
+
+  UpdateFastPages(0, 0xFF);
+}
+
+void Bus::MapProgramBank(Addr first, Addr last, const uint8_t *data) {
+  const unsigned int first_page = first >> 8;
+  const unsigned int last_page = last >> 8;
+
+  for (unsigned int page = first_page; page <= last_page; ++page) {
+    const uint8_t *new_page = data ? data + (page - first_page) * PAGE_SIZE : nullptr;
+    // Games often write the bank that is already selected, that must not cost anything
+    if (m_pages[page].read == new_page) {
+      continue;
+    }
+
+    const auto address = static_cast<Addr>(page << 8);
+    const auto last_address = static_cast<Addr>(address + PAGE_SIZE - 1);
+    MapPages(address, last_address, new_page, nullptr);
+    // Only the code decoded from the pages that changed goes. While a new cartridge is being set up there is no mapper
+    // yet, OnCartridgeChanged flushes once at the end.
+    if (m_cpu && m_mapper) {
+      m_cpu->InvalidateDecodedPages(address, last_address);
+    }
   }
-  if (address == 0x2007) {
-    return m_ppu->ReadPPUDATA();
+}
+
+void Bus::MapCharacterBank(Addr first, Addr last, const uint8_t *data, uint8_t *write) {
+  // The PPU has to finish what it was doing with the old bank
+  if (m_catch_up && m_ppu) {
+    Sync();
   }
-  if (address >= 0x2008 && address <= MAX_ADDRESSABLE_PPU_ADDRESS) {
-    // These are all mirrors of the PPU memory-mapped registers
-    Addr mirror_down_addr = address & 0b0010000000000111;
-    return Read(mirror_down_addr);
+
+  const unsigned int first_page = (first >> 10) & 0x7;
+  const unsigned int last_page = (last >> 10) & 0x7;
+  for (unsigned int page = first_page; page <= last_page; ++page) {
+    const auto offset = (page - first_page) * CHR_PAGE_SIZE;
+    const uint8_t *new_page = data ? data + offset : nullptr;
+    if (m_chr_pages[page] != new_page) {
+      m_chr_pages[page] = new_page;
+      MarkCharacterPagesDirty(page, page);
+    }
+    m_chr_write_pages[page] = write ? write + offset : nullptr;
   }
+}
+
+void Bus::TrackCharacterTiles(CharacterTileBitmap *dirty_tiles) {
+  dirty_tiles->set();
+  m_chr_trackers.push_back(dirty_tiles);
+}
+
+void Bus::UntrackCharacterTiles(CharacterTileBitmap *dirty_tiles) { std::erase(m_chr_trackers, dirty_tiles); }
 
-  if (address >= ROM_START_REGISTER && address <= MAX_ADDRESSABLE_ROM_ADDRESS) {
-    Addr rom_address = address - ROM_START_REGISTER;
-    // check if mirroring is needed
-    if (m_rom.program_rom.size() == 0x4000 && address >= 0x4000) {
-      rom_address %= 0x4000;
+void Bus::MarkCharacterPagesDirty(unsigned int first_page, unsigned int last_page) {
+  constexpr size_t tiles_per_page = CHR_PAGE_SIZE / CHR_TILE_SIZE;
+  for (auto *dirty_tiles : m_chr_trackers) {
+    for (size_t tile = first_page * tiles_per_page; tile < (last_page + 1) * tiles_per_page; ++tile) {
+      dirty_tiles->set(tile);
     }
-    return m_rom.program_rom[rom_address];
   }
+}
 
-  if (address == JOYPAD1_ADDRESS) {
-    return m_joypad1->Read();
+void Bus::SetMirroring(::BNES::HW::Rom::Mirroring mirroring) {
+  if (m_catch_up && m_ppu) {
+    Sync();
   }
 
-  if (address == JOYPAD1_ADDRESS) {
-    return m_joypad2->Read();
+  m_mirroring = mirroring;
+  if (m_ppu) {
+    m_ppu->SetMirroring(mirroring);
   }
+}
 
-  if (address >= PPU_START_REGISTER && address <= MAX_ADDRESSABLE_PPU_ADDRESS) {
-    TODO(fmt::format("PPU read for address 0x{:04X} not implemented yet", address));
+void Bus::MapProgramRam() {
+  if (m_prg_ram.Size() == 0) {
+    return;
+  }
+
+  // Straight into the page table, battery-backed or not the CPU writes go to memory without any bookkeeping
+  for (Addr address = PRG_RAM_START_REGISTER; address < MAX_ADDRESSABLE_PRG_RAM_ADDRESS; address += PAGE_SIZE) {
+    uint8_t *ram = m_prg_ram.Data() + (address - PRG_RAM_START_REGISTER) % m_prg_ram.Size();
+    MapPages(address, static_cast<Addr>(address + PAGE_SIZE - 1), ram, ram);
   }
+}
 
-  spdlog::error("Bus read request for address 0x{:04X}: Address out of range", address);
-  return 0;
+void Bus::UpdateFastPages(unsigned int first_page, unsigned int last_page) {
+  const auto hooked = [](const std::vector<Hook> &hooks, unsigned int page) {
+    return std::ranges::any_of(hooks, [page](const Hook &hook) {
+      return (hook.first >> 8) <= page && page <= (hook.last >> 8);
+    });
+  };
+
+  for (unsigned int page = first_page; page <= last_page; ++page) {
+    m_read_pages[page] = hooked(m_read_hooks, page) ? nullptr : m_pages[page].read;
+    m_write_pages[page] = hooked(m_write_hooks, page) ? nullptr : m_pages[page].write;
+  }
 }
 
-void Bus::Write(Addr address, uint8_t data) {
-  if (address <= MAX_ADDRESSABLE_RAM_ADDRESS) {
-    // mask out bit 12 and 13 to simulate mirroring
-    address &= 0b11111111111;
-    m_ram[address] = data;
+void Bus::InvalidateDecodedCode(Addr address) { m_cpu->InvalidateDecodedCode(address); }
 
+uint8_t Bus::ReadIO(Addr address) noexcept {
+  const auto &page = m_pages[address >> 8];
+  uint8_t value = page.read ? page.read[address & 0xFF] : ReadDevice(address);
+
+  for (const auto &hook : m_read_hooks) {
+    if (address >= hook.first && address <= hook.last) {
+      value = hook.hook(address, value);
+    }
+  }
+
+  return value;
+}
+
+void Bus::WriteIO(Addr address, uint8_t data) noexcept {
+  for (const auto &hook : m_write_hooks) {
+    if (address >= hook.first && address <= hook.last) {
+      data = hook.hook(address, data);
+    }
+  }
+
+  if (const auto &page = m_pages[address >> 8]; page.write) {
+    page.write[address & 0xFF] = data;
+    if (m_code_pages.HoldsCode(address)) {
+      InvalidateDecodedCode(address);
+    }
     return;
   }
 
-  if (address == 0x2000) {
-    m_ppu->WritePPUCTRL(data);
-  } else if (address == 0x2001) {
-    m_ppu->WritePPUMASK(data);
-  } else if (address == 0x2003) {
-    m_ppu->WriteOAMADDR(data);
-  } else if (address == 0x2004) {
-    m_ppu->WriteOAMDATA(data);
-  } else if (address == 0x2005) {
-    m_ppu->WritePPUSCROLL(data);
-  } else if (address == 0x2006) {
-    m_ppu->WritePPUADDR(data);
-  } else if (address == 0x2007) {
-    m_ppu->WritePPUDATA(data);
-  } else if (address >= 0x2008 && address <= MAX_ADDRESSABLE_PPU_ADDRESS) {
-    Addr mirror_down_addr = address & 0b0010000000000111;
-    Write(mirror_down_addr, data);
+  WriteDevice(address, data);
+}
+
+uint8_t Bus::ReadDevice(Addr address) noexcept {
+  if (m_catch_up && IsPPUAddress(address)) {
+    Sync();
+  }
+
+  if (address >= PPU_START_REGISTER && address <= MAX_ADDRESSABLE_PPU_ADDRESS) {
+    // $2008-$3FFF are all mirrors of the PPU memory-mapped registers
+    switch (address & 0b0010000000000111) {
+    case 0x2002:
+      m_ppu_latch = m_ppu->ReadPPUSTATUS();
+      return m_ppu_latch;
+    case 0x2004:
+      m_ppu_latch = m_ppu->ReadOAMDATA();
+      return m_ppu_latch;
+    case 0x2007:
+      m_ppu_latch = m_ppu->ReadPPUDATA();
+      return m_ppu_latch;
+    default:
+      // Write-only register, what comes back is whatever was last put on the PPU data bus
+      ++m_diagnostics.write_only_reads;
+      return m_ppu_latch;
+    }
+  }
+
+  if (address == JOYPAD1_ADDRESS && m_joypad1) {
+    return m_joypad1->Read();
+  }
+
+  if (address == JOYPAD2_ADDRESS && m_joypad2) {
+    return m_joypad2->Read();
+  }
+
+  return ReadOpenBus(address);
+}
+
+uint8_t Bus::ReadOpenBus(Addr address) noexcept {
+  // Nothing drives the data bus, so it still holds the last byte the CPU fetched. The instructions that get here use
+  // absolute (possibly indexed) addressing, whose last fetch is the high byte of the address.
+  ++m_diagnostics.open_bus_reads;
+  return static_cast<uint8_t>(address >> 8);
+}
+
+void Bus::WriteDevice(Addr address, uint8_t data) noexcept {
+  if (m_catch_up && IsPPUTimingAddress(address)) {
+    Sync();
+  }
+
+  if (address >= PPU_START_REGISTER && address <= MAX_ADDRESSABLE_PPU_ADDRESS) {
+    m_ppu_latch = data;
+    // $2008-$3FFF are all mirrors of the PPU memory-mapped registers
+    switch (address & 0b0010000000000111) {
+    case 0x2000:
+      m_ppu->WritePPUCTRL(data);
+      break;
+    case 0x2001:
+      m_ppu->WritePPUMASK(data);
+      break;
+    case 0x2002:
+      // PPUSTATUS is read-only, the write only reaches the latch
+      break;
+    case 0x2003:
+      m_ppu->WriteOAMADDR(data);
+      break;
+    case 0x2004:
+      m_ppu->WriteOAMDATA(data);
+      break;
+    case 0x2005:
+      m_ppu->WritePPUSCROLL(data);
+      break;
+    case 0x2006:
+      m_ppu->WritePPUADDR(data);
+      break;
+    case 0x2007:
+      m_ppu->WritePPUDATA(data);
+      break;
+    }
   } else if (address == 0x4014) { // OAMDMM transfer
     Addr starting_addr = 0x100 * data;
     auto oam_data =
@@ -126,35 +333,131 @@ void Bus::Write(Addr address, uint8_t data) {
     //       one (or two) idle cycles, and then 256 pairs of alternating read/write cycles. (For comparison, an unrolled
     //       LDA/STA loop would usually take four times as long.)
     Tick((m_cpu->Cycles() % 2) ? 514 : 513);
-  } else if (address >= PPU_START_REGISTER && address <= MAX_ADDRESSABLE_PPU_ADDRESS) {
-    TODO(fmt::format("PPU write for address 0x{:04X} not implemented yet", address));
   } else if (address >= ROM_START_REGISTER && address <= MAX_ADDRESSABLE_ROM_ADDRESS) {
-    spdlog::error("CANNOT WRITE TO ROM MEMORY!!!");
-    throw std::runtime_error("Can't write to ROM memory");
-  } else if (address == JOYPAD1_ADDRESS) {
-    m_joypad1->Write(data);
+    // This is where mappers listen for bank switches. A plain NROM cartridge has nothing here, the write is lost.
+    if (!m_mapper || !m_mapper->WriteRegister(address, data)) {
+      ++m_diagnostics.rom_writes;
+    }
   } else if (address == JOYPAD1_ADDRESS) {
-    m_joypad2->Write(data);
+    // Both controllers share the strobe line ($4017 writes go to the APU frame counter instead)
+    if (m_joypad1) {
+      m_joypad1->Write(data);
+    }
+    if (m_joypad2) {
+      m_joypad2->Write(data);
+    }
+  } else {
+    ++m_diagnostics.unmapped_writes;
   }
 
-  else {
-    spdlog::error("Bus write request for address 0x{:04X}: Address out of range", address);
+  // Writing to the PPU registers can move its next event around (e.g. enabling rendering or moving sprite 0), and so
+  // can reprogramming the mapper IRQ
+  if (m_ppu && IsPPUTimingAddress(address)) {
+    Sync();
   }
 }
 
-void Bus::Tick(unsigned int cycles) { m_ppu->Tick(cycles * PPU_FREQ_RATIO); }
+ErrorOr<void> Bus::OnCartridgeChanged(const std::filesystem::path &save_file) {
+  // The new mapper maps its own banks, nothing from the old cartridge can stay around
+  UnmapPages(PRG_RAM_START_REGISTER, MAX_ADDRESSABLE_ROM_ADDRESS);
+  m_chr_pages.fill(nullptr);
+  m_chr_write_pages.fill(nullptr);
+  MarkCharacterPagesDirty(0, 7);
+  m_mapper.reset();
+  m_scanline_counter = false;
+  SetMapperIRQ(false);
+
+  // Smaller RAMs are mirrored over whole pages, round them up to at least one
+  if (m_rom.has_battery && m_rom.prg_nvram_size > 0 && !save_file.empty()) {
+    m_prg_ram = TRY(SaveRam::FromFile(save_file, std::max(m_rom.prg_nvram_size, PAGE_SIZE)));
+  } else if (const size_t size = m_rom.prg_ram_size + m_rom.prg_nvram_size; size > 0) {
+    m_prg_ram = SaveRam::Volatile(std::max(size, PAGE_SIZE));
+  } else {
+    m_prg_ram = {};
+  }
+  MapProgramRam();
+
+  size_t chr_ram_size = m_rom.chr_ram_size + m_rom.chr_nvram_size;
+  if (chr_ram_size == 0 && m_rom.character_rom.empty()) {
+    chr_ram_size = 0x2000;
+  }
+  m_chr_ram.assign(chr_ram_size, 0);
+
+  SetMirroring(m_rom.mirroring);
+  auto mapper = TRY(Mapper::FromRom(*this, m_rom));
+  mapper->Reset();
+  m_mapper = std::move(mapper);
+  m_scanline_counter = m_mapper->CountsScanlines();
+
+  if (m_cpu) {
+    m_cpu->FlushDecodedCode();
+  }
+
+  return {};
+}
+
+void Bus::Tick(unsigned int cycles) {
+  m_scheduler.Advance(cycles * PPU_FREQ_RATIO);
+
+  // Until the next event nothing the PPU does is visible to the CPU, so ticking now or later makes no difference.
+  // Without catch-up the PPU runs along with the CPU, but its deadlines only change when one of them is reached or
+  // when its registers are written (see WriteDevice), so there's no need to collect them again every time.
+  if (!m_catch_up) {
+    CatchUpPPU();
+  }
+  if (m_scheduler.EventDue()) {
+    Sync();
+  }
+}
+
+void Bus::Sync() {
+  CatchUpPPU();
+
+  // All the events we have so far belong to the PPU (the mapper IRQ is driven by PPU timing too), catching it up is
+  // all they need
+  while (m_scheduler.PopDueEvent()) {
+  }
+  m_ppu->ScheduleEvents(m_scheduler);
+}
+
+void Bus::CatchUpPPU() {
+  const auto now = m_scheduler.Now();
+  if (now > m_ppu_synced_at) {
+    const auto dots = static_cast<unsigned int>(now - m_ppu_synced_at);
+    m_ppu_synced_at = now;
+    m_ppu->Tick(dots);
+  }
+}
+
+void Bus::SetCatchUpEnabled(bool enabled) {
+  Sync();
+  m_catch_up = enabled;
+}
+
+unsigned int Bus::CyclesUntilNextEvent() const {
+  const auto now = m_scheduler.Now();
+  const auto next_event = m_scheduler.NextEventTime();
+  if (next_event <= now) {
+    return 0;
+  }
+
+  return static_cast<unsigned int>(
+      std::min<Scheduler::Timestamp>((next_event - now) / PPU_FREQ_RATIO, std::numeric_limits<unsigned int>::max()));
+}
 
 ErrorOr<void> Bus::LoadIntoProgramRom(std::span<const uint8_t> program) {
   if (program.size() > (MAX_ADDRESSABLE_ROM_ADDRESS - ROM_START_REGISTER + 1)) {
     return make_error(std::make_error_code(std::errc::not_enough_memory), "Program too large to fit in memory");
   }
 
-  if (program.size() > m_rom.program_rom.size()) {
-    m_rom.program_rom.resize(program.size());
+  // Mappers only map whole pages, the rest of the last one reads as zero
+  const size_t size = (program.size() + PAGE_SIZE - 1) / PAGE_SIZE * PAGE_SIZE;
+  if (size > m_rom.program_rom.size()) {
+    m_rom.program_rom.resize(size);
   }
   std::ranges::copy(program, m_rom.program_rom.begin());
 
-  return {};
+  return OnCartridgeChanged();
 }
 
 ErrorOr<void> Bus::LoadIntoChrRom(std::span<const uint8_t> chr_data) {
@@ -165,7 +468,7 @@ ErrorOr<void> Bus::LoadIntoChrRom(std::span<const uint8_t> chr_data) {
   m_rom.character_rom.resize(chr_data.size());
   std::ranges::copy(chr_data, m_rom.character_rom.begin());
 
-  return {};
+  return OnCartridgeChanged();
 }
 
 } // namespace BNES::HW
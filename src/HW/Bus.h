@@ -5,13 +5,21 @@
 #ifndef BNES_BUS_H
 #define BNES_BUS_H
 
+#include "HW/CodePageMap.h"
 #include "HW/Rom.h"
+#include "HW/SaveRam.h"
+#include "HW/Scheduler.h"
 #include "common/Types/non_owning_ptr.h"
 
 #include <array>
+#include <bitset>
 #include <cstddef>
 #include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <memory>
 #include <span>
+#include <vector>
 
 namespace BNES::HW {
 
@@ -20,8 +28,21 @@ class CPU;
 class PPU;
 class Joypad;
 class Screen;
+class Mapper;
+class Dynarec;
+
+// Accesses that real hardware shrugs off (and some games rely on), counted instead of stopping the emulation
+struct BusDiagnostics {
+  size_t open_bus_reads{0};   // Reads from addresses nothing answers to
+  size_t write_only_reads{0}; // Reads from write-only PPU registers
+  size_t rom_writes{0};       // Writes to PRG ROM that no mapper picked up
+  size_t unmapped_writes{0};  // Writes to addresses nothing listens to (e.g. the APU registers)
+};
 
 class Bus {
+  // The native code reads the page tables directly
+  friend class Dynarec;
+
 public:
   using Addr = std::uint16_t;
 
@@ -29,6 +50,8 @@ public:
   static constexpr size_t MAX_ADDRESSABLE_RAM_ADDRESS = 0x1FFF;
   static constexpr size_t PPU_START_REGISTER = 0x2000;
   static constexpr size_t MAX_ADDRESSABLE_PPU_ADDRESS = 0x3FFF;
+  static constexpr size_t PRG_RAM_START_REGISTER = 0x6000;
+  static constexpr size_t MAX_ADDRESSABLE_PRG_RAM_ADDRESS = 0x7FFF;
   static constexpr size_t ROM_START_REGISTER = 0x8000;
   static constexpr size_t MAX_ADDRESSABLE_ROM_ADDRESS = 0xFFFF;
   static constexpr size_t JOYPAD1_ADDRESS = 0x4016;
@@ -36,9 +59,23 @@ public:
 
   static constexpr unsigned int PPU_FREQ_RATIO = 3; // ratio between PPU clock freq and CPU clock freq
 
+  Bus();
+  ~Bus();
+
+  // The memory map points into the bus itself
+  Bus(const Bus &) = delete;
+  Bus &operator=(const Bus &) = delete;
+
   [[nodiscard]] ErrorOr<void> LoadRom(std::string_view rom_file) {
     m_rom = TRY(::BNES::HW::Rom::FromFile(rom_file));
-    return {};
+    // Battery-backed RAM is saved next to the ROM
+    return OnCartridgeChanged(std::filesystem::path{rom_file}.replace_extension(".sav"));
+  }
+
+  // Insert an already parsed (or built in memory) cartridge
+  [[nodiscard]] ErrorOr<void> LoadRom(::BNES::HW::Rom rom) {
+    m_rom = std::move(rom);
+    return OnCartridgeChanged();
   }
 
   void Attach(CPU *cpu);
@@ -46,28 +83,254 @@ public:
   void Attach(Joypad *joypad, unsigned int joy_no);
   void Attach(Screen *screen);
 
-  void PropagateNMI();
+  // Latches an NMI in the CPU, it will be serviced before its next instruction
+  void RaiseNMI();
+
+  // Cartridge IRQ line. It stays asserted until the mapper acknowledges it.
+  void SetMapperIRQ(bool asserted);
+
+  // Some mappers (MMC3) count scanlines by watching the PPU address line A12. The PPU doesn't simulate its memory
+  // fetches, it works out when A12 rises from the rendering settings and calls ClockScanlineCounter() for each edge.
+  [[nodiscard]] bool HasScanlineCounter() const { return m_scanline_counter; }
+  void ClockScanlineCounter();
+
+  // Called with the PPU every time it completes a frame, to turn it into pixels (an attached Screen registers itself
+  // here). The PPU only flags the frame as complete at the start of vblank, the hook runs when the frontend calls
+  // DeliverCompletedFrame() between batches of CPU instructions, never from the middle of one.
+  using FrameCompleteHook = std::function<void(const PPU &)>;
+  void SetFrameCompleteHook(FrameCompleteHook hook) { m_frame_complete_hook = std::move(hook); }
+  void SignalFrameComplete() { m_frame_complete = true; }
+  void DeliverCompletedFrame();
+
+  // Pages backed by memory (RAM and PRG ROM) are accessed right away, everything else goes through the I/O path
+  [[nodiscard]] uint8_t Read(Addr address) noexcept {
+    if (const uint8_t *page = m_read_pages[address >> 8]) [[likely]] {
+      return page[address & 0xFF];
+    }
+    return ReadIO(address);
+  }
+
+  void Write(Addr address, uint8_t data) noexcept {
+    if (uint8_t *page = m_write_pages[address >> 8]) [[likely]] {
+      page[address & 0xFF] = data;
+      // This might have been code, drop any decoded instruction that includes this byte
+      if (m_code_pages.HoldsCode(address)) [[unlikely]] {
+        InvalidateDecodedCode(address);
+      }
+      return;
+    }
+    WriteIO(address, data);
+  }
+
+  // Same as Read/Write, for accesses whose page is known at compile time: zero page and stack accesses from the CPU
+  // don't even need to look at the address to find their page.
+  template <unsigned int PAGE> [[nodiscard]] uint8_t ReadPage(uint8_t offset) noexcept {
+    static_assert(PAGE < 0x100, "Page index out of range");
+    if (const uint8_t *page = m_read_pages[PAGE]) [[likely]] {
+      return page[offset];
+    }
+    return ReadIO(static_cast<Addr>(PAGE << 8 | offset));
+  }
+
+  template <unsigned int PAGE> void WritePage(uint8_t offset, uint8_t data) noexcept {
+    static_assert(PAGE < 0x100, "Page index out of range");
+    if (uint8_t *page = m_write_pages[PAGE]) [[likely]] {
+      page[offset] = data;
+      if (m_code_pages.HoldsCode(PAGE << 8)) [[unlikely]] {
+        InvalidateDecodedCode(static_cast<Addr>(PAGE << 8 | offset));
+      }
+      return;
+    }
+    WriteIO(static_cast<Addr>(PAGE << 8 | offset), data);
+  }
+
+  // Opcode and operand fetch: the instruction bytes are copied straight from the page when they all sit in one (which
+  // is almost always the case for code running from PRG ROM)
+  [[nodiscard]] std::array<uint8_t, 3> FetchInstruction(Addr address) noexcept {
+    const uint8_t *page = m_read_pages[address >> 8];
+    if (const unsigned int offset = address & 0xFF; page && offset <= PAGE_SIZE - 3) [[likely]] {
+      return {page[offset], page[offset + 1], page[offset + 2]};
+    }
+    return {Read(address), Read(address + 1), Read(address + 2)};
+  }
+
+  // The memory map: the address space is split in 256-byte pages, each one either pointing straight into memory or
+  // left to the I/O path (PPU and APU registers, joypads, anything unmapped).
+  // RAM is mapped by default, the cartridge mapper maps its PRG banks (or unmaps pages it wants to handle) on top.
+  static constexpr size_t PAGE_SIZE = 0x100;
+  void MapPages(Addr first, Addr last, const uint8_t *read, uint8_t *write);
+  void UnmapPages(Addr first, Addr last);
+
+  // Bank switching, as done by the mapper. Switching a PRG bank drops the code decoded from the pages it replaces.
+  void MapProgramBank(Addr first, Addr last, const uint8_t *data);
+
+  // The PPU side of the cartridge: the pattern tables ($0000-$1FFF) are mapped in 1KB pages, the same way as the CPU
+  // address space. Unmapped pages read as zero, only CHR-RAM pages can be written.
+  static constexpr size_t CHR_PAGE_SIZE = 0x400;
+  static constexpr size_t CHR_TILE_SIZE = 16;
+  static constexpr size_t CHR_TILE_COUNT = 512;
+  void MapCharacterBank(Addr first, Addr last, const uint8_t *data, uint8_t *write = nullptr);
+
+  // Boards without CHR ROM have RAM in its place (8KB unless the header says otherwise)
+  [[nodiscard]] std::span<uint8_t> CharacterRam() { return m_chr_ram; }
+
+  [[nodiscard]] uint8_t ReadCharacter(Addr address) const noexcept {
+    const uint8_t *page = m_chr_pages[(address >> 10) & 0x7];
+    return page ? page[address & (CHR_PAGE_SIZE - 1)] : 0;
+  }
+
+  // Returns false if there is no CHR-RAM at that address
+  bool WriteCharacter(Addr address, uint8_t value) noexcept {
+    uint8_t *page = m_chr_write_pages[(address >> 10) & 0x7];
+    if (!page) {
+      return false;
+    }
+
+    page[address & (CHR_PAGE_SIZE - 1)] = value;
+    for (auto *dirty_tiles : m_chr_trackers) {
+      dirty_tiles->set((address & 0x1FFF) / CHR_TILE_SIZE);
+    }
+    return true;
+  }
+
+  // Whoever keeps decoded pattern table tiles around registers a bitmap here (one bit per tile, in pattern table
+  // order), and the bus sets the bits of the tiles that change: CHR-RAM writes and CHR bank switches. Clearing them
+  // is up to the owner. Bitmaps start with all tiles dirty.
+  using CharacterTileBitmap = std::bitset<CHR_TILE_COUNT>;
+  void TrackCharacterTiles(CharacterTileBitmap *dirty_tiles);
+  void UntrackCharacterTiles(CharacterTileBitmap *dirty_tiles);
+
+  // The 16 bytes of the tile at the given address (tiles never straddle two pages)
+  [[nodiscard]] std::span<const uint8_t, CHR_TILE_SIZE> CharacterTile(Addr address) const noexcept {
+    const uint8_t *page = m_chr_pages[(address >> 10) & 0x7];
+    return std::span<const uint8_t, CHR_TILE_SIZE>{
+        page ? page + (address & (CHR_PAGE_SIZE - CHR_TILE_SIZE)) : s_blank_tile.data(), CHR_TILE_SIZE};
+  }
 
-  [[nodiscard]] uint8_t Read(Addr address);
-  void Write(Addr address, uint8_t data);
+  // Nametable mirroring starts as the ROM header says, but some mappers can change it at runtime
+  void SetMirroring(::BNES::HW::Rom::Mirroring mirroring);
+  [[nodiscard]] ::BNES::HW::Rom::Mirroring NametableMirroring() const { return m_mirroring; }
 
+  // Hooks see every value read from or written to a range of addresses, and can replace it (e.g. cheats). Watchpoints
+  // just return the value they're given. Hooked pages always go through the I/O path.
+  using AccessHook = std::function<uint8_t(Addr address, uint8_t value)>;
+  void AddReadHook(Addr first, Addr last, AccessHook hook);
+  void AddWriteHook(Addr first, Addr last, AccessHook hook);
+  void ClearHooks();
+
+  // Advances the master clock by the given number of CPU cycles
   void Tick(unsigned int cycles);
 
+  // How many CPU cycles can be accumulated before calling Tick() without missing any scheduled event
+  [[nodiscard]] unsigned int CyclesUntilNextEvent() const;
+
+  // In catch-up mode Tick() only advances the master clock. The PPU is brought up to date when the CPU touches one of
+  // its registers ($2000-$3FFF, $4014) or when the clock reaches the next scheduled event (vblank NMI, sprite-0 hit,
+  // end of frame). Anyone else looking at the PPU state should call Sync() first.
+  void SetCatchUpEnabled(bool enabled);
+  [[nodiscard]] bool CatchUpEnabled() const { return m_catch_up; }
+
+  // Runs the PPU up to the current time and collects its next deadlines
+  void Sync();
+
+  [[nodiscard]] const Scheduler &GetScheduler() const { return m_scheduler; }
+
+  [[nodiscard]] const BusDiagnostics &Diagnostics() const { return m_diagnostics; }
+
+  // Where the CPU keeps decoded code, so that writes to memory can tell whether they have to invalidate any
+  [[nodiscard]] CodePageMap &DecodedCodePages() { return m_code_pages; }
+
   // Used mainly in unit tests...
   ErrorOr<void> LoadIntoProgramRom(std::span<const uint8_t> program);
   ErrorOr<void> LoadIntoChrRom(std::span<const uint8_t> chr_data);
 
   [[nodiscard]] const ::BNES::HW::Rom &Rom() const { return m_rom; };
+  [[nodiscard]] const SaveRam &PrgRam() const { return m_prg_ram; }
+  // Writes battery-backed RAM back to the save file right away, instead of whenever the OS gets to it
+  ErrorOr<void> FlushSaveRam() { return m_prg_ram.Flush(); }
+
+  // Null when the cartridge asks for a mapper we do not support
+  [[nodiscard]] const Mapper *CartridgeMapper() const { return m_mapper.get(); }
 
 private:
+  struct Page {
+    const uint8_t *read{nullptr};
+    uint8_t *write{nullptr};
+  };
+
+  struct Hook {
+    Addr first;
+    Addr last;
+    AccessHook hook;
+  };
+
   std::array<uint8_t, RAM_MEM_SIZE> m_ram{0};
   ::BNES::HW::Rom m_rom{};
+  std::unique_ptr<Mapper> m_mapper;
+  bool m_scanline_counter{false};
+  SaveRam m_prg_ram;
+  ::BNES::HW::Rom::Mirroring m_mirroring{::BNES::HW::Rom::Mirroring::Vertical};
 
   CPU *m_cpu{nullptr};
   PPU *m_ppu{nullptr};
   Joypad *m_joypad1{nullptr};
   Joypad *m_joypad2{nullptr};
-  Screen *m_screen{nullptr};
+
+  // The actual memory map, and what the fast path uses (the same pointers, minus the hooked pages)
+  std::array<Page, 0x100> m_pages{};
+  std::array<const uint8_t *, 0x100> m_read_pages{};
+  std::array<uint8_t *, 0x100> m_write_pages{};
+  std::vector<Hook> m_read_hooks;
+  std::vector<Hook> m_write_hooks;
+  CodePageMap m_code_pages;
+
+  // Pattern table pages, as seen by the PPU
+  std::array<const uint8_t *, 8> m_chr_pages{};
+  std::array<uint8_t *, 8> m_chr_write_pages{};
+  std::vector<uint8_t> m_chr_ram;
+  std::vector<CharacterTileBitmap *> m_chr_trackers;
+  static constexpr std::array<uint8_t, CHR_TILE_SIZE> s_blank_tile{};
+
+  // Last value written to or read from a PPU register, which is what reading a write-only one returns
+  uint8_t m_ppu_latch{0};
+  BusDiagnostics m_diagnostics{};
+
+  FrameCompleteHook m_frame_complete_hook;
+  bool m_frame_complete{false};
+
+  Scheduler m_scheduler;
+  Scheduler::Timestamp m_ppu_synced_at{0};
+  bool m_catch_up{false};
+
+  [[nodiscard]] static constexpr bool IsPPUAddress(Addr address) {
+    return (address >= PPU_START_REGISTER && address <= MAX_ADDRESSABLE_PPU_ADDRESS) || address == 0x4014;
+  }
+
+  // Writes that can move the next PPU event around: PPU registers, and the mapper ones when it counts scanlines
+  [[nodiscard]] bool IsPPUTimingAddress(Addr address) const {
+    return IsPPUAddress(address) || (m_scanline_counter && address >= ROM_START_REGISTER);
+  }
+
+  // Runs the PPU up to the current time, leaving the scheduled events alone
+  void CatchUpPPU();
+
+  // Slow path: hooks, then either the page memory or the devices
+  [[nodiscard]] uint8_t ReadIO(Addr address) noexcept;
+  void WriteIO(Addr address, uint8_t data) noexcept;
+  [[nodiscard]] uint8_t ReadDevice(Addr address) noexcept;
+  void WriteDevice(Addr address, uint8_t data) noexcept;
+  [[nodiscard]] uint8_t ReadOpenBus(Addr address) noexcept;
+
+  void InvalidateDecodedCode(Addr address);
+
+  void MapDefaultPages();
+  void UpdateFastPages(unsigned int first_page, unsigned int last_page);
+
+  // Sets up the mapper and PRG-RAM for the current ROM and drops anything derived from the old program (e.g. the CPU
+  // instruction cache). Battery-backed RAM is loaded from and saved to `save_file`, without one it's just plain RAM.
+  [[nodiscard]] ErrorOr<void> OnCartridgeChanged(const std::filesystem::path &save_file = {});
+  void MapProgramRam();
+  void MarkCharacterPagesDirty(unsigned int first_page, unsigned int last_page);
 };
 } // namespace BNES::HW
 
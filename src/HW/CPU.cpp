@@ -2,466 +2,470 @@
 #include "common/Types/overloaded.h"
 
 #include <algorithm>
+#include <optional>
 #include <spdlog/sinks/stdout_color_sinks.h>
+#include <tuple>
 
 namespace BNES::HW {
 
 std::shared_ptr<spdlog::logger> CPU::s_logger = spdlog::stdout_color_st("CPU");
 
-CPU::Instruction CPU::DecodeInstruction(std::span<const uint8_t> bytes) const {
+// Maps an opcode to its instruction type and hands the decoded instruction to the visitor. This is the only place
+// where the opcode -> instruction mapping lives, both the variant decoder and the handler table go through here.
+template <typename Visitor> decltype(auto) CPU::VisitOpCode(std::span<const uint8_t> bytes, Visitor &&visitor) {
   assert(!bytes.empty());
 
   auto opcode = static_cast<OpCode>(bytes[0]);
 
   switch (opcode) {
   case OpCode::Break:
-    return Break{};
+    return visitor(Break{});
   // Load instructions
   case OpCode::LDA_Immediate:
-    return LoadRegister<Register::A, AddressingMode::Immediate>{bytes[1]};
+    return visitor(LoadRegister<Register::A, AddressingMode::Immediate>{bytes[1]});
   case OpCode::LDX_Immediate:
-    return LoadRegister<Register::X, AddressingMode::Immediate>{bytes[1]};
+    return visitor(LoadRegister<Register::X, AddressingMode::Immediate>{bytes[1]});
   case OpCode::LDY_Immediate:
-    return LoadRegister<Register::Y, AddressingMode::Immediate>{bytes[1]};
+    return visitor(LoadRegister<Register::Y, AddressingMode::Immediate>{bytes[1]});
   case OpCode::LDA_ZeroPage:
-    return LoadRegister<Register::A, AddressingMode::ZeroPage>{bytes[1]};
+    return visitor(LoadRegister<Register::A, AddressingMode::ZeroPage>{bytes[1]});
   case OpCode::LDX_ZeroPage:
-    return LoadRegister<Register::X, AddressingMode::ZeroPage>{bytes[1]};
+    return visitor(LoadRegister<Register::X, AddressingMode::ZeroPage>{bytes[1]});
   case OpCode::LDY_ZeroPage:
-    return LoadRegister<Register::Y, AddressingMode::ZeroPage>{bytes[1]};
+    return visitor(LoadRegister<Register::Y, AddressingMode::ZeroPage>{bytes[1]});
   case OpCode::LDA_ZeroPageX:
-    return LoadRegister<Register::A, AddressingMode::ZeroPageX>{bytes[1]};
+    return visitor(LoadRegister<Register::A, AddressingMode::ZeroPageX>{bytes[1]});
   case OpCode::LDX_ZeroPageY:
-    return LoadRegister<Register::X, AddressingMode::ZeroPageY>{bytes[1]};
+    return visitor(LoadRegister<Register::X, AddressingMode::ZeroPageY>{bytes[1]});
   case OpCode::LDY_ZeroPageX:
-    return LoadRegister<Register::Y, AddressingMode::ZeroPageX>{bytes[1]};
+    return visitor(LoadRegister<Register::Y, AddressingMode::ZeroPageX>{bytes[1]});
   case OpCode::LDA_Absolute:
-    return LoadRegister<Register::A, AddressingMode::Absolute>{uint16_t(bytes[2] << 8 | bytes[1])};
+    return visitor(LoadRegister<Register::A, AddressingMode::Absolute>{uint16_t(bytes[2] << 8 | bytes[1])});
   case OpCode::LDX_Absolute:
-    return LoadRegister<Register::X, AddressingMode::Absolute>{uint16_t(bytes[2] << 8 | bytes[1])};
+    return visitor(LoadRegister<Register::X, AddressingMode::Absolute>{uint16_t(bytes[2] << 8 | bytes[1])});
   case OpCode::LDY_Absolute:
-    return LoadRegister<Register::Y, AddressingMode::Absolute>{uint16_t(bytes[2] << 8 | bytes[1])};
+    return visitor(LoadRegister<Register::Y, AddressingMode::Absolute>{uint16_t(bytes[2] << 8 | bytes[1])});
   case OpCode::LDA_AbsoluteX:
-    return LoadRegister<Register::A, AddressingMode::AbsoluteX>{uint16_t(bytes[2] << 8 | bytes[1])};
+    return visitor(LoadRegister<Register::A, AddressingMode::AbsoluteX>{uint16_t(bytes[2] << 8 | bytes[1])});
   case OpCode::LDA_AbsoluteY:
-    return LoadRegister<Register::A, AddressingMode::AbsoluteY>{uint16_t(bytes[2] << 8 | bytes[1])};
+    return visitor(LoadRegister<Register::A, AddressingMode::AbsoluteY>{uint16_t(bytes[2] << 8 | bytes[1])});
   case OpCode::LDX_AbsoluteY:
-    return LoadRegister<Register::X, AddressingMode::AbsoluteY>{uint16_t(bytes[2] << 8 | bytes[1])};
+    return visitor(LoadRegister<Register::X, AddressingMode::AbsoluteY>{uint16_t(bytes[2] << 8 | bytes[1])});
   case OpCode::LDY_AbsoluteX:
-    return LoadRegister<Register::Y, AddressingMode::AbsoluteX>{uint16_t(bytes[2] << 8 | bytes[1])};
+    return visitor(LoadRegister<Register::Y, AddressingMode::AbsoluteX>{uint16_t(bytes[2] << 8 | bytes[1])});
   case OpCode::LDA_IndirectX:
-    return LoadRegister<Register::A, AddressingMode::IndirectX>{bytes[1]};
+    return visitor(LoadRegister<Register::A, AddressingMode::IndirectX>{bytes[1]});
   case OpCode::LDA_IndirectY:
-    return LoadRegister<Register::A, AddressingMode::IndirectY>{bytes[1]};
+    return visitor(LoadRegister<Register::A, AddressingMode::IndirectY>{bytes[1]});
   // Store instructions
   case OpCode::STA_ZeroPage:
-    return StoreRegister<Register::A, AddressingMode::ZeroPage>{bytes[1]};
+    return visitor(StoreRegister<Register::A, AddressingMode::ZeroPage>{bytes[1]});
   case OpCode::STX_ZeroPage:
-    return StoreRegister<Register::X, AddressingMode::ZeroPage>{bytes[1]};
+    return visitor(StoreRegister<Register::X, AddressingMode::ZeroPage>{bytes[1]});
   case OpCode::STY_ZeroPage:
-    return StoreRegister<Register::Y, AddressingMode::ZeroPage>{bytes[1]};
+    return visitor(StoreRegister<Register::Y, AddressingMode::ZeroPage>{bytes[1]});
   case OpCode::STA_ZeroPageX:
-    return StoreRegister<Register::A, AddressingMode::ZeroPageX>{bytes[1]};
+    return visitor(StoreRegister<Register::A, AddressingMode::ZeroPageX>{bytes[1]});
   case OpCode::STX_ZeroPageY:
-    return StoreRegister<Register::X, AddressingMode::ZeroPageY>{bytes[1]};
+    return visitor(StoreRegister<Register::X, AddressingMode::ZeroPageY>{bytes[1]});
   case OpCode::STY_ZeroPageX:
-    return StoreRegister<Register::Y, AddressingMode::ZeroPageX>{bytes[1]};
+    return visitor(StoreRegister<Register::Y, AddressingMode::ZeroPageX>{bytes[1]});
   case OpCode::STA_Absolute:
-    return StoreRegister<Register::A, AddressingMode::Absolute>{uint16_t(bytes[2] << 8 | bytes[1])};
+    return visitor(StoreRegister<Register::A, AddressingMode::Absolute>{uint16_t(bytes[2] << 8 | bytes[1])});
   case OpCode::STX_Absolute:
-    return StoreRegister<Register::X, AddressingMode::Absolute>{uint16_t(bytes[2] << 8 | bytes[1])};
+    return visitor(StoreRegister<Register::X, AddressingMode::Absolute>{uint16_t(bytes[2] << 8 | bytes[1])});
   case OpCode::STY_Absolute:
-    return StoreRegister<Register::Y, AddressingMode::Absolute>{uint16_t(bytes[2] << 8 | bytes[1])};
+    return visitor(StoreRegister<Register::Y, AddressingMode::Absolute>{uint16_t(bytes[2] << 8 | bytes[1])});
   case OpCode::STA_AbsoluteX:
-    return StoreRegister<Register::A, AddressingMode::AbsoluteX>{uint16_t(bytes[2] << 8 | bytes[1])};
+    return visitor(StoreRegister<Register::A, AddressingMode::AbsoluteX>{uint16_t(bytes[2] << 8 | bytes[1])});
   case OpCode::STA_AbsoluteY:
-    return StoreRegister<Register::A, AddressingMode::AbsoluteY>{uint16_t(bytes[2] << 8 | bytes[1])};
+    return visitor(StoreRegister<Register::A, AddressingMode::AbsoluteY>{uint16_t(bytes[2] << 8 | bytes[1])});
   case OpCode::STA_IndirectX:
-    return StoreRegister<Register::A, AddressingMode::IndirectX>{bytes[1]};
+    return visitor(StoreRegister<Register::A, AddressingMode::IndirectX>{bytes[1]});
   case OpCode::STA_IndirectY:
-    return StoreRegister<Register::A, AddressingMode::IndirectY>{bytes[1]};
+    return visitor(StoreRegister<Register::A, AddressingMode::IndirectY>{bytes[1]});
   // Transfer instructions
   case OpCode::TAX:
-    return TransferRegisterTo<Register::A, Register::X>{};
+    return visitor(TransferRegisterTo<Register::A, Register::X>{});
   case OpCode::TAY:
-    return TransferRegisterTo<Register::A, Register::Y>{};
+    return visitor(TransferRegisterTo<Register::A, Register::Y>{});
   case OpCode::TXA:
-    return TransferRegisterTo<Register::X, Register::A>{};
+    return visitor(TransferRegisterTo<Register::X, Register::A>{});
   case OpCode::TYA:
-    return TransferRegisterTo<Register::Y, Register::A>{};
+    return visitor(TransferRegisterTo<Register::Y, Register::A>{});
   case OpCode::TXS:
-    return TransferXToStackPointer{};
+    return visitor(TransferXToStackPointer{});
   case OpCode::TSX:
-    return TransferStackPointerToX{};
+    return visitor(TransferStackPointerToX{});
     // Stack instructions
   case OpCode::PHA:
-    return PushAccumulator{};
+    return visitor(PushAccumulator{});
   case OpCode::PLA:
-    return PullAccumulator{};
+    return visitor(PullAccumulator{});
   case OpCode::PHP:
-    return PushStatusRegister{};
+    return visitor(PushStatusRegister{});
   case OpCode::PLP:
-    return PullStatusRegister{};
+    return visitor(PullStatusRegister{});
     // Math instructions
   case OpCode::ADC_Immediate:
-    return AddWithCarry<AddressingMode::Immediate>{bytes[1]};
+    return visitor(AddWithCarry<AddressingMode::Immediate>{bytes[1]});
   case OpCode::ADC_ZeroPage:
-    return AddWithCarry<AddressingMode::ZeroPage>{bytes[1]};
+    return visitor(AddWithCarry<AddressingMode::ZeroPage>{bytes[1]});
   case OpCode::ADC_ZeroPageX:
-    return AddWithCarry<AddressingMode::ZeroPageX>{bytes[1]};
+    return visitor(AddWithCarry<AddressingMode::ZeroPageX>{bytes[1]});
   case OpCode::ADC_Absolute:
-    return AddWithCarry<AddressingMode::Absolute>{uint16_t(bytes[2] << 8 | bytes[1])};
+    return visitor(AddWithCarry<AddressingMode::Absolute>{uint16_t(bytes[2] << 8 | bytes[1])});
   case OpCode::ADC_AbsoluteX:
-    return AddWithCarry<AddressingMode::AbsoluteX>{uint16_t(bytes[2] << 8 | bytes[1])};
+    return visitor(AddWithCarry<AddressingMode::AbsoluteX>{uint16_t(bytes[2] << 8 | bytes[1])});
   case OpCode::ADC_AbsoluteY:
-    return AddWithCarry<AddressingMode::AbsoluteY>{uint16_t(bytes[2] << 8 | bytes[1])};
+    return visitor(AddWithCarry<AddressingMode::AbsoluteY>{uint16_t(bytes[2] << 8 | bytes[1])});
   case OpCode::ADC_IndirectX:
-    return AddWithCarry<AddressingMode::IndirectX>{bytes[1]};
+    return visitor(AddWithCarry<AddressingMode::IndirectX>{bytes[1]});
   case OpCode::ADC_IndirectY:
-    return AddWithCarry<AddressingMode::IndirectY>{bytes[1]};
+    return visitor(AddWithCarry<AddressingMode::IndirectY>{bytes[1]});
   case OpCode::SBC_Immediate:
-    return SubtractWithCarry<AddressingMode::Immediate>{bytes[1]};
+    return visitor(SubtractWithCarry<AddressingMode::Immediate>{bytes[1]});
   case OpCode::SBC_Immediate_EB:
-    return SubtractWithCarry<AddressingMode::Immediate>{bytes[1], true};
+    return visitor(SubtractWithCarry<AddressingMode::Immediate>{bytes[1], true});
   case OpCode::SBC_ZeroPage:
-    return SubtractWithCarry<AddressingMode::ZeroPage>{bytes[1]};
+    return visitor(SubtractWithCarry<AddressingMode::ZeroPage>{bytes[1]});
   case OpCode::SBC_ZeroPageX:
-    return SubtractWithCarry<AddressingMode::ZeroPageX>{bytes[1]};
+    return visitor(SubtractWithCarry<AddressingMode::ZeroPageX>{bytes[1]});
   case OpCode::SBC_Absolute:
-    return SubtractWithCarry<AddressingMode::Absolute>{uint16_t(bytes[2] << 8 | bytes[1])};
+    return visitor(SubtractWithCarry<AddressingMode::Absolute>{uint16_t(bytes[2] << 8 | bytes[1])});
   case OpCode::SBC_AbsoluteX:
-    return SubtractWithCarry<AddressingMode::AbsoluteX>{uint16_t(bytes[2] << 8 | bytes[1])};
+    return visitor(SubtractWithCarry<AddressingMode::AbsoluteX>{uint16_t(bytes[2] << 8 | bytes[1])});
   case OpCode::SBC_AbsoluteY:
-    return SubtractWithCarry<AddressingMode::AbsoluteY>{uint16_t(bytes[2] << 8 | bytes[1])};
+    return visitor(SubtractWithCarry<AddressingMode::AbsoluteY>{uint16_t(bytes[2] << 8 | bytes[1])});
   case OpCode::SBC_IndirectX:
-    return SubtractWithCarry<AddressingMode::IndirectX>{bytes[1]};
+    return visitor(SubtractWithCarry<AddressingMode::IndirectX>{bytes[1]});
   case OpCode::SBC_IndirectY:
-    return SubtractWithCarry<AddressingMode::IndirectY>{bytes[1]};
+    return visitor(SubtractWithCarry<AddressingMode::IndirectY>{bytes[1]});
   case OpCode::AND_Immediate:
-    return LogicalAND<AddressingMode::Immediate>{bytes[1]};
+    return visitor(LogicalAND<AddressingMode::Immediate>{bytes[1]});
   case OpCode::AND_ZeroPage:
-    return LogicalAND<AddressingMode::ZeroPage>{bytes[1]};
+    return visitor(LogicalAND<AddressingMode::ZeroPage>{bytes[1]});
   case OpCode::AND_ZeroPageX:
-    return LogicalAND<AddressingMode::ZeroPageX>{bytes[1]};
+    return visitor(LogicalAND<AddressingMode::ZeroPageX>{bytes[1]});
   case OpCode::AND_Absolute:
-    return LogicalAND<AddressingMode::Absolute>{uint16_t(bytes[2] << 8 | bytes[1])};
+    return visitor(LogicalAND<AddressingMode::Absolute>{uint16_t(bytes[2] << 8 | bytes[1])});
   case OpCode::AND_AbsoluteX:
-    return LogicalAND<AddressingMode::AbsoluteX>{uint16_t(bytes[2] << 8 | bytes[1])};
+    return visitor(LogicalAND<AddressingMode::AbsoluteX>{uint16_t(bytes[2] << 8 | bytes[1])});
   case OpCode::AND_AbsoluteY:
-    return LogicalAND<AddressingMode::AbsoluteY>{uint16_t(bytes[2] << 8 | bytes[1])};
+    return visitor(LogicalAND<AddressingMode::AbsoluteY>{uint16_t(bytes[2] << 8 | bytes[1])});
   case OpCode::AND_IndirectX:
-    return LogicalAND<AddressingMode::IndirectX>{bytes[1]};
+    return visitor(LogicalAND<AddressingMode::IndirectX>{bytes[1]});
   case OpCode::AND_IndirectY:
-    return LogicalAND<AddressingMode::IndirectY>{bytes[1]};
+    return visitor(LogicalAND<AddressingMode::IndirectY>{bytes[1]});
   case OpCode::ASL_Accumulator:
-    return ShiftLeft<AddressingMode::Accumulator>{0};
+    return visitor(ShiftLeft<AddressingMode::Accumulator>{0});
   case OpCode::ASL_ZeroPage:
-    return ShiftLeft<AddressingMode::ZeroPage>{bytes[1]};
+    return visitor(ShiftLeft<AddressingMode::ZeroPage>{bytes[1]});
   case OpCode::ASL_ZeroPageX:
-    return ShiftLeft<AddressingMode::ZeroPageX>{bytes[1]};
+    return visitor(ShiftLeft<AddressingMode::ZeroPageX>{bytes[1]});
   case OpCode::ASL_Absolute:
-    return ShiftLeft<AddressingMode::Absolute>{uint16_t(bytes[2] << 8 | bytes[1])};
+    return visitor(ShiftLeft<AddressingMode::Absolute>{uint16_t(bytes[2] << 8 | bytes[1])});
   case OpCode::ASL_AbsoluteX:
-    return ShiftLeft<AddressingMode::AbsoluteX>{uint16_t(bytes[2] << 8 | bytes[1])};
+    return visitor(ShiftLeft<AddressingMode::AbsoluteX>{uint16_t(bytes[2] << 8 | bytes[1])});
   case OpCode::LSR_Accumulator:
-    return ShiftRight<AddressingMode::Accumulator>{0};
+    return visitor(ShiftRight<AddressingMode::Accumulator>{0});
   case OpCode::LSR_ZeroPage:
-    return ShiftRight<AddressingMode::ZeroPage>{bytes[1]};
+    return visitor(ShiftRight<AddressingMode::ZeroPage>{bytes[1]});
   case OpCode::LSR_ZeroPageX:
-    return ShiftRight<AddressingMode::ZeroPageX>{bytes[1]};
+    return visitor(ShiftRight<AddressingMode::ZeroPageX>{bytes[1]});
   case OpCode::LSR_Absolute:
-    return ShiftRight<AddressingMode::Absolute>{uint16_t(bytes[2] << 8 | bytes[1])};
+    return visitor(ShiftRight<AddressingMode::Absolute>{uint16_t(bytes[2] << 8 | bytes[1])});
   case OpCode::LSR_AbsoluteX:
-    return ShiftRight<AddressingMode::AbsoluteX>{uint16_t(bytes[2] << 8 | bytes[1])};
+    return visitor(ShiftRight<AddressingMode::AbsoluteX>{uint16_t(bytes[2] << 8 | bytes[1])});
   case OpCode::ROR_Accumulator:
-    return RotateRight<AddressingMode::Accumulator>{0};
+    return visitor(RotateRight<AddressingMode::Accumulator>{0});
   case OpCode::ROR_ZeroPage:
-    return RotateRight<AddressingMode::ZeroPage>{bytes[1]};
+    return visitor(RotateRight<AddressingMode::ZeroPage>{bytes[1]});
   case OpCode::ROR_ZeroPageX:
-    return RotateRight<AddressingMode::ZeroPageX>{bytes[1]};
+    return visitor(RotateRight<AddressingMode::ZeroPageX>{bytes[1]});
   case OpCode::ROR_Absolute:
-    return RotateRight<AddressingMode::Absolute>{uint16_t(bytes[2] << 8 | bytes[1])};
+    return visitor(RotateRight<AddressingMode::Absolute>{uint16_t(bytes[2] << 8 | bytes[1])});
   case OpCode::ROR_AbsoluteX:
-    return RotateRight<AddressingMode::AbsoluteX>{uint16_t(bytes[2] << 8 | bytes[1])};
+    return visitor(RotateRight<AddressingMode::AbsoluteX>{uint16_t(bytes[2] << 8 | bytes[1])});
   case OpCode::ROL_Accumulator:
-    return RotateLeft<AddressingMode::Accumulator>{0};
+    return visitor(RotateLeft<AddressingMode::Accumulator>{0});
   case OpCode::ROL_ZeroPage:
-    return RotateLeft<AddressingMode::ZeroPage>{bytes[1]};
+    return visitor(RotateLeft<AddressingMode::ZeroPage>{bytes[1]});
   case OpCode::ROL_ZeroPageX:
-    return RotateLeft<AddressingMode::ZeroPageX>{bytes[1]};
+    return visitor(RotateLeft<AddressingMode::ZeroPageX>{bytes[1]});
   case OpCode::ROL_Absolute:
-    return RotateLeft<AddressingMode::Absolute>{uint16_t(bytes[2] << 8 | bytes[1])};
+    return visitor(RotateLeft<AddressingMode::Absolute>{uint16_t(bytes[2] << 8 | bytes[1])});
   case OpCode::ROL_AbsoluteX:
-    return RotateLeft<AddressingMode::AbsoluteX>{uint16_t(bytes[2] << 8 | bytes[1])};
+    return visitor(RotateLeft<AddressingMode::AbsoluteX>{uint16_t(bytes[2] << 8 | bytes[1])});
   case OpCode::INC_ZeroPage:
-    return Increment<AddressingMode::ZeroPage>{bytes[1]};
+    return visitor(Increment<AddressingMode::ZeroPage>{bytes[1]});
   case OpCode::INC_ZeroPageX:
-    return Increment<AddressingMode::ZeroPageX>{bytes[1]};
+    return visitor(Increment<AddressingMode::ZeroPageX>{bytes[1]});
   case OpCode::INC_Absolute:
-    return Increment<AddressingMode::Absolute>{uint16_t(bytes[2] << 8 | bytes[1])};
+    return visitor(Increment<AddressingMode::Absolute>{uint16_t(bytes[2] << 8 | bytes[1])});
   case OpCode::INC_AbsoluteX:
-    return Increment<AddressingMode::AbsoluteX>{uint16_t(bytes[2] << 8 | bytes[1])};
+    return visitor(Increment<AddressingMode::AbsoluteX>{uint16_t(bytes[2] << 8 | bytes[1])});
   case OpCode::INX:
-    return IncrementRegister<Register::X>{};
+    return visitor(IncrementRegister<Register::X>{});
   case OpCode::INY:
-    return IncrementRegister<Register::Y>{};
+    return visitor(IncrementRegister<Register::Y>{});
   case OpCode::DEX:
-    return DecrementRegister<Register::X>{};
+    return visitor(DecrementRegister<Register::X>{});
   case OpCode::DEY:
-    return DecrementRegister<Register::Y>{};
+    return visitor(DecrementRegister<Register::Y>{});
   case OpCode::DEC_ZeroPage:
-    return Decrement<AddressingMode::ZeroPage>{bytes[1]};
+    return visitor(Decrement<AddressingMode::ZeroPage>{bytes[1]});
   case OpCode::DEC_ZeroPageX:
-    return Decrement<AddressingMode::ZeroPageX>{bytes[1]};
+    return visitor(Decrement<AddressingMode::ZeroPageX>{bytes[1]});
   case OpCode::DEC_Absolute:
-    return Decrement<AddressingMode::Absolute>{uint16_t(bytes[2] << 8 | bytes[1])};
+    return visitor(Decrement<AddressingMode::Absolute>{uint16_t(bytes[2] << 8 | bytes[1])});
   case OpCode::DEC_AbsoluteX:
-    return Decrement<AddressingMode::AbsoluteX>{uint16_t(bytes[2] << 8 | bytes[1])};
+    return visitor(Decrement<AddressingMode::AbsoluteX>{uint16_t(bytes[2] << 8 | bytes[1])});
   case OpCode::EOR_Immediate:
-    return ExclusiveOR<AddressingMode::Immediate>{bytes[1]};
+    return visitor(ExclusiveOR<AddressingMode::Immediate>{bytes[1]});
   case OpCode ::EOR_ZeroPage:
-    return ExclusiveOR<AddressingMode::ZeroPage>{bytes[1]};
+    return visitor(ExclusiveOR<AddressingMode::ZeroPage>{bytes[1]});
   case OpCode::EOR_ZeroPageX:
-    return ExclusiveOR<AddressingMode::ZeroPageX>{bytes[1]};
+    return visitor(ExclusiveOR<AddressingMode::ZeroPageX>{bytes[1]});
   case OpCode::EOR_Absolute:
-    return ExclusiveOR<AddressingMode::Absolute>{uint16_t(bytes[2] << 8 | bytes[1])};
+    return visitor(ExclusiveOR<AddressingMode::Absolute>{uint16_t(bytes[2] << 8 | bytes[1])});
   case OpCode::EOR_AbsoluteX:
-    return ExclusiveOR<AddressingMode::AbsoluteX>{uint16_t(bytes[2] << 8 | bytes[1])};
+    return visitor(ExclusiveOR<AddressingMode::AbsoluteX>{uint16_t(bytes[2] << 8 | bytes[1])});
   case OpCode::EOR_AbsoluteY:
-    return ExclusiveOR<AddressingMode::AbsoluteY>{uint16_t(bytes[2] << 8 | bytes[1])};
+    return visitor(ExclusiveOR<AddressingMode::AbsoluteY>{uint16_t(bytes[2] << 8 | bytes[1])});
   case OpCode::EOR_IndirectX:
-    return ExclusiveOR<AddressingMode::IndirectX>{bytes[1]};
+    return visitor(ExclusiveOR<AddressingMode::IndirectX>{bytes[1]});
   case OpCode::EOR_IndirectY:
-    return ExclusiveOR<AddressingMode::IndirectY>{bytes[1]};
+    return visitor(ExclusiveOR<AddressingMode::IndirectY>{bytes[1]});
   case OpCode::ORA_Immediate:
-    return BitwiseOR<AddressingMode::Immediate>{bytes[1]};
+    return visitor(BitwiseOR<AddressingMode::Immediate>{bytes[1]});
   case OpCode ::ORA_ZeroPage:
-    return BitwiseOR<AddressingMode::ZeroPage>{bytes[1]};
+    return visitor(BitwiseOR<AddressingMode::ZeroPage>{bytes[1]});
   case OpCode::ORA_ZeroPageX:
-    return BitwiseOR<AddressingMode::ZeroPageX>{bytes[1]};
+    return visitor(BitwiseOR<AddressingMode::ZeroPageX>{bytes[1]});
   case OpCode::ORA_Absolute:
-    return BitwiseOR<AddressingMode::Absolute>{uint16_t(bytes[2] << 8 | bytes[1])};
+    return visitor(BitwiseOR<AddressingMode::Absolute>{uint16_t(bytes[2] << 8 | bytes[1])});
   case OpCode::ORA_AbsoluteX:
-    return BitwiseOR<AddressingMode::AbsoluteX>{uint16_t(bytes[2] << 8 | bytes[1])};
+    return visitor(BitwiseOR<AddressingMode::AbsoluteX>{uint16_t(bytes[2] << 8 | bytes[1])});
   case OpCode::ORA_AbsoluteY:
-    return BitwiseOR<AddressingMode::AbsoluteY>{uint16_t(bytes[2] << 8 | bytes[1])};
+    return visitor(BitwiseOR<AddressingMode::AbsoluteY>{uint16_t(bytes[2] << 8 | bytes[1])});
   case OpCode::ORA_IndirectX:
-    return BitwiseOR<AddressingMode::IndirectX>{bytes[1]};
+    return visitor(BitwiseOR<AddressingMode::IndirectX>{bytes[1]});
   case OpCode::ORA_IndirectY:
-    return BitwiseOR<AddressingMode::IndirectY>{bytes[1]};
+    return visitor(BitwiseOR<AddressingMode::IndirectY>{bytes[1]});
     // Branch instructions
   case OpCode::BEQ:
-    return Branch<Conditional::Equal>{int8_t(bytes[1])};
+    return visitor(Branch<Conditional::Equal>{int8_t(bytes[1])});
   case OpCode::BNE:
-    return Branch<Conditional::NotEqual>{int8_t(bytes[1])};
+    return visitor(Branch<Conditional::NotEqual>{int8_t(bytes[1])});
   case OpCode::BCC:
-    return Branch<Conditional::CarryClear>{int8_t(bytes[1])};
+    return visitor(Branch<Conditional::CarryClear>{int8_t(bytes[1])});
   case OpCode::BCS:
-    return Branch<Conditional::CarrySet>{int8_t(bytes[1])};
+    return visitor(Branch<Conditional::CarrySet>{int8_t(bytes[1])});
   case OpCode::BMI:
-    return Branch<Conditional::Minus>{int8_t(bytes[1])};
+    return visitor(Branch<Conditional::Minus>{int8_t(bytes[1])});
   case OpCode::BPL:
-    return Branch<Conditional::Positive>{int8_t(bytes[1])};
+    return visitor(Branch<Conditional::Positive>{int8_t(bytes[1])});
   case OpCode::BVC:
-    return Branch<Conditional::OverflowClear>{int8_t(bytes[1])};
+    return visitor(Branch<Conditional::OverflowClear>{int8_t(bytes[1])});
   case OpCode::BVS:
-    return Branch<Conditional::OverflowSet>{int8_t(bytes[1])};
+    return visitor(Branch<Conditional::OverflowSet>{int8_t(bytes[1])});
   case OpCode::JMP_Absolute:
-    return Jump<AddressingMode::Absolute>{uint16_t(bytes[2] << 8 | bytes[1])};
+    return visitor(Jump<AddressingMode::Absolute>{uint16_t(bytes[2] << 8 | bytes[1])});
   case OpCode::JMP_Indirect:
-    return Jump<AddressingMode::Indirect>{uint16_t(bytes[2] << 8 | bytes[1])};
+    return visitor(Jump<AddressingMode::Indirect>{uint16_t(bytes[2] << 8 | bytes[1])});
   case OpCode::JSR:
-    return JumpToSubroutine{uint16_t(bytes[2] << 8 | bytes[1])};
+    return visitor(JumpToSubroutine{uint16_t(bytes[2] << 8 | bytes[1])});
   case OpCode::RTS:
-    return ReturnFromSubroutine{};
+    return visitor(ReturnFromSubroutine{});
   case OpCode::RTI:
-    return ReturnFromInterrupt{};
+    return visitor(ReturnFromInterrupt{});
   // ...
   case OpCode::BIT_ZeroPage:
-    return BitTest<AddressingMode::ZeroPage>{bytes[1]};
+    return visitor(BitTest<AddressingMode::ZeroPage>{bytes[1]});
   case OpCode::BIT_Absolute:
-    return BitTest<AddressingMode::Absolute>{uint16_t(bytes[2] << 8 | bytes[1])};
+    return visitor(BitTest<AddressingMode::Absolute>{uint16_t(bytes[2] << 8 | bytes[1])});
   case OpCode::CLC:
-    return ClearStatusFlag<StatusFlag::Carry>{};
+    return visitor(ClearStatusFlag<StatusFlag::Carry>{});
   case OpCode::CLD:
-    return ClearStatusFlag<StatusFlag::DecimalMode>{};
+    return visitor(ClearStatusFlag<StatusFlag::DecimalMode>{});
   case OpCode::CLI:
-    return ClearStatusFlag<StatusFlag::InterruptDisable>{};
+    return visitor(ClearStatusFlag<StatusFlag::InterruptDisable>{});
   case OpCode::CLV:
-    return ClearStatusFlag<StatusFlag::Overflow>{};
+    return visitor(ClearStatusFlag<StatusFlag::Overflow>{});
   case OpCode::CPX_Immediate:
-    return CompareRegister<Register::X, AddressingMode::Immediate>{bytes[1]};
+    return visitor(CompareRegister<Register::X, AddressingMode::Immediate>{bytes[1]});
   case OpCode::CPX_ZeroPage:
-    return CompareRegister<Register::X, AddressingMode::ZeroPage>{bytes[1]};
+    return visitor(CompareRegister<Register::X, AddressingMode::ZeroPage>{bytes[1]});
   case OpCode::CPX_Absolute:
-    return CompareRegister<Register::X, AddressingMode::Absolute>{uint16_t(bytes[2] << 8 | bytes[1])};
+    return visitor(CompareRegister<Register::X, AddressingMode::Absolute>{uint16_t(bytes[2] << 8 | bytes[1])});
   case OpCode::CPY_Immediate:
-    return CompareRegister<Register::Y, AddressingMode::Immediate>{bytes[1]};
+    return visitor(CompareRegister<Register::Y, AddressingMode::Immediate>{bytes[1]});
   case OpCode::CPY_ZeroPage:
-    return CompareRegister<Register::Y, AddressingMode::ZeroPage>{bytes[1]};
+    return visitor(CompareRegister<Register::Y, AddressingMode::ZeroPage>{bytes[1]});
   case OpCode::CPY_Absolute:
-    return CompareRegister<Register::Y, AddressingMode::Absolute>{uint16_t(bytes[2] << 8 | bytes[1])};
+    return visitor(CompareRegister<Register::Y, AddressingMode::Absolute>{uint16_t(bytes[2] << 8 | bytes[1])});
   case OpCode::CMP_Immediate:
-    return CompareRegister<Register::A, AddressingMode::Immediate>{bytes[1]};
+    return visitor(CompareRegister<Register::A, AddressingMode::Immediate>{bytes[1]});
   case OpCode::CMP_ZeroPage:
-    return CompareRegister<Register::A, AddressingMode::ZeroPage>{bytes[1]};
+    return visitor(CompareRegister<Register::A, AddressingMode::ZeroPage>{bytes[1]});
   case OpCode::CMP_ZeroPageX:
-    return CompareRegister<Register::A, AddressingMode::ZeroPageX>{bytes[1]};
+    return visitor(CompareRegister<Register::A, AddressingMode::ZeroPageX>{bytes[1]});
   case OpCode::CMP_Absolute:
-    return CompareRegister<Register::A, AddressingMode::Absolute>{uint16_t(bytes[2] << 8 | bytes[1])};
+    return visitor(CompareRegister<Register::A, AddressingMode::Absolute>{uint16_t(bytes[2] << 8 | bytes[1])});
   case OpCode::CMP_AbsoluteX:
-    return CompareRegister<Register::A, AddressingMode::AbsoluteX>{uint16_t(bytes[2] << 8 | bytes[1])};
+    return visitor(CompareRegister<Register::A, AddressingMode::AbsoluteX>{uint16_t(bytes[2] << 8 | bytes[1])});
   case OpCode::CMP_AbsoluteY:
-    return CompareRegister<Register::A, AddressingMode::AbsoluteY>{uint16_t(bytes[2] << 8 | bytes[1])};
+    return visitor(CompareRegister<Register::A, AddressingMode::AbsoluteY>{uint16_t(bytes[2] << 8 | bytes[1])});
   case OpCode::CMP_IndirectX:
-    return CompareRegister<Register::A, AddressingMode::IndirectX>{bytes[1]};
+    return visitor(CompareRegister<Register::A, AddressingMode::IndirectX>{bytes[1]});
   case OpCode::CMP_IndirectY:
-    return CompareRegister<Register::A, AddressingMode::IndirectY>{bytes[1]};
+    return visitor(CompareRegister<Register::A, AddressingMode::IndirectY>{bytes[1]});
   case OpCode::SEC:
-    return SetStatusFlag<StatusFlag::Carry>{};
+    return visitor(SetStatusFlag<StatusFlag::Carry>{});
   case OpCode::SED:
-    return SetStatusFlag<StatusFlag::DecimalMode>{};
+    return visitor(SetStatusFlag<StatusFlag::DecimalMode>{});
   case OpCode::SEI:
-    return SetStatusFlag<StatusFlag::InterruptDisable>{};
+    return visitor(SetStatusFlag<StatusFlag::InterruptDisable>{});
   case OpCode::NOP:
-    return NoOperation{};
+    return visitor(NoOperation{});
   case OpCode::NOP_1A:
   case OpCode::NOP_3A:
   case OpCode::NOP_5A:
   case OpCode::NOP_7A:
   case OpCode::NOP_DA:
   case OpCode::NOP_FA:
-    return NoOperation{true};
+    return visitor(NoOperation{true});
   case OpCode::DOP_Immediate_80:
   case OpCode::DOP_Immediate_82:
   case OpCode::DOP_Immediate_89:
   case OpCode::DOP_Immediate_C2:
   case OpCode::DOP_Immediate_E2:
-    return DoubleNoOperation<AddressingMode::Immediate>{bytes[1]};
+    return visitor(DoubleNoOperation<AddressingMode::Immediate>{bytes[1]});
   case OpCode::DOP_ZeroPage_04:
   case OpCode::DOP_ZeroPage_44:
   case OpCode::DOP_ZeroPage_64:
-    return DoubleNoOperation<AddressingMode::ZeroPage>{bytes[1]};
+    return visitor(DoubleNoOperation<AddressingMode::ZeroPage>{bytes[1]});
   case OpCode::DOP_ZeroPageX_14:
   case OpCode::DOP_ZeroPageX_34:
   case OpCode::DOP_ZeroPageX_54:
   case OpCode::DOP_ZeroPageX_74:
   case OpCode::DOP_ZeroPageX_D4:
   case OpCode::DOP_ZeroPageX_F4:
-    return DoubleNoOperation<AddressingMode::ZeroPageX>{bytes[1]};
+    return visitor(DoubleNoOperation<AddressingMode::ZeroPageX>{bytes[1]});
   case OpCode::TOP_Absolute:
-    return TripleNoOperation<AddressingMode::Absolute>{uint16_t(bytes[2] << 8 | bytes[1])};
+    return visitor(TripleNoOperation<AddressingMode::Absolute>{uint16_t(bytes[2] << 8 | bytes[1])});
   case OpCode::TOP_AbsoluteX_1C:
   case OpCode::TOP_AbsoluteX_3C:
   case OpCode::TOP_AbsoluteX_5C:
   case OpCode::TOP_AbsoluteX_7C:
   case OpCode::TOP_AbsoluteX_DC:
   case OpCode::TOP_AbsoluteX_FC:
-    return TripleNoOperation<AddressingMode::AbsoluteX>{uint16_t(bytes[2] << 8 | bytes[1])};
+    return visitor(TripleNoOperation<AddressingMode::AbsoluteX>{uint16_t(bytes[2] << 8 | bytes[1])});
   case OpCode::LAX_ZeroPage:
-    return LoadAccumulatorAndX<AddressingMode::ZeroPage>{bytes[1]};
+    return visitor(LoadAccumulatorAndX<AddressingMode::ZeroPage>{bytes[1]});
   case OpCode::LAX_ZeroPageY:
-    return LoadAccumulatorAndX<AddressingMode::ZeroPageY>{bytes[1]};
+    return visitor(LoadAccumulatorAndX<AddressingMode::ZeroPageY>{bytes[1]});
   case OpCode::LAX_Absolute:
-    return LoadAccumulatorAndX<AddressingMode::Absolute>{uint16_t(bytes[2] << 8 | bytes[1])};
+    return visitor(LoadAccumulatorAndX<AddressingMode::Absolute>{uint16_t(bytes[2] << 8 | bytes[1])});
   case OpCode::LAX_AbsoluteY:
-    return LoadAccumulatorAndX<AddressingMode::AbsoluteY>{uint16_t(bytes[2] << 8 | bytes[1])};
+    return visitor(LoadAccumulatorAndX<AddressingMode::AbsoluteY>{uint16_t(bytes[2] << 8 | bytes[1])});
   case OpCode::LAX_IndirectX:
-    return LoadAccumulatorAndX<AddressingMode::IndirectX>{bytes[1]};
+    return visitor(LoadAccumulatorAndX<AddressingMode::IndirectX>{bytes[1]});
   case OpCode::LAX_IndirectY:
-    return LoadAccumulatorAndX<AddressingMode::IndirectY>{bytes[1]};
+    return visitor(LoadAccumulatorAndX<AddressingMode::IndirectY>{bytes[1]});
   case OpCode::SAX_ZeroPage:
-    return StoreAccumulatorAndX<AddressingMode::ZeroPage>{bytes[1]};
+    return visitor(StoreAccumulatorAndX<AddressingMode::ZeroPage>{bytes[1]});
   case OpCode::SAX_ZeroPageY:
-    return StoreAccumulatorAndX<AddressingMode::ZeroPageY>{bytes[1]};
+    return visitor(StoreAccumulatorAndX<AddressingMode::ZeroPageY>{bytes[1]});
   case OpCode::SAX_IndirectX:
-    return StoreAccumulatorAndX<AddressingMode::IndirectX>{bytes[1]};
+    return visitor(StoreAccumulatorAndX<AddressingMode::IndirectX>{bytes[1]});
   case OpCode::SAX_Absolute:
-    return StoreAccumulatorAndX<AddressingMode::Absolute>{uint16_t(bytes[2] << 8 | bytes[1])};
+    return visitor(StoreAccumulatorAndX<AddressingMode::Absolute>{uint16_t(bytes[2] << 8 | bytes[1])});
   case OpCode::DCP_ZeroPage:
-    return DecrementAndCompare<AddressingMode::ZeroPage>{bytes[1]};
+    return visitor(DecrementAndCompare<AddressingMode::ZeroPage>{bytes[1]});
   case OpCode::DCP_ZeroPageX:
-    return DecrementAndCompare<AddressingMode::ZeroPageX>{bytes[1]};
+    return visitor(DecrementAndCompare<AddressingMode::ZeroPageX>{bytes[1]});
   case OpCode::DCP_Absolute:
-    return DecrementAndCompare<AddressingMode::Absolute>{uint16_t(bytes[2] << 8 | bytes[1])};
+    return visitor(DecrementAndCompare<AddressingMode::Absolute>{uint16_t(bytes[2] << 8 | bytes[1])});
   case OpCode::DCP_AbsoluteX:
-    return DecrementAndCompare<AddressingMode::AbsoluteX>{uint16_t(bytes[2] << 8 | bytes[1])};
+    return visitor(DecrementAndCompare<AddressingMode::AbsoluteX>{uint16_t(bytes[2] << 8 | bytes[1])});
   case OpCode::DCP_AbsoluteY:
-    return DecrementAndCompare<AddressingMode::AbsoluteY>{uint16_t(bytes[2] << 8 | bytes[1])};
+    return visitor(DecrementAndCompare<AddressingMode::AbsoluteY>{uint16_t(bytes[2] << 8 | bytes[1])});
   case OpCode::DCP_IndirectX:
-    return DecrementAndCompare<AddressingMode::IndirectX>{bytes[1]};
+    return visitor(DecrementAndCompare<AddressingMode::IndirectX>{bytes[1]});
   case OpCode::DCP_IndirectY:
-    return DecrementAndCompare<AddressingMode::IndirectY>{bytes[1]};
+    return visitor(DecrementAndCompare<AddressingMode::IndirectY>{bytes[1]});
   case OpCode::ISB_ZeroPage:
-    return IncrementAndSubtract<AddressingMode::ZeroPage>{bytes[1]};
+    return visitor(IncrementAndSubtract<AddressingMode::ZeroPage>{bytes[1]});
   case OpCode::ISB_ZeroPageX:
-    return IncrementAndSubtract<AddressingMode::ZeroPageX>{bytes[1]};
+    return visitor(IncrementAndSubtract<AddressingMode::ZeroPageX>{bytes[1]});
   case OpCode::ISB_Absolute:
-    return IncrementAndSubtract<AddressingMode::Absolute>{uint16_t(bytes[2] << 8 | bytes[1])};
+    return visitor(IncrementAndSubtract<AddressingMode::Absolute>{uint16_t(bytes[2] << 8 | bytes[1])});
   case OpCode::ISB_AbsoluteX:
-    return IncrementAndSubtract<AddressingMode::AbsoluteX>{uint16_t(bytes[2] << 8 | bytes[1])};
+    return visitor(IncrementAndSubtract<AddressingMode::AbsoluteX>{uint16_t(bytes[2] << 8 | bytes[1])});
   case OpCode::ISB_AbsoluteY:
-    return IncrementAndSubtract<AddressingMode::AbsoluteY>{uint16_t(bytes[2] << 8 | bytes[1])};
+    return visitor(IncrementAndSubtract<AddressingMode::AbsoluteY>{uint16_t(bytes[2] << 8 | bytes[1])});
   case OpCode::ISB_IndirectX:
-    return IncrementAndSubtract<AddressingMode::IndirectX>{bytes[1]};
+    return visitor(IncrementAndSubtract<AddressingMode::IndirectX>{bytes[1]});
   case OpCode::ISB_IndirectY:
-    return IncrementAndSubtract<AddressingMode::IndirectY>{bytes[1]};
+    return visitor(IncrementAndSubtract<AddressingMode::IndirectY>{bytes[1]});
   case OpCode::SLO_ZeroPage:
-    return ShiftLeftAndOR<AddressingMode::ZeroPage>{bytes[1]};
+    return visitor(ShiftLeftAndOR<AddressingMode::ZeroPage>{bytes[1]});
   case OpCode::SLO_ZeroPageX:
-    return ShiftLeftAndOR<AddressingMode::ZeroPageX>{bytes[1]};
+    return visitor(ShiftLeftAndOR<AddressingMode::ZeroPageX>{bytes[1]});
   case OpCode::SLO_Absolute:
-    return ShiftLeftAndOR<AddressingMode::Absolute>{uint16_t(bytes[2] << 8 | bytes[1])};
+    return visitor(ShiftLeftAndOR<AddressingMode::Absolute>{uint16_t(bytes[2] << 8 | bytes[1])});
   case OpCode::SLO_AbsoluteX:
-    return ShiftLeftAndOR<AddressingMode::AbsoluteX>{uint16_t(bytes[2] << 8 | bytes[1])};
+    return visitor(ShiftLeftAndOR<AddressingMode::AbsoluteX>{uint16_t(bytes[2] << 8 | bytes[1])});
   case OpCode::SLO_AbsoluteY:
-    return ShiftLeftAndOR<AddressingMode::AbsoluteY>{uint16_t(bytes[2] << 8 | bytes[1])};
+    return visitor(ShiftLeftAndOR<AddressingMode::AbsoluteY>{uint16_t(bytes[2] << 8 | bytes[1])});
   case OpCode::SLO_IndirectX:
-    return ShiftLeftAndOR<AddressingMode::IndirectX>{bytes[1]};
+    return visitor(ShiftLeftAndOR<AddressingMode::IndirectX>{bytes[1]});
   case OpCode::SLO_IndirectY:
-    return ShiftLeftAndOR<AddressingMode::IndirectY>{bytes[1]};
+    return visitor(ShiftLeftAndOR<AddressingMode::IndirectY>{bytes[1]});
   case OpCode::RLA_ZeroPage:
-    return RotateLeftAndAND<AddressingMode::ZeroPage>{bytes[1]};
+    return visitor(RotateLeftAndAND<AddressingMode::ZeroPage>{bytes[1]});
   case OpCode::RLA_ZeroPageX:
-    return RotateLeftAndAND<AddressingMode::ZeroPageX>{bytes[1]};
+    return visitor(RotateLeftAndAND<AddressingMode::ZeroPageX>{bytes[1]});
   case OpCode::RLA_Absolute:
-    return RotateLeftAndAND<AddressingMode::Absolute>{uint16_t(bytes[2] << 8 | bytes[1])};
+    return visitor(RotateLeftAndAND<AddressingMode::Absolute>{uint16_t(bytes[2] << 8 | bytes[1])});
   case OpCode::RLA_AbsoluteX:
-    return RotateLeftAndAND<AddressingMode::AbsoluteX>{uint16_t(bytes[2] << 8 | bytes[1])};
+    return visitor(RotateLeftAndAND<AddressingMode::AbsoluteX>{uint16_t(bytes[2] << 8 | bytes[1])});
   case OpCode::RLA_AbsoluteY:
-    return RotateLeftAndAND<AddressingMode::AbsoluteY>{uint16_t(bytes[2] << 8 | bytes[1])};
+    return visitor(RotateLeftAndAND<AddressingMode::AbsoluteY>{uint16_t(bytes[2] << 8 | bytes[1])});
   case OpCode::RLA_IndirectX:
-    return RotateLeftAndAND<AddressingMode::IndirectX>{bytes[1]};
+    return visitor(RotateLeftAndAND<AddressingMode::IndirectX>{bytes[1]});
   case OpCode::RLA_IndirectY:
-    return RotateLeftAndAND<AddressingMode::IndirectY>{bytes[1]};
+    return visitor(RotateLeftAndAND<AddressingMode::IndirectY>{bytes[1]});
   case OpCode::SRE_ZeroPage:
-    return ShiftRightAndEOR<AddressingMode::ZeroPage>{bytes[1]};
+    return visitor(ShiftRightAndEOR<AddressingMode::ZeroPage>{bytes[1]});
   case OpCode::SRE_ZeroPageX:
-    return ShiftRightAndEOR<AddressingMode::ZeroPageX>{bytes[1]};
+    return visitor(ShiftRightAndEOR<AddressingMode::ZeroPageX>{bytes[1]});
   case OpCode::SRE_Absolute:
-    return ShiftRightAndEOR<AddressingMode::Absolute>{uint16_t(bytes[2] << 8 | bytes[1])};
+    return visitor(ShiftRightAndEOR<AddressingMode::Absolute>{uint16_t(bytes[2] << 8 | bytes[1])});
   case OpCode::SRE_AbsoluteX:
-    return ShiftRightAndEOR<AddressingMode::AbsoluteX>{uint16_t(bytes[2] << 8 | bytes[1])};
+    return visitor(ShiftRightAndEOR<AddressingMode::AbsoluteX>{uint16_t(bytes[2] << 8 | bytes[1])});
   case OpCode::SRE_AbsoluteY:
-    return ShiftRightAndEOR<AddressingMode::AbsoluteY>{uint16_t(bytes[2] << 8 | bytes[1])};
+    return visitor(ShiftRightAndEOR<AddressingMode::AbsoluteY>{uint16_t(bytes[2] << 8 | bytes[1])});
   case OpCode::SRE_IndirectX:
-    return ShiftRightAndEOR<AddressingMode::IndirectX>{bytes[1]};
+    return visitor(ShiftRightAndEOR<AddressingMode::IndirectX>{bytes[1]});
   case OpCode::SRE_IndirectY:
-    return ShiftRightAndEOR<AddressingMode::IndirectY>{bytes[1]};
+    return visitor(ShiftRightAndEOR<AddressingMode::IndirectY>{bytes[1]});
   case OpCode::RRA_ZeroPage:
-    return RotateRightAndAdd<AddressingMode::ZeroPage>{bytes[1]};
+    return visitor(RotateRightAndAdd<AddressingMode::ZeroPage>{bytes[1]});
   case OpCode::RRA_ZeroPageX:
-    return RotateRightAndAdd<AddressingMode::ZeroPageX>{bytes[1]};
+    return visitor(RotateRightAndAdd<AddressingMode::ZeroPageX>{bytes[1]});
   case OpCode::RRA_Absolute:
-    return RotateRightAndAdd<AddressingMode::Absolute>{uint16_t(bytes[2] << 8 | bytes[1])};
+    return visitor(RotateRightAndAdd<AddressingMode::Absolute>{uint16_t(bytes[2] << 8 | bytes[1])});
   case OpCode::RRA_AbsoluteX:
-    return RotateRightAndAdd<AddressingMode::AbsoluteX>{uint16_t(bytes[2] << 8 | bytes[1])};
+    return visitor(RotateRightAndAdd<AddressingMode::AbsoluteX>{uint16_t(bytes[2] << 8 | bytes[1])});
   case OpCode::RRA_AbsoluteY:
-    return RotateRightAndAdd<AddressingMode::AbsoluteY>{uint16_t(bytes[2] << 8 | bytes[1])};
+    return visitor(RotateRightAndAdd<AddressingMode::AbsoluteY>{uint16_t(bytes[2] << 8 | bytes[1])});
   case OpCode::RRA_IndirectX:
-    return RotateRightAndAdd<AddressingMode::IndirectX>{bytes[1]};
+    return visitor(RotateRightAndAdd<AddressingMode::IndirectX>{bytes[1]});
   case OpCode::RRA_IndirectY:
-    return RotateRightAndAdd<AddressingMode::IndirectY>{bytes[1]};
+    return visitor(RotateRightAndAdd<AddressingMode::IndirectY>{bytes[1]});
   default:
     s_logger->error("Unknown opcode: 0x{:02X}", bytes[0]);
     TODO(std::format("Implement decoding for opcode: 0x{:02X}", bytes[0]));
@@ -471,37 +475,580 @@ CPU::Instruction CPU::DecodeInstruction(std::span<const uint8_t> bytes) const {
   std::unreachable();
 }
 
-CPU::Instruction CPU::DecodeNextInstruction() const {
-  std::array<uint8_t, 3> bytes;
-  std::ranges::generate(bytes, [this, i = 0]() mutable { return ReadFromMemory(ProgramCounter() + i++); });
+CPU::Instruction CPU::DecodeInstruction(std::span<const uint8_t> bytes) const {
+  return VisitOpCode(bytes, [](auto &&instruction) -> Instruction { return instruction; });
+}
+
+std::array<uint8_t, 3> CPU::FetchInstructionBytes() const {
+  return m_bus->FetchInstruction(m_program_counter);
+}
+
+CPU::Instruction CPU::DecodeNextInstruction() const { return DecodeInstruction(FetchInstructionBytes()); }
+
+const CPU::CachedInstruction &CPU::FetchCachedInstruction() {
+  if (const auto *entry = m_instruction_cache.Find(m_program_counter)) {
+    return *entry;
+  }
+
+  const auto bytes = FetchInstructionBytes();
+  return m_instruction_cache.Insert(m_program_counter, {
+                                                           .bytes = bytes,
+                                                           .handler = s_opcode_handlers[bytes[0]],
+                                                           .instruction = DecodeInstruction(bytes),
+                                                       });
+}
+
+void CPU::SetEngine(ExecutionEngine engine) {
+  m_execution_engine = engine;
 
-  return DecodeInstruction(bytes);
+  if (engine != ExecutionEngine::Dynarec || m_dynarec) {
+    return;
+  }
+
+#ifdef BNES_DYNAREC
+  if constexpr (Dynarec::IsSupported()) {
+    m_dynarec = std::make_unique<Dynarec>(*this, *m_bus);
+  } else {
+    s_logger->warn("The dynarec is not supported on this platform, running the block engine instead");
+  }
+#else
+  s_logger->warn("BNES was built without the dynarec (BNES_DYNAREC), running the block engine instead");
+#endif
+}
+
+void CPU::FlushDecodedCode() {
+  m_instruction_cache.Flush();
+  m_block_cache.Flush();
+  if (m_dynarec) {
+    m_dynarec->Flush();
+  }
+}
+
+void CPU::SetPairProfilingEnabled(bool enabled) {
+  if (!enabled) {
+    m_pair_profile.reset();
+  } else if (!m_pair_profile) {
+    m_pair_profile = std::make_unique<OpCodePairProfile>();
+  }
+}
+
+void CPU::SetInstructionCacheEnabled(bool enabled) {
+  m_instruction_cache_enabled = enabled;
+  m_instruction_cache.Flush();
+}
+
+template <typename INSTR> unsigned int CPU::Execute(INSTR &instruction) {
+  // Run the instruction on the CPU
+  instruction.Apply(*this);
+
+  if constexpr (!(std::is_same_v<INSTR, Break> || std::is_same_v<INSTR, JumpToSubroutine> ||
+                  std::is_same_v<INSTR, ReturnFromSubroutine> || std::is_same_v<INSTR, ReturnFromInterrupt> ||
+                  std::is_same_v<INSTR, Jump<AddressingMode::Absolute>> ||
+                  std::is_same_v<INSTR, Jump<AddressingMode::Indirect>>)) {
+    // Advance the program counter by the size of the instruction
+    // We avoid this for jump instructions, since they directly modify the program counter
+    m_program_counter += instruction.size;
+  }
+
+  return instruction.cycles;
 }
 
 void CPU::RunInstruction(Instruction &&instr) {
   m_current_instruction = instr;
   std::visit<void>(
       [this](auto &instruction) {
-        // Run the instruction on the CPU
-        instruction.Apply(*this);
-
-        if constexpr (!(std::is_same_v<std::decay_t<decltype(instruction)>, Break> ||
-                        std::is_same_v<std::decay_t<decltype(instruction)>, JumpToSubroutine> ||
-                        std::is_same_v<std::decay_t<decltype(instruction)>, ReturnFromSubroutine> ||
-                        std::is_same_v<std::decay_t<decltype(instruction)>, ReturnFromInterrupt> ||
-                        std::is_same_v<std::decay_t<decltype(instruction)>, Jump<AddressingMode::Absolute>> ||
-                        std::is_same_v<std::decay_t<decltype(instruction)>, Jump<AddressingMode::Indirect>>)) {
-          // Advance the program counter by the size of the instruction
-          // We avoid this for jump instructions, since they directly modify the program counter
-          m_program_counter += instruction.size;
-        }
-
-        m_cycles += instruction.cycles;
-        m_bus->Tick(instruction.cycles);
+        const auto cycles = Execute(instruction);
+        m_cycles += cycles;
+        m_bus->Tick(cycles);
       },
       instr);
 }
 
+template <uint8_t OPCODE> unsigned int CPU::ExecuteOpCode(CPU &cpu, uint8_t low_byte, uint8_t high_byte) {
+  // The opcode is a compile-time constant here, so the decoder switch folds down to the single matching case and
+  // we end up calling the instruction template directly, without going through the variant.
+  const std::array<uint8_t, 3> bytes{OPCODE, low_byte, high_byte};
+  return VisitOpCode(bytes, [&cpu](auto &&instruction) { return cpu.Execute(instruction); });
+}
+
+constexpr std::array<CPU::OpCodeHandler, 256> CPU::s_opcode_handlers =
+    []<size_t... OPCODES>(std::index_sequence<OPCODES...>) {
+      return std::array<OpCodeHandler, 256>{&ExecuteOpCode<OPCODES>...};
+    }(std::make_index_sequence<256>{});
+
+namespace {
+template <typename INSTR> struct IsBranch : std::false_type {};
+template <Conditional COND> struct IsBranch<CPU::Branch<COND>> : std::true_type {};
+template <typename INSTR> struct IsJump : std::false_type {};
+template <AddressingMode MODE> struct IsJump<CPU::Jump<MODE>> : std::true_type {};
+
+// Anything that moves the program counter somewhere other than the next instruction ends a block
+template <typename INSTR> constexpr bool EndsBlock() {
+  return IsBranch<INSTR>::value || IsJump<INSTR>::value || std::is_same_v<INSTR, CPU::JumpToSubroutine> ||
+         std::is_same_v<INSTR, CPU::ReturnFromSubroutine> || std::is_same_v<INSTR, CPU::ReturnFromInterrupt> ||
+         std::is_same_v<INSTR, CPU::Break>;
+}
+
+// Whether the instruction might access memory outside of RAM and PRG ROM, i.e. something that has to see the other
+// devices in the exact state they would be in when running one instruction at a time.
+template <typename INSTR> constexpr bool NeedsBusSync(const INSTR &instruction) {
+  if constexpr (requires { INSTR::AddrMode(); }) {
+    uint16_t operand{0};
+    if constexpr (requires { instruction.value; }) {
+      operand = instruction.value;
+    } else {
+      operand = instruction.address;
+    }
+
+    auto in_ram_or_rom = [](unsigned int first, unsigned int last) { return last < 0x2000 || first >= 0x8000; };
+
+    switch (INSTR::AddrMode()) {
+    case AddressingMode::Absolute:
+      return !in_ram_or_rom(operand, operand);
+    case AddressingMode::AbsoluteX:
+    case AddressingMode::AbsoluteY:
+      return !in_ram_or_rom(operand, operand + 0xFF);
+    case AddressingMode::Indirect:
+    case AddressingMode::IndirectX:
+    case AddressingMode::IndirectY:
+      // no way to know the target address in advance
+      return true;
+    default:
+      return false;
+    }
+  }
+
+  return false;
+}
+
+template <template <AddressingMode> typename TEMPLATE, typename INSTR> struct IsInstanceOf : std::false_type {};
+template <template <AddressingMode> typename TEMPLATE, AddressingMode MODE>
+struct IsInstanceOf<TEMPLATE, TEMPLATE<MODE>> : std::true_type {};
+template <typename INSTR> struct IsStoreRegister : std::false_type {};
+template <CPU::Register REG, AddressingMode MODE>
+struct IsStoreRegister<CPU::StoreRegister<REG, MODE>> : std::true_type {};
+
+// Stores and read-modify-write instructions (which only write to memory when not in Accumulator mode)
+template <typename INSTR> constexpr bool WritesMemory() {
+  return IsStoreRegister<INSTR>::value || IsInstanceOf<CPU::StoreAccumulatorAndX, INSTR>::value ||
+         IsInstanceOf<CPU::Increment, INSTR>::value || IsInstanceOf<CPU::Decrement, INSTR>::value ||
+         IsInstanceOf<CPU::ShiftLeft, INSTR>::value || IsInstanceOf<CPU::ShiftRight, INSTR>::value ||
+         IsInstanceOf<CPU::RotateLeft, INSTR>::value || IsInstanceOf<CPU::RotateRight, INSTR>::value ||
+         IsInstanceOf<CPU::DecrementAndCompare, INSTR>::value || IsInstanceOf<CPU::IncrementAndSubtract, INSTR>::value ||
+         IsInstanceOf<CPU::ShiftLeftAndOR, INSTR>::value || IsInstanceOf<CPU::RotateLeftAndAND, INSTR>::value ||
+         IsInstanceOf<CPU::ShiftRightAndEOR, INSTR>::value || IsInstanceOf<CPU::RotateRightAndAdd, INSTR>::value;
+}
+
+// Whether running the instruction again gives the same result, as long as the CPU registers and the PPU status don't
+// change in between. That is, it writes nothing and only reads RAM, ROM or PPUSTATUS.
+template <typename INSTR> constexpr bool IsSideEffectFree(const INSTR &instruction) {
+  if constexpr (std::is_same_v<INSTR, CPU::PushAccumulator> || std::is_same_v<INSTR, CPU::PushStatusRegister>) {
+    return false;
+  } else if constexpr (requires { INSTR::AddrMode(); }) {
+    if constexpr (WritesMemory<INSTR>()) {
+      return INSTR::AddrMode() == AddressingMode::Accumulator;
+    }
+
+    // Reading PPUSTATUS clears the vblank flag and the write toggle, reading it again right after changes nothing
+    if constexpr (INSTR::AddrMode() == AddressingMode::Absolute) {
+      if constexpr (requires { instruction.value; }) {
+        if (instruction.value == 0x2002) {
+          return true;
+        }
+      } else if (instruction.address == 0x2002) {
+        return true;
+      }
+    }
+
+    return !NeedsBusSync(instruction);
+  }
+
+  return true;
+}
+
+// Where the instruction ending a block goes, if it always goes to the same place
+template <typename INSTR> constexpr std::optional<uint16_t> StaticTarget(const INSTR &instruction, uint16_t address) {
+  if constexpr (IsBranch<INSTR>::value) {
+    return address + instruction.size + instruction.offset;
+  } else if constexpr (std::is_same_v<INSTR, CPU::Jump<AddressingMode::Absolute>>) {
+    return instruction.address;
+  }
+
+  return std::nullopt;
+}
+} // namespace
+
+CPU::Block CPU::TranslateBlock(Addr start) const {
+  Block block{.start = start, .end = start, .instructions = {}};
+  block.native_eligible = start >= Bus::ROM_START_REGISTER;
+
+  Addr address = start;
+  bool ends_block = false;
+  bool side_effect_free = true;
+  std::optional<uint16_t> target;
+  while (!ends_block) {
+    const std::array<uint8_t, 3> bytes = m_bus->FetchInstruction(address);
+
+    BlockInstruction block_instruction{
+        .handler = s_opcode_handlers[bytes[0]],
+        .opcode = bytes[0],
+        .low_byte = bytes[1],
+        .high_byte = bytes[2],
+        .size = 0,
+        .sync = false,
+        .fused = nullptr,
+    };
+    std::visit(
+        [&, address](const auto &instruction) {
+          block_instruction.size = instruction.size;
+          block_instruction.sync = NeedsBusSync(instruction);
+          ends_block = EndsBlock<std::decay_t<decltype(instruction)>>();
+          side_effect_free &= IsSideEffectFree(instruction);
+          target = StaticTarget(instruction, address);
+        },
+        DecodeInstruction(bytes));
+
+    block.instructions.push_back(block_instruction);
+    address += block_instruction.size;
+
+    ends_block = ends_block || block.instructions.size() >= MaxBlockLength ||
+                 !decltype(m_block_cache)::CanExtend(start, address);
+  }
+
+  block.end = address;
+  block.idle_loop = side_effect_free && target == start;
+  FuseInstructions(block);
+  return block;
+}
+
+template <OpCode FIRST, OpCode SECOND>
+unsigned int CPU::ExecuteFusedPair(CPU &cpu, const BlockInstruction &first, const BlockInstruction &second) {
+  // Both opcodes are known at compile time, so the two handlers get inlined here
+  return ExecuteOpCode<static_cast<uint8_t>(FIRST)>(cpu, first.low_byte, first.high_byte) +
+         ExecuteOpCode<static_cast<uint8_t>(SECOND)>(cpu, second.low_byte, second.high_byte);
+}
+
+CPU::FusedHandler CPU::FindFusedHandler(uint8_t first, uint8_t second) {
+  using enum OpCode;
+
+  // The idioms games spend most of their time in. Run with pair profiling enabled to find more.
+  static constexpr std::array fused_pairs{
+      // Loop counters
+      FusedPair{DEX, BNE, &ExecuteFusedPair<DEX, BNE>},
+      FusedPair{DEY, BNE, &ExecuteFusedPair<DEY, BNE>},
+      FusedPair{INX, BNE, &ExecuteFusedPair<INX, BNE>},
+      FusedPair{INY, BNE, &ExecuteFusedPair<INY, BNE>},
+      FusedPair{INC_ZeroPage, BNE, &ExecuteFusedPair<INC_ZeroPage, BNE>},
+      FusedPair{DEC_ZeroPage, BNE, &ExecuteFusedPair<DEC_ZeroPage, BNE>},
+      // Compare and branch
+      FusedPair{CMP_Immediate, BNE, &ExecuteFusedPair<CMP_Immediate, BNE>},
+      FusedPair{CMP_Immediate, BEQ, &ExecuteFusedPair<CMP_Immediate, BEQ>},
+      FusedPair{CMP_ZeroPage, BNE, &ExecuteFusedPair<CMP_ZeroPage, BNE>},
+      // Moves
+      FusedPair{LDA_Immediate, STA_ZeroPage, &ExecuteFusedPair<LDA_Immediate, STA_ZeroPage>},
+      FusedPair{LDA_Immediate, STA_Absolute, &ExecuteFusedPair<LDA_Immediate, STA_Absolute>},
+      FusedPair{LDA_ZeroPage, STA_ZeroPage, &ExecuteFusedPair<LDA_ZeroPage, STA_ZeroPage>},
+      FusedPair{LDA_ZeroPage, STA_Absolute, &ExecuteFusedPair<LDA_ZeroPage, STA_Absolute>},
+      FusedPair{LDA_Absolute, STA_Absolute, &ExecuteFusedPair<LDA_Absolute, STA_Absolute>},
+      // Copy loops
+      FusedPair{LDA_AbsoluteX, STA_AbsoluteX, &ExecuteFusedPair<LDA_AbsoluteX, STA_AbsoluteX>},
+      FusedPair{LDA_AbsoluteX, STA_AbsoluteY, &ExecuteFusedPair<LDA_AbsoluteX, STA_AbsoluteY>},
+      FusedPair{LDA_AbsoluteY, STA_AbsoluteY, &ExecuteFusedPair<LDA_AbsoluteY, STA_AbsoluteY>},
+  };
+
+  const auto it = std::ranges::find_if(fused_pairs, [first, second](const FusedPair &pair) {
+    return static_cast<uint8_t>(pair.first) == first && static_cast<uint8_t>(pair.second) == second;
+  });
+  return it == fused_pairs.end() ? nullptr : it->handler;
+}
+
+void CPU::FuseInstructions(Block &block) {
+  // The first instruction of a pair could write to zero page (e.g. INC) and modify the second one, which we'd only
+  // notice after running both. Blocks are never fused there.
+  if (block.start < 0x2000 && (block.start & 0x7FF) < 0x100) {
+    return;
+  }
+
+  auto &instructions = block.instructions;
+  for (size_t i = 0; i + 1 < instructions.size(); ++i) {
+    auto &first = instructions[i];
+    const auto &second = instructions[i + 1];
+    if (first.sync || second.sync) {
+      continue;
+    }
+
+    if (first.fused = FindFusedHandler(first.opcode, second.opcode); first.fused) {
+      ++i;
+    }
+  }
+}
+
+CPU::Block *CPU::CompileBlock(Block &block) {
+  auto to_native_instructions = [](const Block &block) {
+    std::vector<Dynarec::Instruction> instructions;
+    Addr address = block.start;
+    for (const auto &instruction : block.instructions) {
+      instructions.push_back({
+          .address = address,
+          .bytes = {instruction.opcode, instruction.low_byte, instruction.high_byte},
+      });
+      address += instruction.size;
+    }
+    return instructions;
+  };
+
+  auto native = m_dynarec->Compile(to_native_instructions(block));
+  if (native) {
+    block.native = *native;
+    return &block;
+  }
+
+  if (native.error().Code() != std::errc::not_enough_memory) {
+    // Most of the time just an instruction the dynarec leaves to the interpreter
+    s_logger->debug("Block at 0x{:04X} stays interpreted: {}", block.start, native.error().Message());
+    block.native_eligible = false;
+    return &block;
+  }
+
+  // The arena is full: drop all the native code, together with every block pointing into it, and start over
+  s_logger->debug("Dynarec arena full, flushing");
+  const auto start = block.start;
+  m_dynarec->Flush();
+  m_block_cache.Flush();
+
+  Block *new_block = &m_block_cache.Insert(TranslateBlock(start));
+  if (native = m_dynarec->Compile(to_native_instructions(*new_block)); native) {
+    new_block->native = *native;
+  } else {
+    new_block->native_eligible = false;
+  }
+
+  return new_block;
+}
+
+void CPU::BeginBlock() {
+  m_pending_cycles = 0;
+  m_cycle_budget = m_bus->CyclesUntilNextEvent();
+  m_block_generation = m_block_cache.Generation();
+}
+
+void CPU::FlushPendingCycles() {
+  if (m_pending_cycles > 0) {
+    m_bus->Tick(m_pending_cycles);
+    m_pending_cycles = 0;
+  }
+}
+
+bool CPU::FinishBlockInstruction(unsigned int cycles, Addr next_address, bool sync) {
+  m_cycles += cycles;
+  m_pending_cycles += cycles;
+
+  if (sync || m_pending_cycles >= m_cycle_budget) {
+    FlushPendingCycles();
+    m_cycle_budget = m_bus->CyclesUntilNextEvent();
+  }
+
+  // Stop here if we just overwrote the block itself, if something moved the program counter or if an interrupt has to
+  // be serviced before the next instruction
+  return m_block_cache.Generation() == m_block_generation && m_program_counter == next_address &&
+         !InterruptRequested();
+}
+
+void CPU::RunBlock() {
+  Block *block = m_block_cache.Find(m_program_counter);
+  if (!block) {
+    block = &m_block_cache.Insert(TranslateBlock(m_program_counter));
+  }
+  m_block_cache.CountExecution();
+
+  if (m_dynarec && m_execution_engine == ExecutionEngine::Dynarec && block->native_eligible && !block->native &&
+      ++block->executions >= DynarecHotThreshold) {
+    block = CompileBlock(*block);
+  }
+
+  // The block might be gone once it has run (e.g. if it modified itself)
+  const Addr start = block->start;
+  const bool idle_loop = block->idle_loop;
+  const auto state_before = CurrentLoopState();
+  const auto cycles_before = m_cycles;
+
+  // Cycles are charged to the CPU right away, but the bus (i.e. the PPU) is only ticked once we reach an instruction
+  // that could observe it or once the PPU is about to do something the CPU could notice (e.g. raising an NMI).
+  // Until then, ticking once or after each instruction gives exactly the same result.
+  BeginBlock();
+  const size_t cycles_until_event = m_cycle_budget;
+
+  if (block->native && m_execution_engine == ExecutionEngine::Dynarec) {
+    const auto &last = block->instructions.back();
+    m_fetched_bytes = {last.opcode, last.low_byte, last.high_byte};
+
+    block->native(*this, *m_bus);
+    FlushPendingCycles();
+  } else {
+    RunBlockInstructions(*block);
+  }
+
+  const auto iteration_cycles = m_cycles - cycles_before;
+  const bool unchanged = state_before == CurrentLoopState();
+  if (idle_loop && unchanged && m_program_counter == start && iteration_cycles < cycles_until_event &&
+      !InterruptRequested()) {
+    FastForwardIdleLoop(start, iteration_cycles);
+  } else {
+    m_idle_loop_iterations = 0;
+  }
+}
+
+void CPU::FastForwardIdleLoop(Addr start, size_t iteration_cycles) {
+  if (m_idle_loop_start != start) {
+    m_idle_loop_start = start;
+    m_idle_loop_iterations = 0;
+  }
+
+  // Only iterations that didn't change anything and during which the PPU did nothing count. The first one might still
+  // have changed the PPU status (reading PPUSTATUS clears the vblank flag), from the second one on every iteration
+  // is exactly the same until the next PPU event.
+  if (++m_idle_loop_iterations < 2) {
+    return;
+  }
+
+  // Skip as many whole iterations as we can without reaching the next PPU event
+  const size_t budget = m_bus->CyclesUntilNextEvent();
+  if (iteration_cycles == 0 || budget <= iteration_cycles) {
+    return;
+  }
+
+  const auto iterations = (budget - 1) / iteration_cycles;
+  const auto cycles = iterations * iteration_cycles;
+  m_cycles += cycles;
+  m_bus->Tick(cycles);
+
+  ++m_idle_loop_stats.fast_forwards;
+  m_idle_loop_stats.skipped_cycles += cycles;
+}
+
+void CPU::WatchIdleLoop(Addr jump_address) {
+  const Addr start = m_program_counter;
+  const auto state = CurrentLoopState();
+
+  // Same as in RunBlock, the loop has to go around once without changing anything and without reaching a PPU event.
+  // Then the block starting where the jump lands tells whether the loop can have side effects. The block has to end
+  // with this very jump, otherwise the iteration went through code outside of it.
+  const auto &last = m_loop_iteration;
+  const bool unchanged = last.start == start && last.state == state &&
+                         m_cycles - last.cycles < last.cycles_until_event && !InterruptRequested();
+  const Block *block = nullptr;
+  if (unchanged && decltype(m_block_cache)::IsCacheable(start)) {
+    block = m_block_cache.Find(start);
+    if (!block) {
+      block = &m_block_cache.Insert(TranslateBlock(start));
+    }
+  }
+
+  if (block && block->idle_loop && block->end - block->instructions.back().size == jump_address) {
+    FastForwardIdleLoop(start, m_cycles - last.cycles);
+  } else {
+    m_idle_loop_iterations = 0;
+  }
+
+  m_loop_iteration = {
+      .start = start, .cycles = m_cycles, .cycles_until_event = m_bus->CyclesUntilNextEvent(), .state = state};
+}
+
+void CPU::RunBlockInstructions(const Block &block) {
+  const auto n_instructions = block.instructions.size();
+  for (size_t i = 0; i < n_instructions; ++i) {
+    const auto instruction = block.instructions[i];
+    if (instruction.sync) {
+      FlushPendingCycles();
+    }
+
+    // A fused pair can't tick the bus in between the two instructions, so only take the shortcut when the first one
+    // can't possibly reach the next bus event.
+    if (instruction.fused && m_pending_cycles + MaxInstructionCycles < m_cycle_budget) {
+      const auto second = block.instructions[++i];
+      const Addr next_address = m_program_counter + instruction.size + second.size;
+      m_fetched_bytes = {second.opcode, second.low_byte, second.high_byte};
+
+      const auto cycles = instruction.fused(*this, instruction, second);
+      if (!FinishBlockInstruction(cycles, next_address, false)) {
+        break;
+      }
+      continue;
+    }
+
+    const Addr next_address = m_program_counter + instruction.size;
+    m_fetched_bytes = {instruction.opcode, instruction.low_byte, instruction.high_byte};
+
+    const auto cycles = instruction.handler(*this, instruction.low_byte, instruction.high_byte);
+    if (!FinishBlockInstruction(cycles, next_address, instruction.sync)) {
+      break;
+    }
+  }
+
+  FlushPendingCycles();
+}
+
+void CPU::Step() {
+  if (m_pending_interrupts) [[unlikely]] {
+    ServiceInterrupts();
+  }
+
+  const bool use_cache = m_instruction_cache_enabled && decltype(m_instruction_cache)::IsCacheable(m_program_counter);
+  const Addr address = m_program_counter;
+
+  switch (m_pair_profile ? ExecutionEngine::Table : m_execution_engine) {
+  case ExecutionEngine::Dynarec:
+  case ExecutionEngine::Block:
+    if (decltype(m_block_cache)::IsCacheable(m_program_counter)) {
+      RunBlock();
+      break;
+    }
+    // Code running from anywhere else goes through the table
+    [[fallthrough]];
+  case ExecutionEngine::Table: {
+    OpCodeHandler handler{nullptr};
+    if (use_cache) {
+      const auto &entry = FetchCachedInstruction();
+      m_fetched_bytes = entry.bytes;
+      handler = entry.handler;
+    } else {
+      m_fetched_bytes = FetchInstructionBytes();
+      handler = s_opcode_handlers[m_fetched_bytes[0]];
+    }
+
+    if (m_pair_profile) {
+      m_pair_profile->Record(m_fetched_bytes[0]);
+    }
+
+    const auto cycles = handler(*this, m_fetched_bytes[1], m_fetched_bytes[2]);
+    m_cycles += cycles;
+    m_bus->Tick(cycles);
+    break;
+  }
+  case ExecutionEngine::Variant:
+    // NOTE: we run a copy of the cached instruction, executing it can modify it (e.g. branches adding cycles)
+    RunInstruction(use_cache ? Instruction{FetchCachedInstruction().instruction} : DecodeNextInstruction());
+    break;
+  }
+
+  // The block engines find idle loops as it runs whole blocks, the others check every jump backwards. Loops never go
+  // around while profiling, every instruction has to be seen.
+  if (m_program_counter <= address && !m_pair_profile &&
+      ((m_execution_engine != ExecutionEngine::Block && m_execution_engine != ExecutionEngine::Dynarec) ||
+       !decltype(m_block_cache)::IsCacheable(address))) {
+    WatchIdleLoop(address);
+  }
+}
+
+CPU::Instruction CPU::CurrentInstruction() const {
+  if (m_execution_engine == ExecutionEngine::Variant) {
+    return m_current_instruction;
+  }
+
+  // The table engine never materializes the variant, so decode the last fetched bytes on demand.
+  return DecodeInstruction(m_fetched_bytes);
+}
+
 // Helper function to format operands in proper 6502 assembly notation
 namespace {
 template <AddressingMode MODE> std::string FormatOperand(uint16_t value) {
@@ -707,39 +1254,56 @@ std::string CPU::DisassembleInstruction(const Instruction &instr) const {
                     instr);
 }
 
-void CPU::ProcessNMI() {
-  // Upon receiving a NMI the CPU:
-  // - Finishes execution of the current instruction (we can ignore this)
+void CPU::ServiceInterrupts() {
+  // NMI wins if both are pending, and leaves interrupts disabled so the IRQ has to wait for the handler to return
+  if (m_pending_interrupts & static_cast<uint8_t>(Interrupt::NMI)) {
+    ClearInterrupt(Interrupt::NMI);
+    ProcessNMI();
+  } else if (InterruptRequested()) {
+    ProcessIRQ();
+  }
+}
+
+void CPU::EnterInterruptHandler(Addr vector_address) {
+  // Upon receiving an interrupt the CPU:
+  // - Finishes execution of the current instruction (we only service interrupts between instructions)
   // - Stores Program Counter and Status flag on the stack
   // - Disables Interrupts by setting Disable Interrupt flag in the status register P
-  // - Loads the Address of Interrupt handler routine from 0xFFFA (for NMI)
+  // - Loads the Address of Interrupt handler routine from the interrupt vector
   // - Sets Program Counter register pointing to that address
 
-  WriteToMemory(StackBaseAddress + m_stack_pointer, (m_program_counter >> 8) & 0xFF); // Push high byte
-  m_stack_pointer--;
-  WriteToMemory(StackBaseAddress + m_stack_pointer, m_program_counter & 0xFF); // Push low byte
-  m_stack_pointer--;
-
-  WriteToMemory(StackBaseAddress + m_stack_pointer, m_status.to_ulong());
-  m_stack_pointer--;
+  PushToStack((m_program_counter >> 8) & 0xFF); // Push high byte
+  PushToStack(m_program_counter & 0xFF);        // Push low byte
+  PushToStack(StatusWord());
 
   SetStatusFlagValue(StatusFlag::InterruptDisable, true);
 
-  m_cycles += 2;
+  if (m_pair_profile) {
+    m_pair_profile->Break();
+  }
 
-  uint8_t low_byte = ReadFromMemory(0xFFFA);
-  uint8_t hi_byte = ReadFromMemory(0xFFFB);
+  uint8_t low_byte = ReadFromMemory(vector_address);
+  uint8_t hi_byte = ReadFromMemory(vector_address + 1);
   m_program_counter = (hi_byte << 8) | low_byte;
 }
 
-uint8_t CPU::ReadFromMemory(Addr addr) const { return m_bus->Read(addr); }
+void CPU::ProcessNMI() {
+  EnterInterruptHandler(NMIHandlerAddressPointer);
+
+  m_cycles += 7;
+  m_bus->Tick(7);
+}
 
-void CPU::WriteToMemory(Addr addr, uint8_t value) { return m_bus->Write(addr, value); }
+void CPU::ProcessIRQ() {
+  EnterInterruptHandler(IRQHandlerAddressPointer);
+
+  m_cycles += 7;
+  m_bus->Tick(7);
+}
 
 void CPU::SetRegister(Register reg, uint8_t value) {
   m_registers[reg] = value;
-  SetStatusFlagValue(StatusFlag::Zero, value == 0);
-  SetStatusFlagValue(StatusFlag::Negative, value & 0x80);
+  SetZeroAndNegative(value);
 }
 
 } // namespace BNES::HW
@@ -1,26 +1,40 @@
 #ifndef BNES_HW_CPU_H
 #define BNES_HW_CPU_H
 
+#include "HW/BlockCache.h"
 #include "HW/Bus.h"
+#include "HW/Dynarec.h"
+#include "HW/InstructionCache.h"
+#include "HW/OpCodePairProfile.h"
 #include "HW/OpCodes.h"
 #include "common/Types/EnumArray.h"
 #include "common/Types/non_owning_ptr.h"
 
 #include <spdlog/sinks/stdout_color_sinks.h>
 
+#include <array>
 #include <bitset>
 #include <cstdint>
+#include <memory>
 #include <span>
+#include <tuple>
 #include <variant>
+#include <vector>
 
 namespace BNES::Tools {
 class CPUDebugger;
 }
 
 namespace BNES::HW {
+struct IdleLoopStats {
+  size_t fast_forwards{0};
+  size_t skipped_cycles{0};
+};
+
 class CPU {
   friend class ::BNES::Tools::CPUDebugger;
   friend class Bus;
+  friend class Dynarec;
 
 public:
   using Addr = Bus::Addr;
@@ -36,16 +50,92 @@ public:
     Negative
   };
 
+  // Selects how instructions are dispatched:
+  // - Variant: decode into a CPU::Instruction and std::visit it (the reference implementation)
+  // - Table: dispatch through a 256-entry handler table, one handler per opcode, skipping the variant altogether
+  // - Block: translate basic blocks into lists of table handlers once, then run them in a tight loop, only syncing
+  //          the PPU when needed (see RunBlock)
+  // - Dynarec: like Block, but hot blocks from PRG ROM are translated to native code (x86-64 only, opt-in with the
+  //            BNES_DYNAREC build option, otherwise it behaves exactly like Block). See Dynarec.
+  // All of them fast-forward idle loops, see FastForwardIdleLoop.
+  enum class ExecutionEngine : uint8_t { Variant = 0, Table, Block, Dynarec };
+
+#ifdef BNES_TABLE_DISPATCH
+  static constexpr ExecutionEngine DefaultExecutionEngine{ExecutionEngine::Table};
+#else
+  static constexpr ExecutionEngine DefaultExecutionEngine{ExecutionEngine::Variant};
+#endif
+
   CPU() = delete;
-  explicit CPU(Bus &bus) : m_bus{&bus} { m_bus->Attach(this); }
+  explicit CPU(Bus &bus) : m_bus{&bus} {
+    m_bus->Attach(this);
+    m_instruction_cache.TrackCodePages(bus.DecodedCodePages(), 0b01);
+    m_block_cache.TrackCodePages(bus.DecodedCodePages(), 0b10);
+  }
 
   // Helper functions to inspect the state of the CPU
   [[nodiscard]] EnumArray<uint8_t, Register> Registers() const { return m_registers; };
   [[nodiscard]] uint8_t StackPointer() const { return m_stack_pointer; }
   [[nodiscard]] Addr ProgramCounter() const { return m_program_counter; }
-  [[nodiscard]] std::bitset<8> StatusFlags() const { return m_status; }
-  [[nodiscard]] bool TestStatusFlag(StatusFlag flag) const { return m_status.test(static_cast<size_t>(flag)); }
+  [[nodiscard]] std::bitset<8> StatusFlags() const { return StatusWord(); }
+  [[nodiscard]] bool TestStatusFlag(StatusFlag flag) const {
+    switch (flag) {
+    case StatusFlag::Carry:
+      return m_carry;
+    case StatusFlag::Zero:
+      return m_zero_result == 0;
+    case StatusFlag::Overflow:
+      return m_overflow;
+    case StatusFlag::Negative:
+      return m_negative_result & 0x80;
+    default:
+      return m_flags & (1 << static_cast<uint8_t>(flag));
+    }
+  }
   [[nodiscard]] size_t Cycles() const { return m_cycles; }
+  [[nodiscard]] ExecutionEngine Engine() const { return m_execution_engine; }
+
+  void SetEngine(ExecutionEngine engine);
+
+  // Decoded instructions are cached by address, see InstructionCache
+  [[nodiscard]] bool InstructionCacheEnabled() const { return m_instruction_cache_enabled; }
+  [[nodiscard]] const InstructionCacheStats &GetInstructionCacheStats() const { return m_instruction_cache.GetStats(); }
+  void SetInstructionCacheEnabled(bool enabled);
+
+  // The bus lets us know when memory that might contain code changes
+  void InvalidateDecodedCode(Addr address) {
+    m_instruction_cache.Invalidate(address);
+    m_block_cache.Invalidate(address);
+  }
+  // Same, for whole pages whose memory was swapped out (e.g. by a bank switch)
+  void InvalidateDecodedPages(Addr first, Addr last) {
+    m_instruction_cache.InvalidatePages(first, last);
+    m_block_cache.InvalidatePages(first, last);
+  }
+  void FlushDecodedCode();
+
+  [[nodiscard]] const BlockCacheStats &GetBlockCacheStats() const { return m_block_cache.GetStats(); }
+  [[nodiscard]] DynarecStats GetDynarecStats() const { return m_dynarec ? m_dynarec->GetStats() : DynarecStats{}; }
+  [[nodiscard]] const IdleLoopStats &GetIdleLoopStats() const { return m_idle_loop_stats; }
+
+  // Counts which opcodes follow each other, to find new candidates for fusion (see FindFusedHandler).
+  // While profiling every engine runs one instruction at a time through the table, so that no pair is missed.
+  void SetPairProfilingEnabled(bool enabled);
+  [[nodiscard]] const OpCodePairProfile *GetPairProfile() const { return m_pair_profile.get(); }
+
+  // Fetch, decode and run the next instruction using the selected execution engine
+  void Step();
+
+  // Interrupt requests are only latched here, and serviced at the start of the next Step() (i.e. between instructions).
+  // NMI is edge-triggered: once raised it's serviced exactly once. IRQ is level-triggered: it stays pending until
+  // whoever raised it clears it, and it's only serviced while the InterruptDisable flag is clear.
+  enum class Interrupt : uint8_t { NMI = 1 << 0, IRQ = 1 << 1 };
+
+  void RaiseInterrupt(Interrupt interrupt) { m_pending_interrupts |= static_cast<uint8_t>(interrupt); }
+  void ClearInterrupt(Interrupt interrupt) { m_pending_interrupts &= ~static_cast<uint8_t>(interrupt); }
+  [[nodiscard]] bool InterruptPending(Interrupt interrupt) const {
+    return m_pending_interrupts & static_cast<uint8_t>(interrupt);
+  }
 
   void Init() {
     m_program_counter =
@@ -57,26 +147,113 @@ private:
   static constexpr Addr StackBaseAddress{0x0100}; // Base address for the stack
   static constexpr Addr ProgramBaseAddress{0x8000};
   static constexpr Addr ProgramStartAddressPointer{0xFFFC};
+  static constexpr Addr NMIHandlerAddressPointer{0xFFFA};
+  static constexpr Addr IRQHandlerAddressPointer{0xFFFE};
 
   EnumArray<uint8_t, Register> m_registers{}; // Array to hold CPU registers A, X, and Y
-  std::bitset<8> m_status{0x24};              // Status register (flags)
+  // The status register is kept unpacked. N and Z are never computed by the instructions: we keep the byte each one
+  // derives from (the result of the last instruction, almost always) and only test it when someone reads the flag,
+  // i.e. branches, PHP, BRK and interrupts. See StatusWord() for the packed P register.
+  uint8_t m_flags{0x24};        // I, D, B and the unused bit, in their P register positions
+  bool m_carry{false};          // C
+  bool m_overflow{false};       // V
+  uint8_t m_negative_result{0}; // N is bit 7 of this
+  uint8_t m_zero_result{1};     // Z is set if this is 0
+
   uint8_t m_stack_pointer{0xFD};              // Stack pointer initialized to 0xFF
   Addr m_program_counter{ProgramBaseAddress}; // Program counter
   size_t m_cycles{0};                         // Cycle counter
+  uint8_t m_pending_interrupts{0};            // Bitmask of CPU::Interrupt
   non_owning_ptr<Bus *> m_bus;                // Memory bus
 
+  ExecutionEngine m_execution_engine{DefaultExecutionEngine};
+  std::array<uint8_t, 3> m_fetched_bytes{}; // Last instruction fetched by the table engine
+
   static std::shared_ptr<spdlog::logger> s_logger;
 
+  [[nodiscard]] uint8_t StatusWord() const {
+    return m_flags | (m_carry ? 0x01 : 0) | (m_zero_result == 0 ? 0x02 : 0) | (m_overflow ? 0x40 : 0) |
+           (m_negative_result & 0x80);
+  }
+  void SetStatusWord(uint8_t value) {
+    m_flags = value & 0b00111100;
+    m_carry = value & 0x01;
+    m_zero_result = (value & 0x02) ? 0 : 1;
+    m_overflow = value & 0x40;
+    m_negative_result = value & 0x80;
+  }
+
+  // N and Z of the given result, computed lazily
+  void SetZeroAndNegative(uint8_t result) {
+    m_zero_result = result;
+    m_negative_result = result;
+  }
+
+  // Whether servicing interrupts right now would do anything
+  [[nodiscard]] bool InterruptRequested() const {
+    return (m_pending_interrupts & static_cast<uint8_t>(Interrupt::NMI)) ||
+           ((m_pending_interrupts & static_cast<uint8_t>(Interrupt::IRQ)) &&
+            !TestStatusFlag(StatusFlag::InterruptDisable));
+  }
+  void EnterInterruptHandler(Addr vector_address);
+
 protected:
+  void ServiceInterrupts();
   void ProcessNMI();
+  void ProcessIRQ();
+
+  [[nodiscard]] uint8_t ReadFromMemory(Addr addr) const { return m_bus->Read(addr); }
+  void WriteToMemory(Addr addr, uint8_t value) { m_bus->Write(addr, value); }
+
+  // Zero page and stack accesses never leave their page ($00xx and $01xx respectively)
+  [[nodiscard]] uint8_t ReadZeroPage(Addr addr) const { return m_bus->ReadPage<0x00>(addr & 0xFF); }
+  void WriteZeroPage(Addr addr, uint8_t value) { m_bus->WritePage<0x00>(addr & 0xFF, value); }
+  void PushToStack(uint8_t value) { m_bus->WritePage<(StackBaseAddress >> 8)>(m_stack_pointer--, value); }
+  [[nodiscard]] uint8_t PullFromStack() { return m_bus->ReadPage<(StackBaseAddress >> 8)>(++m_stack_pointer); }
+
+  // Memory operand of an instruction, with the zero page modes taking the shortcut above
+  template <AddressingMode MODE> [[nodiscard]] uint8_t ReadOperand(Addr addr) const {
+    if constexpr (MODE == AddressingMode::ZeroPage || MODE == AddressingMode::ZeroPageX ||
+                  MODE == AddressingMode::ZeroPageY) {
+      return ReadZeroPage(addr);
+    } else {
+      return ReadFromMemory(addr);
+    }
+  }
 
-  [[nodiscard]] uint8_t ReadFromMemory(Addr addr) const;
-  void WriteToMemory(Addr addr, uint8_t value);
+  template <AddressingMode MODE> void WriteOperand(Addr addr, uint8_t value) {
+    if constexpr (MODE == AddressingMode::ZeroPage || MODE == AddressingMode::ZeroPageX ||
+                  MODE == AddressingMode::ZeroPageY) {
+      WriteZeroPage(addr, value);
+    } else {
+      WriteToMemory(addr, value);
+    }
+  }
 
   // Mostly used for unit testing purposes
   void SetRegister(Register reg, uint8_t value);
-  void SetStatusFlagValue(StatusFlag flag, bool value) { m_status.set(static_cast<size_t>(flag), value); }
-  void ToggleStatusFlag(StatusFlag flag) { m_status.flip(static_cast<size_t>(flag)); }
+  void SetStatusFlagValue(StatusFlag flag, bool value) {
+    switch (flag) {
+    case StatusFlag::Carry:
+      m_carry = value;
+      break;
+    case StatusFlag::Zero:
+      m_zero_result = value ? 0 : 1;
+      break;
+    case StatusFlag::Overflow:
+      m_overflow = value;
+      break;
+    case StatusFlag::Negative:
+      m_negative_result = value ? 0x80 : 0;
+      break;
+    default: {
+      const auto mask = static_cast<uint8_t>(1 << static_cast<uint8_t>(flag));
+      m_flags = value ? (m_flags | mask) : (m_flags & ~mask);
+      break;
+    }
+    }
+  }
+  void ToggleStatusFlag(StatusFlag flag) { SetStatusFlagValue(flag, !TestStatusFlag(flag)); }
 
   void SetProgramStartAddress(Addr addr) { m_program_counter = addr; }
 
@@ -674,7 +851,111 @@ public:
   [[nodiscard]] Instruction DecodeNextInstruction() const;
   void RunInstruction(Instruction &&instr);
   [[nodiscard]] std::string DisassembleInstruction(const Instruction &instr) const;
-  [[nodiscard]] Instruction CurrentInstruction() const { return m_current_instruction; }
+  [[nodiscard]] Instruction CurrentInstruction() const;
+
+private:
+  // Handlers run a single opcode (given its two operand bytes) and return the number of cycles it took
+  using OpCodeHandler = unsigned int (*)(CPU &, uint8_t, uint8_t);
+
+  static const std::array<OpCodeHandler, 256> s_opcode_handlers;
+
+  struct CachedInstruction {
+    std::array<uint8_t, 3> bytes;
+    OpCodeHandler handler;
+    Instruction instruction;
+  };
+
+  bool m_instruction_cache_enabled{true};
+  InstructionCache<CachedInstruction> m_instruction_cache;
+
+  [[nodiscard]] std::array<uint8_t, 3> FetchInstructionBytes() const;
+  [[nodiscard]] const CachedInstruction &FetchCachedInstruction();
+
+  struct BlockInstruction;
+
+  // Runs two consecutive instructions in a single dispatch (a "superinstruction")
+  using FusedHandler = unsigned int (*)(CPU &, const BlockInstruction &, const BlockInstruction &);
+
+  struct BlockInstruction {
+    OpCodeHandler handler;
+    uint8_t opcode;
+    uint8_t low_byte;
+    uint8_t high_byte;
+    uint8_t size;
+    bool sync; // might touch something other than RAM or PRG ROM, the bus has to be up to date when it runs
+    FusedHandler fused; // set if this instruction and the next one can run together
+  };
+
+  struct FusedPair {
+    OpCode first;
+    OpCode second;
+    FusedHandler handler;
+  };
+
+  // A straight-line run of instructions, ending at the first branch, jump, subroutine call/return or BRK
+  struct Block {
+    Addr start{0};
+    Addr end{0}; // one past the last byte
+    std::vector<BlockInstruction> instructions;
+
+    // Only blocks from PRG ROM are translated, as long as the dynarec knows all of their instructions
+    bool native_eligible{false};
+    unsigned int executions{0};
+    Dynarec::NativeBlock native{nullptr};
+
+    // Loops back to itself without side effects, e.g. polling PPUSTATUS while waiting for vblank
+    bool idle_loop{false};
+  };
+
+  static constexpr size_t MaxBlockLength{32};
+  static constexpr unsigned int MaxInstructionCycles{7};
+  static constexpr unsigned int DynarecHotThreshold{8}; // how many times a block runs before being translated
+
+  BlockCache<Block> m_block_cache;
+  std::unique_ptr<Dynarec> m_dynarec;
+
+  // State of the block being run, shared by the block interpreter and the native code
+  unsigned int m_pending_cycles{0};
+  unsigned int m_cycle_budget{0};
+  size_t m_block_generation{0};
+
+  std::unique_ptr<OpCodePairProfile> m_pair_profile;
+
+  // Idle loops are fast-forwarded up to the next PPU event, see FastForwardIdleLoop
+  Addr m_idle_loop_start{0};
+  unsigned int m_idle_loop_iterations{0};
+  IdleLoopStats m_idle_loop_stats{};
+
+  // What the CPU looked like the last time a jump went backwards, for the engines that run one instruction at a time
+  // (see WatchIdleLoop)
+  using LoopState = std::tuple<EnumArray<uint8_t, Register>, uint8_t, uint8_t>;
+  struct LoopIteration {
+    Addr start{0};
+    size_t cycles{0};
+    size_t cycles_until_event{0};
+    LoopState state{};
+  };
+  LoopIteration m_loop_iteration{};
+  [[nodiscard]] LoopState CurrentLoopState() const { return {m_registers, StatusWord(), m_stack_pointer}; }
+
+  [[nodiscard]] Block TranslateBlock(Addr start) const;
+  static void FuseInstructions(Block &block);
+  [[nodiscard]] static FusedHandler FindFusedHandler(uint8_t first, uint8_t second);
+  Block *CompileBlock(Block &block);
+  void RunBlock();
+  void RunBlockInstructions(const Block &block);
+  void FastForwardIdleLoop(Addr start, size_t iteration_cycles);
+  void WatchIdleLoop(Addr jump_address);
+
+  void BeginBlock();
+  void FlushPendingCycles();
+  bool FinishBlockInstruction(unsigned int cycles, Addr next_address, bool sync);
+
+  template <typename Visitor> static decltype(auto) VisitOpCode(std::span<const uint8_t> bytes, Visitor &&visitor);
+  template <uint8_t OPCODE> static unsigned int ExecuteOpCode(CPU &cpu, uint8_t low_byte, uint8_t high_byte);
+  template <OpCode FIRST, OpCode SECOND>
+  static unsigned int ExecuteFusedPair(CPU &cpu, const BlockInstruction &first, const BlockInstruction &second);
+  template <typename INSTR> unsigned int Execute(INSTR &instruction);
 };
 } // namespace BNES::HW
 
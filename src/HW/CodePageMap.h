@@ -0,0 +1,50 @@
+//
+// Created by Valerio Formato on 17-Oct-26.
+//
+
+#ifndef BNES_CODEPAGEMAP_H
+#define BNES_CODEPAGEMAP_H
+
+#include <array>
+#include <cstdint>
+
+namespace BNES::HW {
+
+// Tells which 256-byte pages of the CPU address space hold bytes of decoded code. Every cache of decoded code owns one
+// bit and keeps it up to date, so that a write only has to call into the CPU when it lands on one of those pages.
+// Internal RAM pages are marked on all of their mirrors, since the code can be written through any of them.
+class CodePageMap {
+public:
+  using Addr = std::uint16_t;
+
+  [[nodiscard]] bool HoldsCode(Addr address) const { return m_pages[address >> 8] != 0; }
+
+  void Mark(uint8_t owner, Addr address) {
+    ForEachMirror(address, [this, owner](unsigned int page) { m_pages[page] |= owner; });
+  }
+  void Unmark(uint8_t owner, Addr address) {
+    ForEachMirror(address, [this, owner](unsigned int page) { m_pages[page] &= ~owner; });
+  }
+  void UnmarkAll(uint8_t owner) {
+    for (auto &page : m_pages) {
+      page &= ~owner;
+    }
+  }
+
+private:
+  template <typename F> static void ForEachMirror(Addr address, F &&f) {
+    if (address >= 0x2000) {
+      f(address >> 8);
+      return;
+    }
+
+    for (unsigned int mirror = address & 0x7FF; mirror < 0x2000; mirror += 0x800) {
+      f(mirror >> 8);
+    }
+  }
+
+  std::array<uint8_t, 256> m_pages{};
+};
+} // namespace BNES::HW
+
+#endif // BNES_CODEPAGEMAP_H
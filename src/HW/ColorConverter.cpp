@@ -0,0 +1,161 @@
+//
+// Created by Valerio Formato on 17-Oct-26.
+//
+
+#include "HW/ColorConverter.h"
+#include "HW/CpuFeatures.h"
+
+#if BNES_CPUFEATURES_X86
+#include <immintrin.h>
+#endif
+
+namespace BNES::HW {
+
+namespace {
+void ConvertScalar(const uint8_t *color_indices, size_t size, const ColorConverter::Palette &palette,
+                   uint32_t *pixels) {
+  for (size_t i = 0; i < size; ++i) {
+    pixels[i] = palette[color_indices[i] & 0x3F];
+  }
+}
+
+#if BNES_CPUFEATURES_X86
+// tables[byte][quarter] holds byte `byte` of the 16 palette entries starting at quarter * 16
+using ByteTables = std::array<std::array<std::array<uint8_t, 16>, 4>, 4>;
+
+ByteTables SplitPalette(const ColorConverter::Palette &palette) {
+  ByteTables tables{};
+  for (size_t color = 0; color < ColorConverter::N_COLORS; ++color) {
+    for (size_t byte = 0; byte < 4; ++byte) {
+      tables[byte][color / 16][color % 16] = static_cast<uint8_t>(palette[color] >> (8 * byte));
+    }
+  }
+  return tables;
+}
+
+__attribute__((target("ssse3"))) void ConvertSSSE3(const uint8_t *color_indices, size_t size,
+                                                   const ColorConverter::Palette &palette, uint32_t *pixels) {
+  const auto byte_tables = SplitPalette(palette);
+  __m128i tables[4][4];
+  for (size_t byte = 0; byte < 4; ++byte) {
+    for (size_t quarter = 0; quarter < 4; ++quarter) {
+      tables[byte][quarter] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(byte_tables[byte][quarter].data()));
+    }
+  }
+  const __m128i quarter_size = _mm_set1_epi8(16);
+  const __m128i keep_in_quarter = _mm_set1_epi8(0x70);
+  const __m128i color_bits = _mm_set1_epi8(0x3F);
+
+  size_t i = 0;
+  for (; i + 16 <= size; i += 16) {
+    // Shuffles give 0 where bit 7 of the index is set. Subtracting the start of the quarter and then adding 0x70 with
+    // saturation keeps the low nibble of the indices within the quarter and pushes all the others to 0x80 or above.
+    __m128i quarter_start = _mm_and_si128(
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(color_indices + i)), color_bits);
+    __m128i shuffles[4];
+    for (size_t q = 0; q < 4; ++q) {
+      shuffles[q] = _mm_adds_epu8(quarter_start, keep_in_quarter);
+      quarter_start = _mm_sub_epi8(quarter_start, quarter_size);
+    }
+
+    __m128i bytes[4];
+    for (size_t byte = 0; byte < 4; ++byte) {
+      bytes[byte] = _mm_or_si128(
+          _mm_or_si128(_mm_shuffle_epi8(tables[byte][0], shuffles[0]), _mm_shuffle_epi8(tables[byte][1], shuffles[1])),
+          _mm_or_si128(_mm_shuffle_epi8(tables[byte][2], shuffles[2]), _mm_shuffle_epi8(tables[byte][3], shuffles[3])));
+    }
+
+    // Back from one register per byte to one 32-bit pixel per lane
+    const __m128i bytes01_low = _mm_unpacklo_epi8(bytes[0], bytes[1]);
+    const __m128i bytes01_high = _mm_unpackhi_epi8(bytes[0], bytes[1]);
+    const __m128i bytes23_low = _mm_unpacklo_epi8(bytes[2], bytes[3]);
+    const __m128i bytes23_high = _mm_unpackhi_epi8(bytes[2], bytes[3]);
+    auto *out = reinterpret_cast<__m128i *>(pixels + i);
+    _mm_storeu_si128(out, _mm_unpacklo_epi16(bytes01_low, bytes23_low));
+    _mm_storeu_si128(out + 1, _mm_unpackhi_epi16(bytes01_low, bytes23_low));
+    _mm_storeu_si128(out + 2, _mm_unpacklo_epi16(bytes01_high, bytes23_high));
+    _mm_storeu_si128(out + 3, _mm_unpackhi_epi16(bytes01_high, bytes23_high));
+  }
+
+  ConvertScalar(color_indices + i, size - i, palette, pixels + i);
+}
+
+__attribute__((target("avx2"))) void ConvertAVX2(const uint8_t *color_indices, size_t size,
+                                                 const ColorConverter::Palette &palette, uint32_t *pixels) {
+  const auto byte_tables = SplitPalette(palette);
+  __m256i tables[4][4];
+  for (size_t byte = 0; byte < 4; ++byte) {
+    for (size_t quarter = 0; quarter < 4; ++quarter) {
+      // Shuffles don't cross 128-bit lanes, so both lanes get the whole table
+      tables[byte][quarter] = _mm256_broadcastsi128_si256(
+          _mm_loadu_si128(reinterpret_cast<const __m128i *>(byte_tables[byte][quarter].data())));
+    }
+  }
+  const __m256i quarter_size = _mm256_set1_epi8(16);
+  const __m256i keep_in_quarter = _mm256_set1_epi8(0x70);
+  const __m256i color_bits = _mm256_set1_epi8(0x3F);
+  // The unpacks below work within each 128-bit lane, so every lane gets groups of 4 indices such that the pixels come
+  // out in order: indices 0-3, 8-11, 16-19 and 24-27 in the low lane, the ones in between in the high lane.
+  const __m256i lane_order = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+
+  size_t i = 0;
+  for (; i + 32 <= size; i += 32) {
+    const __m256i indices = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(color_indices + i));
+    __m256i quarter_start = _mm256_and_si256(_mm256_permutevar8x32_epi32(indices, lane_order), color_bits);
+    __m256i shuffles[4];
+    for (size_t q = 0; q < 4; ++q) {
+      shuffles[q] = _mm256_adds_epu8(quarter_start, keep_in_quarter);
+      quarter_start = _mm256_sub_epi8(quarter_start, quarter_size);
+    }
+
+    __m256i bytes[4];
+    for (size_t byte = 0; byte < 4; ++byte) {
+      bytes[byte] = _mm256_or_si256(_mm256_or_si256(_mm256_shuffle_epi8(tables[byte][0], shuffles[0]),
+                                                    _mm256_shuffle_epi8(tables[byte][1], shuffles[1])),
+                                    _mm256_or_si256(_mm256_shuffle_epi8(tables[byte][2], shuffles[2]),
+                                                    _mm256_shuffle_epi8(tables[byte][3], shuffles[3])));
+    }
+
+    const __m256i bytes01_low = _mm256_unpacklo_epi8(bytes[0], bytes[1]);
+    const __m256i bytes01_high = _mm256_unpackhi_epi8(bytes[0], bytes[1]);
+    const __m256i bytes23_low = _mm256_unpacklo_epi8(bytes[2], bytes[3]);
+    const __m256i bytes23_high = _mm256_unpackhi_epi8(bytes[2], bytes[3]);
+    auto *out = reinterpret_cast<__m256i *>(pixels + i);
+    _mm256_storeu_si256(out, _mm256_unpacklo_epi16(bytes01_low, bytes23_low));
+    _mm256_storeu_si256(out + 1, _mm256_unpackhi_epi16(bytes01_low, bytes23_low));
+    _mm256_storeu_si256(out + 2, _mm256_unpacklo_epi16(bytes01_high, bytes23_high));
+    _mm256_storeu_si256(out + 3, _mm256_unpackhi_epi16(bytes01_high, bytes23_high));
+  }
+
+  ConvertScalar(color_indices + i, size - i, palette, pixels + i);
+}
+#endif
+
+using Dispatch = CpuDispatch<ColorConverter::Implementation,
+                             void (*)(const uint8_t *, size_t, const ColorConverter::Palette &, uint32_t *)>;
+using enum ColorConverter::Implementation;
+
+constexpr Dispatch::Entry entries[] = {
+    {Scalar, CpuFeature::None, ConvertScalar},
+#if BNES_CPUFEATURES_X86
+    {SSSE3, CpuFeature::SSSE3, ConvertSSSE3},
+    {AVX2, CpuFeature::AVX2, ConvertAVX2},
+#endif
+};
+// SSSE3 loses to the scalar lookups, it's only there for benchmarking
+constexpr ColorConverter::Implementation preferred[] = {AVX2, Scalar};
+constexpr Dispatch dispatch{entries, preferred};
+} // namespace
+
+const ColorConverter::ConvertFunction ColorConverter::s_convert = dispatch.Get(dispatch.Best());
+
+void ColorConverter::Convert(Implementation implementation, std::span<const uint8_t> color_indices,
+                             const Palette &palette, std::span<uint32_t> pixels) {
+  dispatch.Get(implementation)(color_indices.data(), color_indices.size(), palette, pixels.data());
+}
+
+bool ColorConverter::Supported(Implementation implementation) { return dispatch.Supported(implementation); }
+
+ColorConverter::Implementation ColorConverter::Best() { return dispatch.Best(); }
+
+} // namespace BNES::HW
@@ -0,0 +1,48 @@
+//
+// Created by Valerio Formato on 17-Oct-26.
+//
+
+#ifndef BNES_COLORCONVERTER_H
+#define BNES_COLORCONVERTER_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace BNES::HW {
+
+// Turns the color indices drawn by the PPU into 32-bit pixels through a 64-entry table. The bytes of each entry are
+// copied as they are, so the table decides the pixel format. The vector implementations split the table in four
+// 16-byte chunks per byte of the pixel and look them up with byte shuffles. As for the tile decoder, the best
+// implementation is picked at runtime and the others are kept for testing and benchmarking.
+class ColorConverter {
+public:
+  static constexpr size_t N_COLORS = 64;
+  using Palette = std::array<uint32_t, N_COLORS>;
+
+  enum class Implementation {
+    Scalar,
+    SSSE3, // 16 pixels per iteration, too many shuffles to beat plain table lookups
+    AVX2,  // 32 pixels per iteration
+  };
+
+  // Indices above 63 wrap around. `pixels` has to be at least as long as `color_indices`.
+  static void Convert(std::span<const uint8_t> color_indices, const Palette &palette, std::span<uint32_t> pixels) {
+    s_convert(color_indices.data(), color_indices.size(), palette, pixels.data());
+  }
+  static void Convert(Implementation implementation, std::span<const uint8_t> color_indices, const Palette &palette,
+                      std::span<uint32_t> pixels);
+
+  [[nodiscard]] static bool Supported(Implementation implementation);
+  [[nodiscard]] static Implementation Best();
+
+private:
+  using ConvertFunction = void (*)(const uint8_t *color_indices, size_t size, const Palette &palette,
+                                   uint32_t *pixels);
+  static const ConvertFunction s_convert;
+};
+
+} // namespace BNES::HW
+
+#endif // BNES_COLORCONVERTER_H
@@ -0,0 +1,88 @@
+//
+// Created by Valerio Formato on 17-Oct-26.
+//
+
+#ifndef BNES_CPUFEATURES_H
+#define BNES_CPUFEATURES_H
+
+#include <algorithm>
+#include <span>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define BNES_CPUFEATURES_X86 1
+#else
+#define BNES_CPUFEATURES_X86 0
+#endif
+
+namespace BNES::HW {
+
+// The instruction set extensions our vectorized code can ask for
+enum class CpuFeature {
+  None,
+  SSE2,
+  SSSE3,
+  AVX2,
+};
+
+[[nodiscard]] inline bool CpuSupports(CpuFeature feature) {
+#if BNES_CPUFEATURES_X86
+  // We can get here from static initialization, before the runtime has looked at the CPU
+  __builtin_cpu_init();
+  switch (feature) {
+  case CpuFeature::None:
+    return true;
+  case CpuFeature::SSE2:
+    return __builtin_cpu_supports("sse2");
+  case CpuFeature::SSSE3:
+    return __builtin_cpu_supports("ssse3");
+  case CpuFeature::AVX2:
+    return __builtin_cpu_supports("avx2");
+  }
+  return false;
+#else
+  return feature == CpuFeature::None;
+#endif
+}
+
+// Picks between the implementations of a routine according to what the CPU supports. `entries` holds every
+// implementation compiled in, `preferred` the ones worth picking, fastest first, ending with one that needs nothing.
+// Both are usually constexpr arrays, so that the dispatch can be used from static initialization.
+template <typename Implementation, typename Function> class CpuDispatch {
+public:
+  struct Entry {
+    Implementation implementation;
+    CpuFeature required;
+    Function function;
+  };
+
+  constexpr CpuDispatch(std::span<const Entry> entries, std::span<const Implementation> preferred)
+      : m_entries{entries}, m_preferred{preferred} {}
+
+  [[nodiscard]] bool Supported(Implementation implementation) const {
+    const auto *entry = Find(implementation);
+    return entry && CpuSupports(entry->required);
+  }
+
+  [[nodiscard]] Implementation Best() const {
+    const auto it = std::ranges::find_if(m_preferred, [this](Implementation impl) { return Supported(impl); });
+    return it != m_preferred.end() ? *it : m_preferred.back();
+  }
+
+  // Implementations the CPU can't run fall back to the one that runs anywhere
+  [[nodiscard]] Function Get(Implementation implementation) const {
+    return Find(Supported(implementation) ? implementation : m_preferred.back())->function;
+  }
+
+private:
+  [[nodiscard]] const Entry *Find(Implementation implementation) const {
+    const auto it = std::ranges::find(m_entries, implementation, &Entry::implementation);
+    return it != m_entries.end() ? &*it : nullptr;
+  }
+
+  std::span<const Entry> m_entries;
+  std::span<const Implementation> m_preferred;
+};
+
+} // namespace BNES::HW
+
+#endif // BNES_CPUFEATURES_H
@@ -0,0 +1,966 @@
+//
+// Created by Valerio Formato on 17-Oct-26.
+//
+
+#include "HW/Dynarec.h"
+#include "HW/CPU.h"
+
+#include <spdlog/fmt/fmt.h>
+
+#include <cstring>
+#include <initializer_list>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <vector>
+
+#if BNES_DYNAREC_SUPPORTED
+#include <sys/mman.h>
+#endif
+
+namespace BNES::HW {
+
+namespace {
+// Minimal x86-64 emitter, only what the translator needs
+enum Reg : uint8_t { RAX = 0, RCX, RDX, RBX, RSP, RBP, RSI, RDI, R8, R9, R10, R11, R12, R13, R14, R15 };
+
+// Low nibble of the Jcc/SETcc opcodes
+enum class Cond : uint8_t { Overflow = 0x0, Carry = 0x2, NoCarry = 0x3, Zero = 0x4, NotZero = 0x5 };
+
+// The /digit of the group 1 (ALU) and group 2 (shift and rotate) opcodes
+enum class AluOp : uint8_t { Add = 0, Or, Adc, Sbb, And, Sub, Xor, Cmp };
+enum class ShiftOp : uint8_t { Rcl = 2, Rcr, Shl, Shr };
+
+struct Mem {
+  Reg base;
+  int32_t disp{0};
+  std::optional<Reg> index{};
+  uint8_t scale{1};
+};
+
+struct Label {
+  std::optional<size_t> position;
+  std::vector<size_t> fixups;
+};
+
+class Emitter {
+public:
+  void Byte(uint8_t value) { m_code.push_back(value); }
+
+  template <typename T> void Immediate(T value) {
+    const auto offset = m_code.size();
+    m_code.resize(offset + sizeof(T));
+    std::memcpy(m_code.data() + offset, &value, sizeof(T));
+  }
+
+  void Movzx8(Reg dst, const Mem &src) { Op({0x0F, 0xB6}, dst, src); }
+  void Movzx8(Reg dst, Reg src) { OpReg({0x0F, 0xB6}, dst, src, false, true); }
+  void Movzx16(Reg dst, Reg src) { OpReg({0x0F, 0xB7}, dst, src); }
+  void Load8(Reg dst, const Mem &src) { Op({0x8A}, dst, src, false, true); }
+  void Store8(const Mem &dst, Reg src) { Op({0x88}, src, dst, false, true); }
+  void Store8Imm(const Mem &dst, uint8_t value) {
+    Op({0xC6}, 0, dst);
+    Byte(value);
+  }
+  void Store16(const Mem &dst, Reg src) {
+    Byte(0x66);
+    Op({0x89}, src, dst);
+  }
+  void Store16Imm(const Mem &dst, uint16_t value) {
+    Byte(0x66);
+    Op({0xC7}, 0, dst);
+    Immediate(value);
+  }
+  void Load32(Reg dst, const Mem &src) { Op({0x8B}, dst, src); }
+  void Store32(const Mem &dst, Reg src) { Op({0x89}, src, dst); }
+  void Load64(Reg dst, const Mem &src) { Op({0x8B}, dst, src, true); }
+  void Mov32(Reg dst, Reg src) { OpReg({0x89}, src, dst); }
+  void Mov64(Reg dst, Reg src) { OpReg({0x89}, src, dst, true); }
+  void Mov32Imm(Reg dst, uint32_t value) {
+    Rex(false, 0, 0, dst);
+    Byte(0xB8 + (dst & 7));
+    Immediate(value);
+  }
+  void Mov64Imm(Reg dst, uint64_t value) {
+    Rex(true, 0, 0, dst);
+    Byte(0xB8 + (dst & 7));
+    Immediate(value);
+  }
+
+  void Alu8(AluOp op, Reg dst, Reg src) { OpReg({static_cast<uint8_t>(Digit(op) << 3)}, src, dst, false, true); }
+  void Alu8Imm(AluOp op, Reg dst, uint8_t value) {
+    OpDigit({0x80}, Digit(op), dst, false, true);
+    Byte(value);
+  }
+  void Alu8Imm(AluOp op, const Mem &dst, uint8_t value) {
+    Op({0x80}, Digit(op), dst);
+    Byte(value);
+  }
+  void Alu32(AluOp op, Reg dst, Reg src) { OpReg({static_cast<uint8_t>(Digit(op) << 3 | 1)}, src, dst); }
+  void Alu32Imm(AluOp op, Reg dst, uint32_t value) {
+    OpDigit({0x81}, Digit(op), dst);
+    Immediate(value);
+  }
+  void Alu64Imm(AluOp op, const Mem &dst, uint32_t value) {
+    Op({0x81}, Digit(op), dst, true);
+    Immediate(value);
+  }
+  void Shift8(ShiftOp op, Reg dst) { OpDigit({0xD0}, Digit(op), dst, false, true); }
+  void Shift32Imm(ShiftOp op, Reg dst, uint8_t count) {
+    OpDigit({0xC1}, Digit(op), dst);
+    Byte(count);
+  }
+  void Inc8(Reg dst) { OpDigit({0xFE}, 0, dst, false, true); }
+  void Dec8(Reg dst) { OpDigit({0xFE}, 1, dst, false, true); }
+  void Inc8(const Mem &dst) { Op({0xFE}, 0, dst); }
+  void Dec8(const Mem &dst) { Op({0xFE}, 1, dst); }
+  void Inc32(Reg dst) { OpDigit({0xFF}, 0, dst); }
+  void Test8(Reg first, Reg second) { OpReg({0x84}, second, first, false, true); }
+  void Test8Imm(Reg dst, uint8_t value) {
+    OpDigit({0xF6}, 0, dst, false, true);
+    Byte(value);
+  }
+  void Test8Imm(const Mem &dst, uint8_t value) {
+    Op({0xF6}, 0, dst);
+    Byte(value);
+  }
+  void Test64(Reg first, Reg second) { OpReg({0x85}, second, first, true); }
+  void Set(Cond cond, Reg dst) { OpDigit({0x0F, static_cast<uint8_t>(0x90 | Digit(cond))}, 0, dst, false, true); }
+  void Set(Cond cond, const Mem &dst) { Op({0x0F, static_cast<uint8_t>(0x90 | Digit(cond))}, 0, dst); }
+  void Cmc() { Byte(0xF5); }
+
+  void Push(Reg reg) {
+    Rex(false, 0, 0, reg);
+    Byte(0x50 + (reg & 7));
+  }
+  void Pop(Reg reg) {
+    Rex(false, 0, 0, reg);
+    Byte(0x58 + (reg & 7));
+  }
+  void AdjustStack(int8_t bytes) {
+    // add/sub rsp, imm8
+    OpDigit({0x83}, bytes < 0 ? 5 : 0, RSP, true);
+    Byte(static_cast<uint8_t>(bytes < 0 ? -bytes : bytes));
+  }
+  void EndBranch() { Bytes({0xF3, 0x0F, 0x1E, 0xFA}); }
+  void Ret() { Byte(0xC3); }
+  void Call(const void *function) {
+    Mov64Imm(RAX, reinterpret_cast<uint64_t>(function));
+    Bytes({0xFF, 0xD0});
+  }
+
+  void Jump(Label &label) {
+    Byte(0xE9);
+    Target(label);
+  }
+  void Jump(Cond cond, Label &label) {
+    Bytes({0x0F, static_cast<uint8_t>(0x80 | Digit(cond))});
+    Target(label);
+  }
+  void Bind(Label &label) {
+    label.position = m_code.size();
+    for (const auto fixup : label.fixups) {
+      Patch(fixup, *label.position);
+    }
+    label.fixups.clear();
+  }
+
+  [[nodiscard]] size_t Size() const { return m_code.size(); }
+  [[nodiscard]] const std::vector<uint8_t> &Code() const { return m_code; }
+
+private:
+  std::vector<uint8_t> m_code;
+
+  template <typename E> static unsigned int Digit(E value) { return static_cast<unsigned int>(value); }
+
+  void Bytes(std::initializer_list<uint8_t> bytes) { m_code.insert(m_code.end(), bytes); }
+
+  // Byte registers 4-7 are spl, bpl, sil and dil only with a REX prefix, without one they are ah, ch, dh and bh
+  static bool NeedsRexForByte(unsigned int reg) { return reg >= 4 && reg < 8; }
+
+  void Rex(bool wide, unsigned int reg, unsigned int index, unsigned int base, bool force = false) {
+    const uint8_t rex = 0x40 | (wide ? 0x08 : 0) | ((reg >> 3) << 2) | ((index >> 3) << 1) | (base >> 3);
+    if (rex != 0x40 || force) {
+      Byte(rex);
+    }
+  }
+
+  // reg, [mem]
+  void Op(std::initializer_list<uint8_t> opcode, unsigned int reg, const Mem &mem, bool wide = false,
+          bool byte_reg = false) {
+    Rex(wide, reg, mem.index.value_or(RAX), mem.base, byte_reg && NeedsRexForByte(reg));
+    Bytes(opcode);
+
+    const unsigned int base = mem.base & 7;
+    const bool sib = mem.index || base == 4;
+    // [rbp] and [r13] can only be encoded with a displacement
+    const unsigned int mod = (mem.disp == 0 && base != 5) ? 0 : (mem.disp >= -128 && mem.disp <= 127 ? 1 : 2);
+    Byte(mod << 6 | (reg & 7) << 3 | (sib ? 4 : base));
+    if (sib) {
+      const unsigned int scale = mem.scale == 8 ? 3 : mem.scale == 4 ? 2 : mem.scale == 2 ? 1 : 0;
+      const unsigned int index = mem.index ? (*mem.index & 7) : 4;
+      Byte(scale << 6 | index << 3 | base);
+    }
+
+    if (mod == 1) {
+      Byte(static_cast<uint8_t>(mem.disp));
+    } else if (mod == 2) {
+      Immediate(mem.disp);
+    }
+  }
+
+  // reg, rm with both of them registers
+  void OpReg(std::initializer_list<uint8_t> opcode, unsigned int reg, unsigned int rm, bool wide = false,
+             bool byte_regs = false) {
+    Rex(wide, reg, 0, rm, byte_regs && (NeedsRexForByte(reg) || NeedsRexForByte(rm)));
+    Bytes(opcode);
+    Byte(0xC0 | (reg & 7) << 3 | (rm & 7));
+  }
+
+  // /digit, rm with rm a register
+  void OpDigit(std::initializer_list<uint8_t> opcode, unsigned int digit, unsigned int rm, bool wide = false,
+               bool byte_reg = false) {
+    Rex(wide, 0, 0, rm, byte_reg && NeedsRexForByte(rm));
+    Bytes(opcode);
+    Byte(0xC0 | (digit & 7) << 3 | (rm & 7));
+  }
+
+  void Target(Label &label) {
+    const auto fixup = m_code.size();
+    Immediate(int32_t{0});
+    if (label.position) {
+      Patch(fixup, *label.position);
+    } else {
+      label.fixups.push_back(fixup);
+    }
+  }
+
+  void Patch(size_t fixup, size_t target) {
+    const auto relative = static_cast<int32_t>(static_cast<int64_t>(target) - static_cast<int64_t>(fixup + 4));
+    std::memcpy(m_code.data() + fixup, &relative, sizeof(relative));
+  }
+};
+
+constexpr bool IsDirect(AddressingMode mode) {
+  return mode != AddressingMode::Indirect && mode != AddressingMode::IndirectX && mode != AddressingMode::IndirectY;
+}
+
+// Same rule the block interpreter uses to decide whether the bus has to be synced first (see NeedsBusSync in
+// CPU.cpp): anything else has to see the PPU up to date, which only the interpreter takes care of.
+template <AddressingMode MODE> constexpr bool ReadsRamOrRom(uint16_t operand) {
+  if constexpr (MODE == AddressingMode::Absolute) {
+    return operand < 0x2000 || operand >= 0x8000;
+  } else if constexpr (MODE == AddressingMode::AbsoluteX || MODE == AddressingMode::AbsoluteY) {
+    return operand + 0xFF < 0x2000 || operand >= 0x8000;
+  }
+  return IsDirect(MODE);
+}
+
+// Writes anywhere else could bank switch the code we're running or poke the PPU
+template <AddressingMode MODE> constexpr bool WritesRamOnly(uint16_t operand) {
+  switch (MODE) {
+  case AddressingMode::Accumulator:
+  case AddressingMode::ZeroPage:
+  case AddressingMode::ZeroPageX:
+  case AddressingMode::ZeroPageY:
+    return true;
+  case AddressingMode::Absolute:
+    return operand < 0x2000;
+  case AddressingMode::AbsoluteX:
+  case AddressingMode::AbsoluteY:
+    return operand + 0xFF < 0x2000;
+  default:
+    return false;
+  }
+}
+} // namespace
+
+// Register use in the generated code:
+// - rbx: the CPU, rbp: the bus
+// - r14d: the cycle budget (m_cycle_budget), r15d: the cycles not charged to the bus yet (m_pending_cycles)
+// - r12d: the effective address of the current instruction, r13d: the value to write
+// - everything else is scratch, and clobbered by the calls into the bus
+class Dynarec::Translator {
+public:
+  enum class Result { Unsupported, Continue, Exited };
+
+  Translator(Emitter &emitter, const Layout &layout) : m_asm{emitter}, m_layout{layout} {}
+
+  void Prologue() {
+    m_asm.EndBranch();
+    for (const auto reg : {RBX, RBP, R12, R13, R14, R15}) {
+      m_asm.Push(reg);
+    }
+    // Six pushes and the return address: realign the stack to 16 bytes for the calls
+    m_asm.AdjustStack(-8);
+    m_asm.Mov64(RBX, RDI);
+    m_asm.Mov64(RBP, RSI);
+    m_asm.Load32(R15, State(m_layout.pending_cycles));
+    m_asm.Load32(R14, State(m_layout.cycle_budget));
+  }
+
+  // Returns false if the instruction can't be translated
+  bool Translate(const CPU::Instruction &instruction, uint16_t address, bool last) {
+    m_address = address;
+    return std::visit(
+        [this, last](const auto &instr) {
+          const auto result = Emit(instr);
+          if (result == Result::Continue) {
+            const auto next_address = static_cast<uint16_t>(m_address + instr.size);
+            ChargeCycles(instr.cycles);
+            if (last) {
+              ExitTo(next_address);
+            } else {
+              CheckBudget(next_address);
+            }
+          }
+          return result != Result::Unsupported;
+        },
+        instruction);
+  }
+
+  void Finish() {
+    m_asm.Bind(m_exit);
+    m_asm.Store32(State(m_layout.pending_cycles), R15);
+    m_asm.AdjustStack(8);
+    for (const auto reg : {R15, R14, R13, R12, RBP, RBX}) {
+      m_asm.Pop(reg);
+    }
+    m_asm.Ret();
+
+    // Out of line: the next PPU event was reached, tick the bus and see whether we can keep going
+    for (auto &checkpoint : m_checkpoints) {
+      m_asm.Bind(checkpoint.stub);
+      m_asm.Store16Imm(State(m_layout.program_counter), checkpoint.next_address);
+      m_asm.Mov64(RDI, RBX);
+      m_asm.Mov32(RSI, R15);
+      m_asm.Call(reinterpret_cast<const void *>(&Dynarec::Checkpoint));
+      m_asm.Alu32(AluOp::Xor, R15, R15);
+      m_asm.Load32(R14, State(m_layout.cycle_budget));
+      m_asm.Test8(RAX, RAX);
+      m_asm.Jump(Cond::Zero, m_exit);
+      m_asm.Jump(checkpoint.resume);
+    }
+  }
+
+private:
+  Emitter &m_asm;
+  const Layout &m_layout;
+  uint16_t m_address{0};
+
+  Label m_exit;
+  struct PendingCheckpoint {
+    Label stub;
+    Label resume;
+    uint16_t next_address;
+  };
+  std::vector<PendingCheckpoint> m_checkpoints;
+
+  // Where an instruction reads from or writes to
+  struct Operand {
+    enum class Kind {
+      Immediate,   // `value` is the operand itself
+      Accumulator, // the A register
+      Fixed,       // `value` is the address
+      PageOffset,  // `value` is the page, r12d the offset within it
+      Indexed,     // r12d is the address
+    };
+    Kind kind;
+    uint16_t value{0};
+  };
+
+  [[nodiscard]] static Mem State(int32_t offset) { return {.base = RBX, .disp = offset}; }
+  [[nodiscard]] Mem Register(CPU::Register reg) const {
+    return State(m_layout.registers[static_cast<size_t>(reg)]);
+  }
+
+  void SetZeroAndNegative(Reg result) {
+    m_asm.Store8(State(m_layout.zero_result), result);
+    m_asm.Store8(State(m_layout.negative_result), result);
+  }
+
+  // The carry flag of the host, from the one of the 6502 (or its complement)
+  void LoadCarry(bool inverted = false) {
+    m_asm.Alu8Imm(AluOp::Cmp, State(m_layout.carry), 1);
+    if (!inverted) {
+      m_asm.Cmc();
+    }
+  }
+
+  void ChargeCycles(unsigned int cycles) {
+    m_asm.Alu64Imm(AluOp::Add, State(m_layout.cycles), cycles);
+    m_asm.Alu32Imm(AluOp::Add, R15, cycles);
+  }
+
+  void CheckBudget(uint16_t next_address) {
+    auto &checkpoint = m_checkpoints.emplace_back(PendingCheckpoint{{}, {}, next_address});
+    m_asm.Alu32(AluOp::Cmp, R15, R14);
+    m_asm.Jump(Cond::NoCarry, checkpoint.stub);
+    m_asm.Bind(checkpoint.resume);
+  }
+
+  void ExitTo(uint16_t address) {
+    m_asm.Store16Imm(State(m_layout.program_counter), address);
+    m_asm.Jump(m_exit);
+  }
+
+  template <AddressingMode MODE> Operand Resolve(uint16_t operand) {
+    using enum AddressingMode;
+    if constexpr (MODE == Immediate) {
+      return {.kind = Operand::Kind::Immediate, .value = static_cast<uint16_t>(operand & 0xFF)};
+    } else if constexpr (MODE == Accumulator) {
+      return {.kind = Operand::Kind::Accumulator};
+    } else if constexpr (MODE == ZeroPage) {
+      return {.kind = Operand::Kind::Fixed, .value = static_cast<uint16_t>(operand & 0xFF)};
+    } else if constexpr (MODE == ZeroPageX || MODE == ZeroPageY) {
+      // Wraps around within the zero page
+      m_asm.Movzx8(R12, Register(MODE == ZeroPageX ? CPU::Register::X : CPU::Register::Y));
+      m_asm.Alu8Imm(AluOp::Add, R12, operand & 0xFF);
+      return {.kind = Operand::Kind::PageOffset, .value = 0};
+    } else if constexpr (MODE == Absolute) {
+      return {.kind = Operand::Kind::Fixed, .value = operand};
+    } else {
+      static_assert(MODE == AbsoluteX || MODE == AbsoluteY);
+      m_asm.Movzx8(R12, Register(MODE == AbsoluteX ? CPU::Register::X : CPU::Register::Y));
+      m_asm.Alu32Imm(AluOp::Add, R12, operand);
+      m_asm.Movzx16(R12, R12);
+      return {.kind = Operand::Kind::Indexed};
+    }
+  }
+
+  // The entry of a page table for the operand. For indexed operands the page is computed into rax.
+  Mem PageEntry(int32_t table, size_t entry_size, const Operand &operand) {
+    switch (operand.kind) {
+    case Operand::Kind::Fixed:
+      return {.base = RBP, .disp = table + static_cast<int32_t>((operand.value >> 8) * entry_size)};
+    case Operand::Kind::PageOffset:
+      return {.base = RBP, .disp = table + static_cast<int32_t>(operand.value * entry_size)};
+    default:
+      m_asm.Mov32(RAX, R12);
+      m_asm.Shift32Imm(ShiftOp::Shr, RAX, 8);
+      return {.base = RBP, .disp = table, .index = RAX, .scale = static_cast<uint8_t>(entry_size)};
+    }
+  }
+
+  // The operand byte, once rdx points to its page
+  Mem PageByte(const Operand &operand) {
+    switch (operand.kind) {
+    case Operand::Kind::Fixed:
+      return {.base = RDX, .disp = operand.value & 0xFF};
+    case Operand::Kind::PageOffset:
+      return {.base = RDX, .disp = 0, .index = R12};
+    default:
+      m_asm.Movzx8(RCX, R12);
+      return {.base = RDX, .disp = 0, .index = RCX};
+    }
+  }
+
+  void AddressTo(Reg reg, const Operand &operand) {
+    switch (operand.kind) {
+    case Operand::Kind::Fixed:
+      m_asm.Mov32Imm(reg, operand.value);
+      break;
+    case Operand::Kind::PageOffset:
+      m_asm.Mov32(reg, R12);
+      m_asm.Alu32Imm(AluOp::Or, reg, operand.value << 8);
+      break;
+    default:
+      m_asm.Mov32(reg, R12);
+      break;
+    }
+  }
+
+  // Same as Bus::Read, into eax
+  void EmitRead(const Operand &operand) {
+    if (operand.kind == Operand::Kind::Immediate) {
+      m_asm.Mov32Imm(RAX, operand.value);
+      return;
+    }
+    if (operand.kind == Operand::Kind::Accumulator) {
+      m_asm.Movzx8(RAX, Register(CPU::Register::A));
+      return;
+    }
+
+    Label slow;
+    Label done;
+    m_asm.Load64(RDX, PageEntry(m_layout.read_pages, sizeof(uint8_t *), operand));
+    m_asm.Test64(RDX, RDX);
+    m_asm.Jump(Cond::Zero, slow);
+    m_asm.Movzx8(RAX, PageByte(operand));
+    m_asm.Jump(done);
+
+    m_asm.Bind(slow);
+    m_asm.Mov64(RDI, RBP);
+    AddressTo(RSI, operand);
+    m_asm.Call(reinterpret_cast<const void *>(&Dynarec::Read));
+    m_asm.Bind(done);
+  }
+
+  // Same as Bus::Write, of r13b
+  void EmitWrite(const Operand &operand) {
+    if (operand.kind == Operand::Kind::Accumulator) {
+      m_asm.Store8(Register(CPU::Register::A), R13);
+      return;
+    }
+
+    Label slow;
+    Label done;
+    // Writes to pages holding decoded code have to go through the bus, which invalidates it
+    m_asm.Alu8Imm(AluOp::Cmp, PageEntry(m_layout.code_pages, sizeof(uint8_t), operand), 0);
+    m_asm.Jump(Cond::NotZero, slow);
+    m_asm.Load64(RDX, PageEntry(m_layout.write_pages, sizeof(uint8_t *), operand));
+    m_asm.Test64(RDX, RDX);
+    m_asm.Jump(Cond::Zero, slow);
+    m_asm.Store8(PageByte(operand), R13);
+    m_asm.Jump(done);
+
+    m_asm.Bind(slow);
+    m_asm.Mov64(RDI, RBP);
+    AddressTo(RSI, operand);
+    m_asm.Mov32(RDX, R13);
+    m_asm.Call(reinterpret_cast<const void *>(&Dynarec::Write));
+    m_asm.Bind(done);
+  }
+
+  void Push() {
+    m_asm.Movzx8(R12, State(m_layout.stack_pointer));
+    EmitWrite({.kind = Operand::Kind::PageOffset, .value = CPU::StackBaseAddress >> 8});
+    m_asm.Dec8(State(m_layout.stack_pointer));
+  }
+
+  void Pull() {
+    m_asm.Inc8(State(m_layout.stack_pointer));
+    m_asm.Movzx8(R12, State(m_layout.stack_pointer));
+    EmitRead({.kind = Operand::Kind::PageOffset, .value = CPU::StackBaseAddress >> 8});
+  }
+
+  // The operand of a read-only instruction, into eax
+  template <AddressingMode MODE> bool ReadOperand(uint16_t operand) {
+    if constexpr (!IsDirect(MODE)) {
+      return false;
+    } else {
+      if (!ReadsRamOrRom<MODE>(operand)) {
+        return false;
+      }
+      EmitRead(Resolve<MODE>(operand));
+      return true;
+    }
+  }
+
+  // Reads the operand into r13d, lets `modify` change it (and set the carry), then writes it back
+  template <AddressingMode MODE, typename F> Result ReadModifyWrite(uint16_t address, F &&modify) {
+    if constexpr (!IsDirect(MODE)) {
+      return Result::Unsupported;
+    } else {
+      if (!WritesRamOnly<MODE>(address)) {
+        return Result::Unsupported;
+      }
+      const auto operand = Resolve<MODE>(address);
+      EmitRead(operand);
+      m_asm.Mov32(R13, RAX);
+      modify();
+      EmitWrite(operand);
+      SetZeroAndNegative(R13);
+      return Result::Continue;
+    }
+  }
+
+  // A op= operand
+  template <AddressingMode MODE> Result Logical(AluOp op, uint16_t operand) {
+    if (!ReadOperand<MODE>(operand)) {
+      return Result::Unsupported;
+    }
+    m_asm.Load8(RCX, Register(CPU::Register::A));
+    m_asm.Alu8(op, RCX, RAX);
+    m_asm.Store8(Register(CPU::Register::A), RCX);
+    SetZeroAndNegative(RCX);
+    return Result::Continue;
+  }
+
+  // Anything we don't know about is left to the interpreter
+  template <typename INSTR> Result Emit(const INSTR &) { return Result::Unsupported; }
+
+  Result Emit(const CPU::NoOperation &) { return Result::Continue; }
+  template <AddressingMode MODE> Result Emit(const CPU::DoubleNoOperation<MODE> &) { return Result::Continue; }
+  template <AddressingMode MODE> Result Emit(const CPU::TripleNoOperation<MODE> &) { return Result::Continue; }
+
+  template <CPU::Register REG, AddressingMode MODE> Result Emit(const CPU::LoadRegister<REG, MODE> &instruction) {
+    if (!ReadOperand<MODE>(instruction.value)) {
+      return Result::Unsupported;
+    }
+    m_asm.Store8(Register(REG), RAX);
+    SetZeroAndNegative(RAX);
+    return Result::Continue;
+  }
+
+  template <CPU::Register REG, AddressingMode MODE> Result Emit(const CPU::StoreRegister<REG, MODE> &instruction) {
+    if constexpr (!IsDirect(MODE)) {
+      return Result::Unsupported;
+    } else {
+      if (!WritesRamOnly<MODE>(instruction.address)) {
+        return Result::Unsupported;
+      }
+      const auto operand = Resolve<MODE>(instruction.address);
+      m_asm.Movzx8(R13, Register(REG));
+      EmitWrite(operand);
+      return Result::Continue;
+    }
+  }
+
+  template <AddressingMode MODE> Result Emit(const CPU::AddWithCarry<MODE> &instruction) {
+    if (!ReadOperand<MODE>(instruction.value)) {
+      return Result::Unsupported;
+    }
+    // The host carry and overflow come out exactly as the 6502 ones
+    LoadCarry();
+    m_asm.Load8(RCX, Register(CPU::Register::A));
+    m_asm.Alu8(AluOp::Adc, RCX, RAX);
+    m_asm.Set(Cond::Carry, State(m_layout.carry));
+    m_asm.Set(Cond::Overflow, State(m_layout.overflow));
+    m_asm.Store8(Register(CPU::Register::A), RCX);
+    SetZeroAndNegative(RCX);
+    return Result::Continue;
+  }
+
+  template <AddressingMode MODE> Result Emit(const CPU::SubtractWithCarry<MODE> &instruction) {
+    if (!ReadOperand<MODE>(instruction.value)) {
+      return Result::Unsupported;
+    }
+    // The host borrows where the 6502 clears the carry
+    LoadCarry(true);
+    m_asm.Load8(RCX, Register(CPU::Register::A));
+    m_asm.Alu8(AluOp::Sbb, RCX, RAX);
+    m_asm.Set(Cond::NoCarry, State(m_layout.carry));
+    m_asm.Set(Cond::Overflow, State(m_layout.overflow));
+    m_asm.Store8(Register(CPU::Register::A), RCX);
+    SetZeroAndNegative(RCX);
+    return Result::Continue;
+  }
+
+  template <AddressingMode MODE> Result Emit(const CPU::LogicalAND<MODE> &instruction) {
+    return Logical<MODE>(AluOp::And, instruction.value);
+  }
+  template <AddressingMode MODE> Result Emit(const CPU::BitwiseOR<MODE> &instruction) {
+    return Logical<MODE>(AluOp::Or, instruction.value);
+  }
+  template <AddressingMode MODE> Result Emit(const CPU::ExclusiveOR<MODE> &instruction) {
+    return Logical<MODE>(AluOp::Xor, instruction.value);
+  }
+
+  template <CPU::Register REG, AddressingMode MODE> Result Emit(const CPU::CompareRegister<REG, MODE> &instruction) {
+    if (!ReadOperand<MODE>(instruction.value)) {
+      return Result::Unsupported;
+    }
+    m_asm.Load8(RCX, Register(REG));
+    m_asm.Alu8(AluOp::Sub, RCX, RAX);
+    m_asm.Set(Cond::NoCarry, State(m_layout.carry));
+    SetZeroAndNegative(RCX);
+    return Result::Continue;
+  }
+
+  template <AddressingMode MODE> Result Emit(const CPU::BitTest<MODE> &instruction) {
+    if (!ReadOperand<MODE>(instruction.address)) {
+      return Result::Unsupported;
+    }
+    m_asm.Load8(RCX, Register(CPU::Register::A));
+    m_asm.Alu8(AluOp::And, RCX, RAX);
+    m_asm.Store8(State(m_layout.zero_result), RCX);
+    m_asm.Store8(State(m_layout.negative_result), RAX);
+    m_asm.Test8Imm(RAX, 0x40);
+    m_asm.Set(Cond::NotZero, State(m_layout.overflow));
+    return Result::Continue;
+  }
+
+  template <AddressingMode MODE> Result Emit(const CPU::ShiftLeft<MODE> &instruction) {
+    return ReadModifyWrite<MODE>(instruction.address, [this] {
+      m_asm.Shift8(ShiftOp::Shl, R13);
+      m_asm.Set(Cond::Carry, State(m_layout.carry));
+    });
+  }
+  template <AddressingMode MODE> Result Emit(const CPU::ShiftRight<MODE> &instruction) {
+    return ReadModifyWrite<MODE>(instruction.address, [this] {
+      m_asm.Shift8(ShiftOp::Shr, R13);
+      m_asm.Set(Cond::Carry, State(m_layout.carry));
+    });
+  }
+  template <AddressingMode MODE> Result Emit(const CPU::RotateLeft<MODE> &instruction) {
+    return ReadModifyWrite<MODE>(instruction.address, [this] {
+      LoadCarry();
+      m_asm.Shift8(ShiftOp::Rcl, R13);
+      m_asm.Set(Cond::Carry, State(m_layout.carry));
+    });
+  }
+  template <AddressingMode MODE> Result Emit(const CPU::RotateRight<MODE> &instruction) {
+    return ReadModifyWrite<MODE>(instruction.address, [this] {
+      LoadCarry();
+      m_asm.Shift8(ShiftOp::Rcr, R13);
+      m_asm.Set(Cond::Carry, State(m_layout.carry));
+    });
+  }
+  template <AddressingMode MODE> Result Emit(const CPU::Increment<MODE> &instruction) {
+    return ReadModifyWrite<MODE>(instruction.address, [this] { m_asm.Inc8(R13); });
+  }
+  template <AddressingMode MODE> Result Emit(const CPU::Decrement<MODE> &instruction) {
+    return ReadModifyWrite<MODE>(instruction.address, [this] { m_asm.Dec8(R13); });
+  }
+
+  template <CPU::Register REG> Result Emit(const CPU::IncrementRegister<REG> &) {
+    m_asm.Inc8(Register(REG));
+    m_asm.Movzx8(RAX, Register(REG));
+    SetZeroAndNegative(RAX);
+    return Result::Continue;
+  }
+  template <CPU::Register REG> Result Emit(const CPU::DecrementRegister<REG> &) {
+    m_asm.Dec8(Register(REG));
+    m_asm.Movzx8(RAX, Register(REG));
+    SetZeroAndNegative(RAX);
+    return Result::Continue;
+  }
+
+  template <CPU::Register SRCREG, CPU::Register DSTREG> Result Emit(const CPU::TransferRegisterTo<SRCREG, DSTREG> &) {
+    m_asm.Movzx8(RAX, Register(SRCREG));
+    m_asm.Store8(Register(DSTREG), RAX);
+    SetZeroAndNegative(RAX);
+    return Result::Continue;
+  }
+  Result Emit(const CPU::TransferStackPointerToX &) {
+    m_asm.Movzx8(RAX, State(m_layout.stack_pointer));
+    m_asm.Store8(Register(CPU::Register::X), RAX);
+    SetZeroAndNegative(RAX);
+    return Result::Continue;
+  }
+  Result Emit(const CPU::TransferXToStackPointer &) {
+    m_asm.Movzx8(RAX, Register(CPU::Register::X));
+    m_asm.Store8(State(m_layout.stack_pointer), RAX);
+    return Result::Continue;
+  }
+
+  Result Emit(const CPU::PushAccumulator &) {
+    m_asm.Movzx8(R13, Register(CPU::Register::A));
+    Push();
+    return Result::Continue;
+  }
+  Result Emit(const CPU::PullAccumulator &) {
+    Pull();
+    m_asm.Store8(Register(CPU::Register::A), RAX);
+    SetZeroAndNegative(RAX);
+    return Result::Continue;
+  }
+  Result Emit(const CPU::PushStatusRegister &) {
+    // StatusWord() | 0x30
+    m_asm.Movzx8(R13, State(m_layout.flags));
+    m_asm.Alu32Imm(AluOp::Or, R13, 0x30);
+    m_asm.Movzx8(RAX, State(m_layout.carry));
+    m_asm.Alu32(AluOp::Or, R13, RAX);
+    m_asm.Alu8Imm(AluOp::Cmp, State(m_layout.zero_result), 0);
+    m_asm.Set(Cond::Zero, RAX);
+    m_asm.Movzx8(RAX, RAX);
+    m_asm.Shift32Imm(ShiftOp::Shl, RAX, 1);
+    m_asm.Alu32(AluOp::Or, R13, RAX);
+    m_asm.Movzx8(RAX, State(m_layout.overflow));
+    m_asm.Shift32Imm(ShiftOp::Shl, RAX, 6);
+    m_asm.Alu32(AluOp::Or, R13, RAX);
+    m_asm.Movzx8(RAX, State(m_layout.negative_result));
+    m_asm.Alu32Imm(AluOp::And, RAX, 0x80);
+    m_asm.Alu32(AluOp::Or, R13, RAX);
+    Push();
+    return Result::Continue;
+  }
+
+  // Changing the interrupt flag decides whether a pending IRQ is serviced, that's left to the interpreter
+  template <CPU::StatusFlag FLAG> Result SetFlag(bool value) {
+    if constexpr (FLAG == CPU::StatusFlag::Carry) {
+      m_asm.Store8Imm(State(m_layout.carry), value);
+    } else if constexpr (FLAG == CPU::StatusFlag::Overflow) {
+      m_asm.Store8Imm(State(m_layout.overflow), value);
+    } else if constexpr (FLAG == CPU::StatusFlag::DecimalMode) {
+      constexpr uint8_t mask = 1 << static_cast<uint8_t>(FLAG);
+      if (value) {
+        m_asm.Alu8Imm(AluOp::Or, State(m_layout.flags), mask);
+      } else {
+        m_asm.Alu8Imm(AluOp::And, State(m_layout.flags), static_cast<uint8_t>(~mask));
+      }
+    } else {
+      return Result::Unsupported;
+    }
+    return Result::Continue;
+  }
+  template <CPU::StatusFlag FLAG> Result Emit(const CPU::ClearStatusFlag<FLAG> &) { return SetFlag<FLAG>(false); }
+  template <CPU::StatusFlag FLAG> Result Emit(const CPU::SetStatusFlag<FLAG> &) { return SetFlag<FLAG>(true); }
+
+  template <Conditional COND> Result Emit(const CPU::Branch<COND> &instruction) {
+    using enum Conditional;
+    Label not_taken;
+    if constexpr (COND == Equal || COND == NotEqual) {
+      m_asm.Alu8Imm(AluOp::Cmp, State(m_layout.zero_result), 0);
+      m_asm.Jump(COND == Equal ? Cond::NotZero : Cond::Zero, not_taken);
+    } else if constexpr (COND == CarrySet || COND == CarryClear) {
+      m_asm.Alu8Imm(AluOp::Cmp, State(m_layout.carry), 0);
+      m_asm.Jump(COND == CarrySet ? Cond::Zero : Cond::NotZero, not_taken);
+    } else if constexpr (COND == Minus || COND == Positive) {
+      m_asm.Test8Imm(State(m_layout.negative_result), 0x80);
+      m_asm.Jump(COND == Minus ? Cond::Zero : Cond::NotZero, not_taken);
+    } else {
+      m_asm.Alu8Imm(AluOp::Cmp, State(m_layout.overflow), 0);
+      m_asm.Jump(COND == OverflowSet ? Cond::Zero : Cond::NotZero, not_taken);
+    }
+
+    // One more cycle when taken, and another one if the target is on a different page than the branch
+    const auto target = static_cast<uint16_t>(m_address + instruction.offset);
+    const bool page_crossed = (m_address & 0xFF00) != (target & 0xFF00);
+    ChargeCycles(instruction.cycles + 1 + (page_crossed ? 1 : 0));
+    ExitTo(static_cast<uint16_t>(target + instruction.size));
+
+    m_asm.Bind(not_taken);
+    ChargeCycles(instruction.cycles);
+    ExitTo(static_cast<uint16_t>(m_address + instruction.size));
+    return Result::Exited;
+  }
+
+  Result Emit(const CPU::Jump<AddressingMode::Absolute> &instruction) {
+    ChargeCycles(instruction.cycles);
+    ExitTo(instruction.address);
+    return Result::Exited;
+  }
+
+  Result Emit(const CPU::JumpToSubroutine &instruction) {
+    // The return address minus one, high byte first
+    const auto return_address = static_cast<uint16_t>(m_address + instruction.size - 1);
+    m_asm.Mov32Imm(R13, return_address >> 8);
+    Push();
+    m_asm.Mov32Imm(R13, return_address & 0xFF);
+    Push();
+    ChargeCycles(instruction.cycles);
+    ExitTo(instruction.address);
+    return Result::Exited;
+  }
+
+  Result Emit(const CPU::ReturnFromSubroutine &instruction) {
+    Pull();
+    m_asm.Mov32(R13, RAX);
+    Pull();
+    m_asm.Shift32Imm(ShiftOp::Shl, RAX, 8);
+    m_asm.Alu32(AluOp::Or, RAX, R13);
+    m_asm.Inc32(RAX);
+    m_asm.Store16(State(m_layout.program_counter), RAX);
+    ChargeCycles(instruction.cycles);
+    m_asm.Jump(m_exit);
+    return Result::Exited;
+  }
+};
+
+namespace {
+template <typename Object, typename Member> int32_t OffsetOf(const Object &object, const Member &member) {
+  return static_cast<int32_t>(reinterpret_cast<const char *>(std::addressof(member)) -
+                              reinterpret_cast<const char *>(std::addressof(object)));
+}
+} // namespace
+
+// The native code reads the page map directly
+static_assert(std::is_standard_layout_v<CodePageMap> && sizeof(CodePageMap) == 0x100);
+
+Dynarec::Dynarec(CPU &cpu, Bus &bus, size_t arena_size) : m_cpu{cpu} {
+  m_layout = {
+      .registers = {OffsetOf(cpu, cpu.m_registers[CPU::Register::A]), OffsetOf(cpu, cpu.m_registers[CPU::Register::X]),
+                    OffsetOf(cpu, cpu.m_registers[CPU::Register::Y])},
+      .flags = OffsetOf(cpu, cpu.m_flags),
+      .carry = OffsetOf(cpu, cpu.m_carry),
+      .overflow = OffsetOf(cpu, cpu.m_overflow),
+      .negative_result = OffsetOf(cpu, cpu.m_negative_result),
+      .zero_result = OffsetOf(cpu, cpu.m_zero_result),
+      .stack_pointer = OffsetOf(cpu, cpu.m_stack_pointer),
+      .program_counter = OffsetOf(cpu, cpu.m_program_counter),
+      .cycles = OffsetOf(cpu, cpu.m_cycles),
+      .pending_cycles = OffsetOf(cpu, cpu.m_pending_cycles),
+      .cycle_budget = OffsetOf(cpu, cpu.m_cycle_budget),
+      .read_pages = OffsetOf(bus, bus.m_read_pages),
+      .write_pages = OffsetOf(bus, bus.m_write_pages),
+      .code_pages = OffsetOf(bus, bus.m_code_pages),
+  };
+
+#if BNES_DYNAREC_SUPPORTED
+  void *arena = mmap(nullptr, arena_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (arena != MAP_FAILED) {
+    m_arena = static_cast<uint8_t *>(arena);
+    m_arena_size = arena_size;
+  }
+#else
+  (void)arena_size;
+#endif
+}
+
+Dynarec::~Dynarec() {
+#if BNES_DYNAREC_SUPPORTED
+  if (m_arena) {
+    munmap(m_arena, m_arena_size);
+  }
+#endif
+}
+
+ErrorOr<Dynarec::NativeBlock> Dynarec::Compile(std::span<const Instruction> instructions) {
+#if BNES_DYNAREC_SUPPORTED
+  if (!m_arena) {
+    return make_error(std::errc::not_enough_memory, "Could not map the dynarec arena");
+  }
+
+  Emitter emitter;
+  Translator translator{emitter, m_layout};
+
+  translator.Prologue();
+  for (size_t i = 0; i < instructions.size(); ++i) {
+    const auto &instruction = instructions[i];
+    if (!translator.Translate(m_cpu.DecodeInstruction(instruction.bytes), instruction.address,
+                              i + 1 == instructions.size())) {
+      return make_error(std::errc::not_supported, fmt::format("Can't translate opcode 0x{:02X} at 0x{:04X}",
+                                                              instruction.bytes[0], instruction.address));
+    }
+  }
+  translator.Finish();
+
+  if (m_used + emitter.Size() > m_arena_size) {
+    return make_error(std::errc::not_enough_memory, "Dynarec arena is full");
+  }
+
+  if (mprotect(m_arena, m_arena_size, PROT_READ | PROT_WRITE) != 0) {
+    return make_error(std::errc::permission_denied, "Could not make the dynarec arena writable");
+  }
+
+  uint8_t *code = m_arena + m_used;
+  std::memcpy(code, emitter.Code().data(), emitter.Size());
+  m_used += emitter.Size();
+
+  if (mprotect(m_arena, m_arena_size, PROT_READ | PROT_EXEC) != 0) {
+    return make_error(std::errc::permission_denied, "Could not make the dynarec arena executable");
+  }
+  __builtin___clear_cache(reinterpret_cast<char *>(code), reinterpret_cast<char *>(code + emitter.Size()));
+
+  ++m_stats.compiled_blocks;
+  m_stats.arena_bytes_used = m_used;
+
+  return reinterpret_cast<NativeBlock>(code);
+#else
+  (void)instructions;
+  return make_error(std::errc::not_supported, "The dynarec is only supported on x86-64");
+#endif
+}
+
+void Dynarec::Flush() {
+  m_used = 0;
+  m_stats.arena_bytes_used = 0;
+  ++m_stats.flushes;
+}
+
+bool Dynarec::Checkpoint(CPU &cpu, unsigned int pending_cycles) noexcept {
+  cpu.m_pending_cycles = pending_cycles;
+  cpu.FlushPendingCycles();
+  cpu.m_cycle_budget = cpu.m_bus->CyclesUntilNextEvent();
+  return !cpu.InterruptRequested();
+}
+
+unsigned int Dynarec::Read(Bus &bus, unsigned int address) noexcept { return bus.Read(address); }
+
+void Dynarec::Write(Bus &bus, unsigned int address, unsigned int value) noexcept {
+  bus.Write(address, static_cast<uint8_t>(value));
+}
+
+} // namespace BNES::HW
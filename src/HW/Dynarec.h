@@ -0,0 +1,106 @@
+//
+// Created by Valerio Formato on 17-Oct-26.
+//
+
+#ifndef BNES_DYNAREC_H
+#define BNES_DYNAREC_H
+
+#include "common/Types/Error.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#if defined(__x86_64__) && (defined(__linux__) || defined(__APPLE__))
+#define BNES_DYNAREC_SUPPORTED 1
+#else
+#define BNES_DYNAREC_SUPPORTED 0
+#endif
+
+namespace BNES::HW {
+
+class CPU;
+class Bus;
+
+struct DynarecStats {
+  size_t compiled_blocks{0};
+  size_t flushes{0};
+  size_t arena_bytes_used{0};
+};
+
+// Translates basic blocks of 6502 code into x86-64 code, stored in an mmap'd arena that is writable only while code is
+// being emitted and executable otherwise.
+// The native code works on the CPU state in place (rbx points to the CPU, rbp to the bus) and reads and writes memory
+// through the same page tables as Bus::Read/Write, calling into the bus when the fast path doesn't apply. Cycles are
+// charged after every instruction exactly like the block interpreter does, ticking the bus through a checkpoint once
+// the next PPU event is reached and leaving the block if an interrupt has to be serviced.
+// Only the instructions that can't touch anything but RAM and ROM, can't write outside of RAM and don't change the
+// interrupt flag are translated. Blocks with anything else are left to the interpreter.
+class Dynarec {
+public:
+  using NativeBlock = void (*)(CPU &, Bus &);
+
+  struct Instruction {
+    uint16_t address;
+    std::array<uint8_t, 3> bytes;
+  };
+
+  static constexpr size_t DefaultArenaSize{1 << 20};
+
+  Dynarec(CPU &cpu, Bus &bus, size_t arena_size = DefaultArenaSize);
+  ~Dynarec();
+
+  Dynarec(const Dynarec &) = delete;
+  Dynarec &operator=(const Dynarec &) = delete;
+
+  [[nodiscard]] static constexpr bool IsSupported() { return BNES_DYNAREC_SUPPORTED; }
+
+  // Fails with std::errc::not_supported if the block has an instruction we don't translate, and with
+  // std::errc::not_enough_memory if the arena is full (flush and try again)
+  [[nodiscard]] ErrorOr<NativeBlock> Compile(std::span<const Instruction> instructions);
+
+  // Drops all the generated code. Any NativeBlock handed out before is invalid after this.
+  void Flush();
+
+  [[nodiscard]] const DynarecStats &GetStats() const { return m_stats; }
+
+private:
+  // Where the native code finds the CPU and bus state, as offsets from the CPU and the bus respectively
+  struct Layout {
+    std::array<int32_t, 3> registers;
+    int32_t flags;
+    int32_t carry;
+    int32_t overflow;
+    int32_t negative_result;
+    int32_t zero_result;
+    int32_t stack_pointer;
+    int32_t program_counter;
+    int32_t cycles;
+    int32_t pending_cycles;
+    int32_t cycle_budget;
+
+    int32_t read_pages;
+    int32_t write_pages;
+    int32_t code_pages;
+  };
+
+  class Translator;
+
+  CPU &m_cpu;
+  Layout m_layout{};
+
+  uint8_t *m_arena{nullptr};
+  size_t m_arena_size{0};
+  size_t m_used{0};
+
+  DynarecStats m_stats{};
+
+  // Called from the native code
+  static bool Checkpoint(CPU &cpu, unsigned int pending_cycles) noexcept;
+  static unsigned int Read(Bus &bus, unsigned int address) noexcept;
+  static void Write(Bus &bus, unsigned int address, unsigned int value) noexcept;
+};
+} // namespace BNES::HW
+
+#endif // BNES_DYNAREC_H
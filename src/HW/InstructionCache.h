@@ -0,0 +1,134 @@
+//
+// Created by Valerio Formato on 17-Oct-26.
+//
+
+#ifndef BNES_INSTRUCTIONCACHE_H
+#define BNES_INSTRUCTIONCACHE_H
+
+#include <algorithm>
+#include "HW/CodePageMap.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+
+namespace BNES::HW {
+
+struct InstructionCacheStats {
+  size_t hits{0};
+  size_t misses{0};
+  size_t invalidations{0};
+  size_t flushes{0};
+};
+
+// Caches decoded instructions by the address they were fetched from, so that code which is executed over and over
+// (i.e. pretty much all of it) only goes through the bus and the decoder once.
+// Only internal RAM ($0000-$1FFF, folded onto its 2KB of physical memory) and the cartridge space ($6000-$FFFF) are
+// cached. Code running from RAM can be modified at any time, so every write to a cached address must go through
+// Invalidate(). The pages holding cached instructions are marked in a CodePageMap, if one is given, so that writes
+// anywhere else can skip that.
+template <typename ENTRY> class InstructionCache {
+public:
+  using Addr = std::uint16_t;
+
+  void TrackCodePages(CodePageMap &code_pages, uint8_t owner) {
+    m_code_pages = &code_pages;
+    m_owner = owner;
+  }
+
+  [[nodiscard]] static constexpr bool IsCacheable(Addr address) { return address < 0x2000 || address >= 0x6000; }
+
+  // Returns the cached entry for the given address, or nullptr (and counts a miss) if there's none
+  [[nodiscard]] const ENTRY *Find(Addr address) {
+    const auto slot = Slot(address);
+    if (const auto &page = m_pages[slot >> 8]; page && (*page)[slot & 0xFF]) {
+      ++m_stats.hits;
+      return &*(*page)[slot & 0xFF];
+    }
+
+    ++m_stats.misses;
+    return nullptr;
+  }
+
+  // Stores a new entry for the given address. The address must be cacheable.
+  const ENTRY &Insert(Addr address, ENTRY entry) {
+    const auto slot = Slot(address);
+    auto &page = m_pages[slot >> 8];
+    if (!page) {
+      page = std::make_unique<Page>();
+    }
+    if (m_code_pages) {
+      // The operands might be on the next page
+      m_code_pages->Mark(m_owner, address);
+      m_code_pages->Mark(m_owner, static_cast<Addr>(address < 0x2000 ? (slot + 2) & 0x7FF : address + 2));
+    }
+
+    return (*page)[slot & 0xFF].emplace(std::move(entry));
+  }
+
+  // Drops all the entries that could include the byte at the given address. Instructions are at most 3 bytes long,
+  // so a write can affect instructions starting up to two bytes before it. In RAM that is counted on the 2KB of
+  // physical memory: an instruction at $07FF has its operands at $0000 and $0001.
+  void Invalidate(Addr address) {
+    const bool ram = address < 0x2000;
+    for (Addr offset = 0; offset < 3; ++offset) {
+      const Addr start = ram ? ((address & 0x7FF) - offset) & 0x7FF : address - offset;
+      if (!IsCacheable(start)) {
+        continue;
+      }
+
+      const auto slot = Slot(start);
+      if (auto &page = m_pages[slot >> 8]; page && (*page)[slot & 0xFF]) {
+        (*page)[slot & 0xFF].reset();
+        ++m_stats.invalidations;
+      }
+    }
+  }
+
+  // Drops all the entries that could include bytes of the pages from `first` to `last`, e.g. when a PRG bank is
+  // switched. The range must start and end on page boundaries.
+  void InvalidatePages(Addr first, Addr last) {
+    // Instructions from the page before could still have their operands in the first page
+    Invalidate(first);
+
+    for (unsigned int page = Slot(first) >> 8; page <= static_cast<unsigned int>(Slot(last) >> 8); ++page) {
+      if (auto &entries = m_pages[page]) {
+        m_stats.invalidations += std::ranges::count_if(*entries, [](const auto &entry) { return entry.has_value(); });
+        entries.reset();
+      }
+      if (m_code_pages) {
+        m_code_pages->Unmark(m_owner, static_cast<Addr>(page << 8));
+      }
+    }
+  }
+
+  // Drops everything, e.g. when a new program is loaded
+  void Flush() {
+    for (auto &page : m_pages) {
+      page.reset();
+    }
+    if (m_code_pages) {
+      m_code_pages->UnmarkAll(m_owner);
+    }
+    ++m_stats.flushes;
+  }
+
+  [[nodiscard]] const InstructionCacheStats &GetStats() const { return m_stats; }
+
+private:
+  using Page = std::array<std::optional<ENTRY>, 256>;
+
+  // RAM mirrors all map onto the same slots
+  static constexpr Addr Slot(Addr address) { return address < 0x2000 ? address & 0x7FF : address; }
+
+  // Pages are allocated lazily, only the ones that actually contain code end up in memory
+  std::array<std::unique_ptr<Page>, 256> m_pages{};
+  CodePageMap *m_code_pages{nullptr};
+  uint8_t m_owner{0};
+  InstructionCacheStats m_stats{};
+};
+} // namespace BNES::HW
+
+#endif // BNES_INSTRUCTIONCACHE_H
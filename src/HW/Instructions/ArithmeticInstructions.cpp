@@ -37,9 +37,9 @@ template <AddressingMode MODE> void CPU::AddWithCarry<MODE>::Apply(CPU &cpu) con
   if constexpr (MODE == AddressingMode::Immediate) {
     value_to_add = value & 0xFF;
   } else if constexpr (MODE == AddressingMode::ZeroPage) {
-    value_to_add = cpu.ReadFromMemory(value & 0xFF);
+    value_to_add = cpu.ReadZeroPage(value);
   } else if constexpr (MODE == AddressingMode::ZeroPageX) {
-    value_to_add = cpu.ReadFromMemory((value + cpu.m_registers[Register::X]) & 0xFF);
+    value_to_add = cpu.ReadZeroPage(value + cpu.m_registers[Register::X]);
   } else if constexpr (MODE == AddressingMode::Absolute) {
     value_to_add = cpu.ReadFromMemory(value);
   } else if constexpr (MODE == AddressingMode::AbsoluteX) {
@@ -49,12 +49,12 @@ template <AddressingMode MODE> void CPU::AddWithCarry<MODE>::Apply(CPU &cpu) con
   } else if constexpr (MODE == AddressingMode::IndirectX) {
     Addr target_addr_low = (value + cpu.m_registers[Register::X]) & 0xFF;
     Addr target_addr_high = (value + cpu.m_registers[Register::X] + 1) & 0xFF;
-    Addr real_addr = cpu.ReadFromMemory(target_addr_high) << 8 | cpu.ReadFromMemory(target_addr_low);
+    Addr real_addr = cpu.ReadZeroPage(target_addr_high) << 8 | cpu.ReadZeroPage(target_addr_low);
     value_to_add = cpu.ReadFromMemory(real_addr);
   } else if constexpr (MODE == AddressingMode::IndirectY) {
     Addr target_addr_low = value & 0xFF;
     Addr target_addr_high = (value + 1) & 0xFF;
-    Addr real_addr = cpu.ReadFromMemory(target_addr_high) << 8 | cpu.ReadFromMemory(target_addr_low);
+    Addr real_addr = cpu.ReadZeroPage(target_addr_high) << 8 | cpu.ReadZeroPage(target_addr_low);
     value_to_add = cpu.ReadFromMemory(real_addr + cpu.m_registers[Register::Y]);
   } else {
     TODO(fmt::format("AddWithCarry<{}>::Apply not implemented", magic_enum::enum_name(MODE)));
@@ -68,8 +68,7 @@ template <AddressingMode MODE> void CPU::AddWithCarry<MODE>::Apply(CPU &cpu) con
 
   cpu.m_registers[Register::A] = result;
 
-  cpu.SetStatusFlagValue(StatusFlag::Negative, cpu.m_registers[Register::A] & 0x80);
-  cpu.SetStatusFlagValue(StatusFlag::Zero, cpu.m_registers[Register::A] == 0);
+  cpu.SetZeroAndNegative(cpu.m_registers[Register::A]);
   cpu.SetStatusFlagValue(StatusFlag::Carry, intermediate_result & 0x100);
   cpu.SetStatusFlagValue(StatusFlag::Overflow, ((M ^ result) & (N ^ result) & 0x80) != 0);
 }
@@ -108,9 +107,9 @@ template <AddressingMode MODE> void CPU::SubtractWithCarry<MODE>::Apply(CPU &cpu
   if constexpr (MODE == AddressingMode::Immediate) {
     value_to_add = value & 0xFF;
   } else if constexpr (MODE == AddressingMode::ZeroPage) {
-    value_to_add = cpu.ReadFromMemory(value & 0xFF);
+    value_to_add = cpu.ReadZeroPage(value);
   } else if constexpr (MODE == AddressingMode::ZeroPageX) {
-    value_to_add = cpu.ReadFromMemory((value + cpu.m_registers[Register::X]) & 0xFF);
+    value_to_add = cpu.ReadZeroPage(value + cpu.m_registers[Register::X]);
   } else if constexpr (MODE == AddressingMode::Absolute) {
     value_to_add = cpu.ReadFromMemory(value);
   } else if constexpr (MODE == AddressingMode::AbsoluteX) {
@@ -120,12 +119,12 @@ template <AddressingMode MODE> void CPU::SubtractWithCarry<MODE>::Apply(CPU &cpu
   } else if constexpr (MODE == AddressingMode::IndirectX) {
     Addr target_addr_low = (value + cpu.m_registers[Register::X]) & 0xFF;
     Addr target_addr_high = (value + cpu.m_registers[Register::X] + 1) & 0xFF;
-    Addr real_addr = cpu.ReadFromMemory(target_addr_high) << 8 | cpu.ReadFromMemory(target_addr_low);
+    Addr real_addr = cpu.ReadZeroPage(target_addr_high) << 8 | cpu.ReadZeroPage(target_addr_low);
     value_to_add = cpu.ReadFromMemory(real_addr);
   } else if constexpr (MODE == AddressingMode::IndirectY) {
     Addr target_addr_low = value & 0xFF;
     Addr target_addr_high = (value + 1) & 0xFF;
-    Addr real_addr = cpu.ReadFromMemory(target_addr_high) << 8 | cpu.ReadFromMemory(target_addr_low);
+    Addr real_addr = cpu.ReadZeroPage(target_addr_high) << 8 | cpu.ReadZeroPage(target_addr_low);
     value_to_add = cpu.ReadFromMemory(real_addr + cpu.m_registers[Register::Y]);
   } else {
     TODO(fmt::format("SubtractWithCarry<{}>::Apply not implemented", magic_enum::enum_name(MODE)));
@@ -140,8 +139,7 @@ template <AddressingMode MODE> void CPU::SubtractWithCarry<MODE>::Apply(CPU &cpu
 
   cpu.m_registers[Register::A] = result;
 
-  cpu.SetStatusFlagValue(StatusFlag::Negative, cpu.m_registers[Register::A] & 0x80);
-  cpu.SetStatusFlagValue(StatusFlag::Zero, cpu.m_registers[Register::A] == 0);
+  cpu.SetZeroAndNegative(cpu.m_registers[Register::A]);
   cpu.SetStatusFlagValue(StatusFlag::Carry, !(intermediate_result & 0x100));
   cpu.SetStatusFlagValue(StatusFlag::Overflow, ((M ^ result) & (N ^ result) & 0x80) != 0);
 }
@@ -152,8 +150,7 @@ template <AddressingMode MODE> void CPU::SubtractWithCarry<MODE>::Apply(CPU &cpu
 
 template <CPU::Register REG> void CPU::IncrementRegister<REG>::Apply(CPU &cpu) const {
   cpu.m_registers[REG] += 1;
-  cpu.SetStatusFlagValue(StatusFlag::Zero, cpu.m_registers[REG] == 0);
-  cpu.SetStatusFlagValue(StatusFlag::Negative, cpu.m_registers[REG] & 0x80);
+  cpu.SetZeroAndNegative(cpu.m_registers[REG]);
 }
 
 // ===========================================================================================
@@ -162,8 +159,7 @@ template <CPU::Register REG> void CPU::IncrementRegister<REG>::Apply(CPU &cpu) c
 
 template <CPU::Register REG> void CPU::DecrementRegister<REG>::Apply(CPU &cpu) const {
   cpu.m_registers[REG] -= 1;
-  cpu.SetStatusFlagValue(StatusFlag::Zero, cpu.m_registers[REG] == 0);
-  cpu.SetStatusFlagValue(StatusFlag::Negative, cpu.m_registers[REG] & 0x80);
+  cpu.SetZeroAndNegative(cpu.m_registers[REG]);
 }
 
 // ===========================================================================================
@@ -193,11 +189,11 @@ template <AddressingMode MODE> CPU::Increment<MODE>::Increment(uint16_t addr) {
 template <AddressingMode MODE> void CPU::Increment<MODE>::Apply(CPU &cpu) const {
   uint8_t value_to_write = 0;
   if constexpr (MODE == AddressingMode::ZeroPage) {
-    value_to_write = cpu.ReadFromMemory(address & 0xFF) + 1;
-    cpu.WriteToMemory(address & 0xFF, value_to_write);
+    value_to_write = cpu.ReadZeroPage(address) + 1;
+    cpu.WriteZeroPage(address, value_to_write);
   } else if constexpr (MODE == AddressingMode::ZeroPageX) {
-    value_to_write = cpu.ReadFromMemory((address + cpu.m_registers[Register::X]) & 0xFF) + 1;
-    cpu.WriteToMemory((address + cpu.m_registers[Register::X]) & 0xFF, value_to_write);
+    value_to_write = cpu.ReadZeroPage(address + cpu.m_registers[Register::X]) + 1;
+    cpu.WriteZeroPage(address + cpu.m_registers[Register::X], value_to_write);
   } else if constexpr (MODE == AddressingMode::Absolute) {
     value_to_write = cpu.ReadFromMemory(address) + 1;
     cpu.WriteToMemory(address, value_to_write);
@@ -208,8 +204,7 @@ template <AddressingMode MODE> void CPU::Increment<MODE>::Apply(CPU &cpu) const
     TODO(fmt::format("Increment<{}>::Apply not implemented", magic_enum::enum_name(MODE)));
   }
 
-  cpu.SetStatusFlagValue(StatusFlag::Zero, value_to_write == 0);
-  cpu.SetStatusFlagValue(StatusFlag::Negative, value_to_write & 0x80);
+  cpu.SetZeroAndNegative(value_to_write);
 }
 
 // ===========================================================================================
@@ -239,11 +234,11 @@ template <AddressingMode MODE> CPU::Decrement<MODE>::Decrement(uint16_t addr) {
 template <AddressingMode MODE> void CPU::Decrement<MODE>::Apply(CPU &cpu) const {
   uint8_t value_to_write = 0;
   if constexpr (MODE == AddressingMode::ZeroPage) {
-    value_to_write = cpu.ReadFromMemory(address & 0xFF) - 1;
-    cpu.WriteToMemory(address & 0xFF, value_to_write);
+    value_to_write = cpu.ReadZeroPage(address) - 1;
+    cpu.WriteZeroPage(address, value_to_write);
   } else if constexpr (MODE == AddressingMode::ZeroPageX) {
-    value_to_write = cpu.ReadFromMemory((address + cpu.m_registers[Register::X]) & 0xFF) - 1;
-    cpu.WriteToMemory((address + cpu.m_registers[Register::X]) & 0xFF, value_to_write);
+    value_to_write = cpu.ReadZeroPage(address + cpu.m_registers[Register::X]) - 1;
+    cpu.WriteZeroPage(address + cpu.m_registers[Register::X], value_to_write);
   } else if constexpr (MODE == AddressingMode::Absolute) {
     value_to_write = cpu.ReadFromMemory(address) - 1;
     cpu.WriteToMemory(address, value_to_write);
@@ -254,8 +249,7 @@ template <AddressingMode MODE> void CPU::Decrement<MODE>::Apply(CPU &cpu) const
     TODO(fmt::format("Decrement<{}>::Apply not implemented", magic_enum::enum_name(MODE)));
   }
 
-  cpu.SetStatusFlagValue(StatusFlag::Zero, value_to_write == 0);
-  cpu.SetStatusFlagValue(StatusFlag::Negative, value_to_write & 0x80);
+  cpu.SetZeroAndNegative(value_to_write);
 }
 
 // ===========================================================================================
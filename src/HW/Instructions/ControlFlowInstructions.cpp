@@ -87,14 +87,11 @@ template <Conditional COND> void CPU::Branch<COND>::Apply(CPU &cpu) {
 
 void CPU::Break::Apply([[maybe_unused]] CPU &cpu) const {
   // Push program counter (high byte first, then low byte)
-  cpu.WriteToMemory(StackBaseAddress + cpu.m_stack_pointer, (cpu.m_program_counter >> 8) & 0xFF);
-  cpu.m_stack_pointer--;
-  cpu.WriteToMemory(StackBaseAddress + cpu.m_stack_pointer, cpu.m_program_counter & 0xFF);
-  cpu.m_stack_pointer--;
+  cpu.PushToStack((cpu.m_program_counter >> 8) & 0xFF);
+  cpu.PushToStack(cpu.m_program_counter & 0xFF);
 
   // Push status register
-  cpu.WriteToMemory(StackBaseAddress + cpu.m_stack_pointer, cpu.m_status.to_ulong());
-  cpu.m_stack_pointer--;
+  cpu.PushToStack(cpu.StatusWord());
 
   cpu.SetStatusFlagValue(StatusFlag::InterruptDisable, true);
 
@@ -112,10 +109,8 @@ void CPU::JumpToSubroutine::Apply(CPU &cpu) const {
 
   // Push the return address (address of the next instruction - 1) onto the stack
   uint16_t return_address = cpu.m_program_counter + size - 1;
-  cpu.WriteToMemory(StackBaseAddress + cpu.m_stack_pointer, (return_address >> 8) & 0xFF); // Push high byte
-  cpu.m_stack_pointer--;
-  cpu.WriteToMemory(StackBaseAddress + cpu.m_stack_pointer, return_address & 0xFF); // Push low byte
-  cpu.m_stack_pointer--;
+  cpu.PushToStack((return_address >> 8) & 0xFF); // Push high byte
+  cpu.PushToStack(return_address & 0xFF);        // Push low byte
 
   // Jump to the target address
   cpu.m_program_counter = target_address;
@@ -125,10 +120,8 @@ void CPU::ReturnFromSubroutine::Apply(CPU &cpu) const {
   // See https://www.nesdev.org/obelisk-6502-guide/reference.html#RTS
 
   // Pull the return address from the stack
-  cpu.m_stack_pointer++;
-  uint8_t low_byte = cpu.ReadFromMemory(StackBaseAddress + cpu.m_stack_pointer);
-  cpu.m_stack_pointer++;
-  uint8_t high_byte = cpu.ReadFromMemory(StackBaseAddress + cpu.m_stack_pointer);
+  uint8_t low_byte = cpu.PullFromStack();
+  uint8_t high_byte = cpu.PullFromStack();
 
   uint16_t return_address = (high_byte << 8) | low_byte;
 
@@ -140,13 +133,10 @@ void CPU::ReturnFromInterrupt::Apply(CPU &cpu) const {
   // See https://www.nesdev.org/obelisk-6502-guide/reference.html#RTI
 
   // Pull the status word from the stack
-  cpu.m_stack_pointer++;
-  cpu.m_status = (cpu.ReadFromMemory(StackBaseAddress + cpu.m_stack_pointer) & 0xEF) | 0x20;
+  cpu.SetStatusWord((cpu.PullFromStack() & 0xEF) | 0x20);
   // Pull the program counter from the stack
-  cpu.m_stack_pointer++;
-  uint8_t low_byte = cpu.ReadFromMemory(StackBaseAddress + cpu.m_stack_pointer);
-  cpu.m_stack_pointer++;
-  uint8_t high_byte = cpu.ReadFromMemory(StackBaseAddress + cpu.m_stack_pointer);
+  uint8_t low_byte = cpu.PullFromStack();
+  uint8_t high_byte = cpu.PullFromStack();
 
   uint16_t return_address = (high_byte << 8) | low_byte;
 
@@ -159,27 +149,22 @@ void CPU::ReturnFromInterrupt::Apply(CPU &cpu) const {
 // ===========================================================================================
 
 void CPU::PushAccumulator::Apply(CPU &cpu) const {
-  cpu.WriteToMemory(StackBaseAddress + cpu.m_stack_pointer, cpu.m_registers[Register::A]);
-  cpu.m_stack_pointer--;
+  cpu.PushToStack(cpu.m_registers[Register::A]);
 }
 
 void CPU::PullAccumulator::Apply(CPU &cpu) const {
-  cpu.m_stack_pointer++;
-  cpu.m_registers[Register::A] = cpu.ReadFromMemory(StackBaseAddress + cpu.m_stack_pointer);
+  cpu.m_registers[Register::A] = cpu.PullFromStack();
 
-  cpu.SetStatusFlagValue(StatusFlag::Zero, cpu.m_registers[Register::A] == 0);
-  cpu.SetStatusFlagValue(StatusFlag::Negative, (cpu.m_registers[Register::A] & 0x80) != 0);
+  cpu.SetZeroAndNegative(cpu.m_registers[Register::A]);
 }
 
 void CPU::PushStatusRegister::Apply(CPU &cpu) const {
-  uint8_t status_word = cpu.m_status.to_ulong() | 0x30;
-  cpu.WriteToMemory(StackBaseAddress + cpu.m_stack_pointer, status_word);
-  cpu.m_stack_pointer--;
+  uint8_t status_word = cpu.StatusWord() | 0x30;
+  cpu.PushToStack(status_word);
 }
 
 void CPU::PullStatusRegister::Apply(CPU &cpu) const {
-  cpu.m_stack_pointer++;
-  cpu.m_status = (cpu.ReadFromMemory(StackBaseAddress + cpu.m_stack_pointer) & 0xEF) | 0x20;
+  cpu.SetStatusWord((cpu.PullFromStack() & 0xEF) | 0x20);
 
   // TODO: Note that the effect of changing I is delayed one instruction because the flag is changed after IRQ is
   //       polled, delaying the effect until IRQ is polled in the next instruction like with CLI and SEI.
@@ -38,19 +38,19 @@ template <CPU::Register REG, AddressingMode MODE> void CPU::LoadRegister<REG, MO
   } else if constexpr (MODE == AddressingMode::ZeroPage) {
     // Zero page addressing means the memory address is in the range 0x00 to 0xFF.
     Addr addr = value & 0xFF;
-    cpu.m_registers[REG] = cpu.ReadFromMemory(addr);
+    cpu.m_registers[REG] = cpu.ReadOperand<MODE>(addr);
   } else if constexpr (MODE == AddressingMode::ZeroPageX) {
     // Zero page addressing with X offset means the memory address is in the range 0x00 to 0xFF, and the X register
     // is added to the zero page address.
     // If the result exceeds 0xFF, it wraps around to 0x00.
     Addr addr = (value + cpu.m_registers[Register::X]) & 0xFF;
-    cpu.m_registers[REG] = cpu.ReadFromMemory(addr);
+    cpu.m_registers[REG] = cpu.ReadOperand<MODE>(addr);
   } else if constexpr (MODE == AddressingMode::ZeroPageY) {
     // Zero page addressing with Y offset means the memory address is in the range 0x00 to 0xFF, and the Y register
     // is added to the zero page address.
     // If the result exceeds 0xFF, it wraps around to 0x00.
     Addr addr = (value + cpu.m_registers[Register::Y]) & 0xFF;
-    cpu.m_registers[REG] = cpu.ReadFromMemory(addr);
+    cpu.m_registers[REG] = cpu.ReadOperand<MODE>(addr);
   } else if constexpr (MODE == AddressingMode::Absolute) {
     // Absolute addressing means the memory address is a full 16-bit address (in LE enconding).
     cpu.m_registers[REG] = cpu.ReadFromMemory(value);
@@ -58,12 +58,12 @@ template <CPU::Register REG, AddressingMode MODE> void CPU::LoadRegister<REG, MO
     // Indexed absolute addressing means the memory address is a full 16-bit address (in LE enconding) and the X
     // register is added to the zero page address.
     Addr addr = value + cpu.m_registers[Register::X];
-    cpu.m_registers[REG] = cpu.ReadFromMemory(addr);
+    cpu.m_registers[REG] = cpu.ReadOperand<MODE>(addr);
   } else if constexpr (MODE == AddressingMode::AbsoluteY) {
     // Indexed absolute addressing means the memory address is a full 16-bit address (in LE enconding) and the X
     // register is added to the zero page address.
     Addr addr = value + cpu.m_registers[Register::Y];
-    cpu.m_registers[REG] = cpu.ReadFromMemory(addr);
+    cpu.m_registers[REG] = cpu.ReadOperand<MODE>(addr);
   } else if constexpr (MODE == AddressingMode::IndirectX) {
     // Indexed indirect addressing is normally used in conjunction with a table of address held on zero page. The
     // address of the table is taken from the instruction and the X register added to it (with zero page wrap around) to
@@ -71,7 +71,7 @@ template <CPU::Register REG, AddressingMode MODE> void CPU::LoadRegister<REG, MO
 
     Addr target_addr_low = (value + cpu.m_registers[Register::X]) & 0xFF;
     Addr target_addr_high = (value + cpu.m_registers[Register::X] + 1) & 0xFF;
-    Addr real_addr = cpu.ReadFromMemory(target_addr_high) << 8 | cpu.ReadFromMemory(target_addr_low);
+    Addr real_addr = cpu.ReadZeroPage(target_addr_high) << 8 | cpu.ReadZeroPage(target_addr_low);
     cpu.m_registers[REG] = cpu.ReadFromMemory(real_addr);
   } else if constexpr (MODE == AddressingMode::IndirectY) {
     // Indirect indexed addressing is the most common indirection mode used on the 6502. In instruction contains the
@@ -80,15 +80,14 @@ template <CPU::Register REG, AddressingMode MODE> void CPU::LoadRegister<REG, MO
 
     Addr target_addr_low = value & 0xFF;
     Addr target_addr_high = (value + 1) & 0xFF;
-    Addr real_addr = cpu.ReadFromMemory(target_addr_high) << 8 | cpu.ReadFromMemory(target_addr_low);
+    Addr real_addr = cpu.ReadZeroPage(target_addr_high) << 8 | cpu.ReadZeroPage(target_addr_low);
     cpu.m_registers[REG] = cpu.ReadFromMemory(real_addr + cpu.m_registers[Register::Y]);
   } else {
     TODO(fmt::format("LoadRegister<{},{}>::Apply not implemented", magic_enum::enum_name(REG),
                      magic_enum::enum_name(MODE)));
   }
 
-  cpu.SetStatusFlagValue(StatusFlag::Zero, cpu.m_registers[REG] == 0);
-  cpu.SetStatusFlagValue(StatusFlag::Negative, cpu.m_registers[REG] & 0x80);
+  cpu.SetZeroAndNegative(cpu.m_registers[REG]);
 }
 
 // ===========================================================================================
@@ -118,37 +117,36 @@ CPU::LoadAccumulatorAndX<MODE>::LoadAccumulatorAndX(uint16_t _value) : DecodedIn
 template <AddressingMode MODE> void CPU::LoadAccumulatorAndX<MODE>::Apply(CPU &cpu) const {
   if constexpr (MODE == AddressingMode::ZeroPage) {
     Addr addr = value & 0xFF;
-    uint8_t mem_value = cpu.ReadFromMemory(addr);
+    uint8_t mem_value = cpu.ReadOperand<MODE>(addr);
     cpu.m_registers[Register::A] = cpu.m_registers[Register::X] = mem_value;
   } else if constexpr (MODE == AddressingMode::ZeroPageY) {
     Addr addr = (value + cpu.m_registers[Register::Y]) & 0xFF;
-    uint8_t mem_value = cpu.ReadFromMemory(addr);
+    uint8_t mem_value = cpu.ReadOperand<MODE>(addr);
     cpu.m_registers[Register::A] = cpu.m_registers[Register::X] = mem_value;
   } else if constexpr (MODE == AddressingMode::Absolute) {
     uint8_t mem_value = cpu.ReadFromMemory(value);
     cpu.m_registers[Register::A] = cpu.m_registers[Register::X] = mem_value;
   } else if constexpr (MODE == AddressingMode::AbsoluteY) {
     Addr addr = value + cpu.m_registers[Register::Y];
-    uint8_t mem_value = cpu.ReadFromMemory(addr);
+    uint8_t mem_value = cpu.ReadOperand<MODE>(addr);
     cpu.m_registers[Register::A] = cpu.m_registers[Register::X] = mem_value;
   } else if constexpr (MODE == AddressingMode::IndirectX) {
     Addr target_addr_low = (value + cpu.m_registers[Register::X]) & 0xFF;
     Addr target_addr_high = (value + cpu.m_registers[Register::X] + 1) & 0xFF;
-    Addr real_addr = cpu.ReadFromMemory(target_addr_high) << 8 | cpu.ReadFromMemory(target_addr_low);
+    Addr real_addr = cpu.ReadZeroPage(target_addr_high) << 8 | cpu.ReadZeroPage(target_addr_low);
     uint8_t mem_value = cpu.ReadFromMemory(real_addr);
     cpu.m_registers[Register::A] = cpu.m_registers[Register::X] = mem_value;
   } else if constexpr (MODE == AddressingMode::IndirectY) {
     Addr target_addr_low = value & 0xFF;
     Addr target_addr_high = (value + 1) & 0xFF;
-    Addr real_addr = cpu.ReadFromMemory(target_addr_high) << 8 | cpu.ReadFromMemory(target_addr_low);
+    Addr real_addr = cpu.ReadZeroPage(target_addr_high) << 8 | cpu.ReadZeroPage(target_addr_low);
     uint8_t mem_value = cpu.ReadFromMemory(real_addr + cpu.m_registers[Register::Y]);
     cpu.m_registers[Register::A] = cpu.m_registers[Register::X] = mem_value;
   } else {
     TODO(fmt::format("LoadAccumulatorAndX<{}>::Apply not implemented", magic_enum::enum_name(MODE)));
   }
 
-  cpu.SetStatusFlagValue(StatusFlag::Zero, cpu.m_registers[Register::A] == 0);
-  cpu.SetStatusFlagValue(StatusFlag::Negative, cpu.m_registers[Register::A] & 0x80);
+  cpu.SetZeroAndNegative(cpu.m_registers[Register::A]);
 }
 
 // ===========================================================================================
@@ -178,30 +176,30 @@ template <CPU::Register REG, AddressingMode MODE> CPU::StoreRegister<REG, MODE>:
 template <CPU::Register REG, AddressingMode MODE> void CPU::StoreRegister<REG, MODE>::Apply(CPU &cpu) const {
   if constexpr (MODE == AddressingMode::ZeroPage) {
     Addr addr = address & 0xFF;
-    cpu.WriteToMemory(addr, cpu.m_registers[REG]);
+    cpu.WriteOperand<MODE>(addr, cpu.m_registers[REG]);
   } else if constexpr (MODE == AddressingMode::ZeroPageX) {
     Addr addr = (address + cpu.m_registers[Register::X]) & 0xFF;
-    cpu.WriteToMemory(addr, cpu.m_registers[REG]);
+    cpu.WriteOperand<MODE>(addr, cpu.m_registers[REG]);
   } else if constexpr (MODE == AddressingMode::ZeroPageY) {
     Addr addr = (address + cpu.m_registers[Register::Y]) & 0xFF;
-    cpu.WriteToMemory(addr, cpu.m_registers[REG]);
+    cpu.WriteOperand<MODE>(addr, cpu.m_registers[REG]);
   } else if constexpr (MODE == AddressingMode::Absolute) {
     cpu.WriteToMemory(address, cpu.m_registers[REG]);
   } else if constexpr (MODE == AddressingMode::AbsoluteX) {
     Addr addr = address + cpu.m_registers[Register::X];
-    cpu.WriteToMemory(addr, cpu.m_registers[REG]);
+    cpu.WriteOperand<MODE>(addr, cpu.m_registers[REG]);
   } else if constexpr (MODE == AddressingMode::AbsoluteY) {
     Addr addr = address + cpu.m_registers[Register::Y];
-    cpu.WriteToMemory(addr, cpu.m_registers[REG]);
+    cpu.WriteOperand<MODE>(addr, cpu.m_registers[REG]);
   } else if constexpr (MODE == AddressingMode::IndirectX) {
     Addr target_addr_low = (address + cpu.m_registers[Register::X]) & 0xFF;
     Addr target_addr_high = (address + cpu.m_registers[Register::X] + 1) & 0xFF;
-    Addr real_addr = cpu.ReadFromMemory(target_addr_high) << 8 | cpu.ReadFromMemory(target_addr_low);
+    Addr real_addr = cpu.ReadZeroPage(target_addr_high) << 8 | cpu.ReadZeroPage(target_addr_low);
     cpu.WriteToMemory(real_addr, cpu.m_registers[REG]);
   } else if constexpr (MODE == AddressingMode::IndirectY) {
     Addr target_addr_low = address & 0xFF;
     Addr target_addr_high = (address + 1) & 0xFF;
-    Addr real_addr = cpu.ReadFromMemory(target_addr_high) << 8 | cpu.ReadFromMemory(target_addr_low);
+    Addr real_addr = cpu.ReadZeroPage(target_addr_high) << 8 | cpu.ReadZeroPage(target_addr_low);
     cpu.WriteToMemory(real_addr + cpu.m_registers[Register::Y], cpu.m_registers[REG]);
   } else {
     TODO(fmt::format("StoreRegister<{},{}>::Apply not implemented", magic_enum::enum_name(REG),
@@ -234,16 +232,16 @@ CPU::StoreAccumulatorAndX<MODE>::StoreAccumulatorAndX(uint16_t addr) : DecodedIn
 template <AddressingMode MODE> void CPU::StoreAccumulatorAndX<MODE>::Apply(CPU &cpu) const {
   if constexpr (MODE == AddressingMode::ZeroPage) {
     Addr addr = address & 0xFF;
-    cpu.WriteToMemory(addr, cpu.m_registers[Register::X] & cpu.m_registers[Register::A]);
+    cpu.WriteOperand<MODE>(addr, cpu.m_registers[Register::X] & cpu.m_registers[Register::A]);
   } else if constexpr (MODE == AddressingMode::ZeroPageY) {
     Addr addr = (address + cpu.m_registers[Register::Y]) & 0xFF;
-    cpu.WriteToMemory(addr, cpu.m_registers[Register::X] & cpu.m_registers[Register::A]);
+    cpu.WriteOperand<MODE>(addr, cpu.m_registers[Register::X] & cpu.m_registers[Register::A]);
   } else if constexpr (MODE == AddressingMode::Absolute) {
     cpu.WriteToMemory(address, cpu.m_registers[Register::X] & cpu.m_registers[Register::A]);
   } else if constexpr (MODE == AddressingMode::IndirectX) {
     Addr target_addr_low = (address + cpu.m_registers[Register::X]) & 0xFF;
     Addr target_addr_high = (address + cpu.m_registers[Register::X] + 1) & 0xFF;
-    Addr real_addr = cpu.ReadFromMemory(target_addr_high) << 8 | cpu.ReadFromMemory(target_addr_low);
+    Addr real_addr = cpu.ReadZeroPage(target_addr_high) << 8 | cpu.ReadZeroPage(target_addr_low);
     cpu.WriteToMemory(real_addr, cpu.m_registers[Register::X] & cpu.m_registers[Register::A]);
   } else {
     TODO(fmt::format("StoreAccumulatorAndX<{}>::Apply not implemented", magic_enum::enum_name(MODE)));
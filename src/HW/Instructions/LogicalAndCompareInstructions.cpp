@@ -35,9 +35,9 @@ template <AddressingMode MODE> void CPU::LogicalAND<MODE>::Apply(CPU &cpu) const
   if constexpr (MODE == AddressingMode::Immediate) {
     value_to_and = value & 0xFF;
   } else if constexpr (MODE == AddressingMode::ZeroPage) {
-    value_to_and = cpu.ReadFromMemory(value & 0xFF);
+    value_to_and = cpu.ReadZeroPage(value);
   } else if constexpr (MODE == AddressingMode::ZeroPageX) {
-    value_to_and = cpu.ReadFromMemory((value + cpu.m_registers[Register::X]) & 0xFF);
+    value_to_and = cpu.ReadZeroPage(value + cpu.m_registers[Register::X]);
   } else if constexpr (MODE == AddressingMode::Absolute) {
     value_to_and = cpu.ReadFromMemory(value);
   } else if constexpr (MODE == AddressingMode::AbsoluteX) {
@@ -47,12 +47,12 @@ template <AddressingMode MODE> void CPU::LogicalAND<MODE>::Apply(CPU &cpu) const
   } else if constexpr (MODE == AddressingMode::IndirectX) {
     Addr target_addr_low = (value + cpu.m_registers[Register::X]) & 0xFF;
     Addr target_addr_high = (value + cpu.m_registers[Register::X] + 1) & 0xFF;
-    Addr real_addr = cpu.ReadFromMemory(target_addr_high) << 8 | cpu.ReadFromMemory(target_addr_low);
+    Addr real_addr = cpu.ReadZeroPage(target_addr_high) << 8 | cpu.ReadZeroPage(target_addr_low);
     value_to_and = cpu.ReadFromMemory(real_addr);
   } else if constexpr (MODE == AddressingMode::IndirectY) {
     Addr target_addr_low = value & 0xFF;
     Addr target_addr_high = (value + 1) & 0xFF;
-    Addr real_addr = cpu.ReadFromMemory(target_addr_high) << 8 | cpu.ReadFromMemory(target_addr_low);
+    Addr real_addr = cpu.ReadZeroPage(target_addr_high) << 8 | cpu.ReadZeroPage(target_addr_low);
     value_to_and = cpu.ReadFromMemory(real_addr + cpu.m_registers[Register::Y]);
   } else {
     TODO(fmt::format("LogicalAND<{}>::Apply not implemented", magic_enum::enum_name(MODE)));
@@ -60,8 +60,7 @@ template <AddressingMode MODE> void CPU::LogicalAND<MODE>::Apply(CPU &cpu) const
 
   cpu.m_registers[Register::A] = cpu.m_registers[Register::A] & value_to_and;
 
-  cpu.SetStatusFlagValue(StatusFlag::Negative, cpu.m_registers[Register::A] & 0x80);
-  cpu.SetStatusFlagValue(StatusFlag::Zero, cpu.m_registers[Register::A] == 0);
+  cpu.SetZeroAndNegative(cpu.m_registers[Register::A]);
 }
 
 // ===========================================================================================
@@ -96,9 +95,9 @@ template <AddressingMode MODE> void CPU::ExclusiveOR<MODE>::Apply(CPU &cpu) cons
   if constexpr (MODE == AddressingMode::Immediate) {
     value_to_or = value & 0xFF;
   } else if constexpr (MODE == AddressingMode::ZeroPage) {
-    value_to_or = cpu.ReadFromMemory(value & 0xFF);
+    value_to_or = cpu.ReadZeroPage(value);
   } else if constexpr (MODE == AddressingMode::ZeroPageX) {
-    value_to_or = cpu.ReadFromMemory((value + cpu.m_registers[Register::X]) & 0xFF);
+    value_to_or = cpu.ReadZeroPage(value + cpu.m_registers[Register::X]);
   } else if constexpr (MODE == AddressingMode::Absolute) {
     value_to_or = cpu.ReadFromMemory(value);
   } else if constexpr (MODE == AddressingMode::AbsoluteX) {
@@ -108,12 +107,12 @@ template <AddressingMode MODE> void CPU::ExclusiveOR<MODE>::Apply(CPU &cpu) cons
   } else if constexpr (MODE == AddressingMode::IndirectX) {
     Addr target_addr_low = (value + cpu.m_registers[Register::X]) & 0xFF;
     Addr target_addr_high = (value + cpu.m_registers[Register::X] + 1) & 0xFF;
-    Addr real_addr = cpu.ReadFromMemory(target_addr_high) << 8 | cpu.ReadFromMemory(target_addr_low);
+    Addr real_addr = cpu.ReadZeroPage(target_addr_high) << 8 | cpu.ReadZeroPage(target_addr_low);
     value_to_or = cpu.ReadFromMemory(real_addr);
   } else if constexpr (MODE == AddressingMode::IndirectY) {
     Addr target_addr_low = value & 0xFF;
     Addr target_addr_high = (value + 1) & 0xFF;
-    Addr real_addr = cpu.ReadFromMemory(target_addr_high) << 8 | cpu.ReadFromMemory(target_addr_low);
+    Addr real_addr = cpu.ReadZeroPage(target_addr_high) << 8 | cpu.ReadZeroPage(target_addr_low);
     value_to_or = cpu.ReadFromMemory(real_addr + cpu.m_registers[Register::Y]);
   } else {
     TODO(fmt::format("ExclusiveOR<{}>::Apply not implemented", magic_enum::enum_name(MODE)));
@@ -121,8 +120,7 @@ template <AddressingMode MODE> void CPU::ExclusiveOR<MODE>::Apply(CPU &cpu) cons
 
   cpu.m_registers[Register::A] ^= value_to_or;
 
-  cpu.SetStatusFlagValue(StatusFlag::Zero, cpu.m_registers[Register::A] == 0);
-  cpu.SetStatusFlagValue(StatusFlag::Negative, cpu.m_registers[Register::A] & 0x80);
+  cpu.SetZeroAndNegative(cpu.m_registers[Register::A]);
 }
 
 // ===========================================================================================
@@ -157,9 +155,9 @@ template <AddressingMode MODE> void CPU::BitwiseOR<MODE>::Apply(CPU &cpu) const
   if constexpr (MODE == AddressingMode::Immediate) {
     value_to_or = value & 0xFF;
   } else if constexpr (MODE == AddressingMode::ZeroPage) {
-    value_to_or = cpu.ReadFromMemory(value & 0xFF);
+    value_to_or = cpu.ReadZeroPage(value);
   } else if constexpr (MODE == AddressingMode::ZeroPageX) {
-    value_to_or = cpu.ReadFromMemory((value + cpu.m_registers[Register::X]) & 0xFF);
+    value_to_or = cpu.ReadZeroPage(value + cpu.m_registers[Register::X]);
   } else if constexpr (MODE == AddressingMode::Absolute) {
     value_to_or = cpu.ReadFromMemory(value);
   } else if constexpr (MODE == AddressingMode::AbsoluteX) {
@@ -169,12 +167,12 @@ template <AddressingMode MODE> void CPU::BitwiseOR<MODE>::Apply(CPU &cpu) const
   } else if constexpr (MODE == AddressingMode::IndirectX) {
     Addr target_addr_low = (value + cpu.m_registers[Register::X]) & 0xFF;
     Addr target_addr_high = (value + cpu.m_registers[Register::X] + 1) & 0xFF;
-    Addr real_addr = cpu.ReadFromMemory(target_addr_high) << 8 | cpu.ReadFromMemory(target_addr_low);
+    Addr real_addr = cpu.ReadZeroPage(target_addr_high) << 8 | cpu.ReadZeroPage(target_addr_low);
     value_to_or = cpu.ReadFromMemory(real_addr);
   } else if constexpr (MODE == AddressingMode::IndirectY) {
     Addr target_addr_low = value & 0xFF;
     Addr target_addr_high = (value + 1) & 0xFF;
-    Addr real_addr = cpu.ReadFromMemory(target_addr_high) << 8 | cpu.ReadFromMemory(target_addr_low);
+    Addr real_addr = cpu.ReadZeroPage(target_addr_high) << 8 | cpu.ReadZeroPage(target_addr_low);
     value_to_or = cpu.ReadFromMemory(real_addr + cpu.m_registers[Register::Y]);
   } else {
     TODO(fmt::format("BitwiseOR<{}>::Apply not implemented", magic_enum::enum_name(MODE)));
@@ -182,8 +180,7 @@ template <AddressingMode MODE> void CPU::BitwiseOR<MODE>::Apply(CPU &cpu) const
 
   cpu.m_registers[Register::A] |= value_to_or;
 
-  cpu.SetStatusFlagValue(StatusFlag::Zero, cpu.m_registers[Register::A] == 0);
-  cpu.SetStatusFlagValue(StatusFlag::Negative, cpu.m_registers[Register::A] & 0x80);
+  cpu.SetZeroAndNegative(cpu.m_registers[Register::A]);
 }
 
 // ===========================================================================================
@@ -207,7 +204,7 @@ template <AddressingMode MODE> void CPU::BitTest<MODE>::Apply(CPU &cpu) const {
   uint8_t value{0};
   if constexpr (MODE == AddressingMode::ZeroPage) {
     Addr addr = address & 0xFF;
-    value = cpu.ReadFromMemory(addr);
+    value = cpu.ReadOperand<MODE>(addr);
   } else if constexpr (MODE == AddressingMode::Absolute) {
     value = cpu.ReadFromMemory(address);
   } else {
@@ -215,8 +212,9 @@ template <AddressingMode MODE> void CPU::BitTest<MODE>::Apply(CPU &cpu) const {
   }
 
   uint8_t result = cpu.m_registers[Register::A] & value;
-  cpu.SetStatusFlagValue(StatusFlag::Zero, result == 0);
-  cpu.SetStatusFlagValue(StatusFlag::Negative, value & 0b10000000);
+  // Z and N come from different bytes here
+  cpu.m_zero_result = result;
+  cpu.m_negative_result = value;
   cpu.SetStatusFlagValue(StatusFlag::Overflow, value & 0b01000000);
 }
 
@@ -251,33 +249,32 @@ template <CPU::Register REG, AddressingMode MODE> void CPU::CompareRegister<REG,
   if constexpr (MODE == AddressingMode::Immediate) {
     value_to_compare = value & 0xFF;
   } else if constexpr (MODE == AddressingMode::ZeroPage) {
-    value_to_compare = cpu.ReadFromMemory(value & 0xFF);
+    value_to_compare = cpu.ReadZeroPage(value);
   } else if constexpr (MODE == AddressingMode::ZeroPageX) {
     Addr effective_addr = (value + cpu.m_registers[Register::X]) & 0xFF;
-    value_to_compare = cpu.ReadFromMemory(effective_addr);
+    value_to_compare = cpu.ReadOperand<MODE>(effective_addr);
   } else if constexpr (MODE == AddressingMode::Absolute) {
     value_to_compare = cpu.ReadFromMemory(value);
   } else if constexpr (MODE == AddressingMode::AbsoluteX) {
     Addr effective_addr = value + cpu.m_registers[Register::X];
-    value_to_compare = cpu.ReadFromMemory(effective_addr);
+    value_to_compare = cpu.ReadOperand<MODE>(effective_addr);
   } else if constexpr (MODE == AddressingMode::AbsoluteY) {
     Addr effective_addr = value + cpu.m_registers[Register::Y];
-    value_to_compare = cpu.ReadFromMemory(effective_addr);
+    value_to_compare = cpu.ReadOperand<MODE>(effective_addr);
   } else if constexpr (MODE == AddressingMode::IndirectX) {
     Addr target_addr_low = (value + cpu.m_registers[Register::X]) & 0xFF;
     Addr target_addr_high = (value + cpu.m_registers[Register::X] + 1) & 0xFF;
-    Addr real_addr = cpu.ReadFromMemory(target_addr_high) << 8 | cpu.ReadFromMemory(target_addr_low);
+    Addr real_addr = cpu.ReadZeroPage(target_addr_high) << 8 | cpu.ReadZeroPage(target_addr_low);
     value_to_compare = cpu.ReadFromMemory(real_addr);
   } else if constexpr (MODE == AddressingMode::IndirectY) {
     Addr target_addr_low = value & 0xFF;
     Addr target_addr_high = (value + 1) & 0xFF;
-    Addr real_addr = cpu.ReadFromMemory(target_addr_high) << 8 | cpu.ReadFromMemory(target_addr_low);
+    Addr real_addr = cpu.ReadZeroPage(target_addr_high) << 8 | cpu.ReadZeroPage(target_addr_low);
     value_to_compare = cpu.ReadFromMemory(real_addr + cpu.m_registers[Register::Y]);
   }
 
   cpu.SetStatusFlagValue(StatusFlag::Carry, cpu.m_registers[REG] >= value_to_compare);
-  cpu.SetStatusFlagValue(StatusFlag::Zero, cpu.m_registers[REG] == value_to_compare);
-  cpu.SetStatusFlagValue(StatusFlag::Negative, (cpu.m_registers[REG] - value_to_compare) & 0x80);
+  cpu.SetZeroAndNegative(cpu.m_registers[REG] - value_to_compare);
 }
 
 // ===========================================================================================
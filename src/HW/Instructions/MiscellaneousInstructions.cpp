@@ -9,15 +9,13 @@ void CPU::TransferRegisterTo<SRCREG, DSTREG>::Apply(CPU &cpu) const {
   // See https://www.nesdev.org/obelisk-6502-guide/reference.html#TAX (or #TAY)
 
   cpu.m_registers[DSTREG] = cpu.m_registers[SRCREG];
-  cpu.SetStatusFlagValue(StatusFlag::Zero, cpu.m_registers[DSTREG] == 0);
-  cpu.SetStatusFlagValue(StatusFlag::Negative, cpu.m_registers[DSTREG] & 0x80);
+  cpu.SetZeroAndNegative(cpu.m_registers[DSTREG]);
 }
 
 void CPU::TransferStackPointerToX::Apply(CPU &cpu) const {
   cpu.m_registers[Register::X] = cpu.m_stack_pointer;
 
-  cpu.SetStatusFlagValue(StatusFlag::Zero, cpu.m_registers[Register::X] == 0);
-  cpu.SetStatusFlagValue(StatusFlag::Negative, cpu.m_registers[Register::X] & 0x80);
+  cpu.SetZeroAndNegative(cpu.m_registers[Register::X]);
 }
 
 void CPU::TransferXToStackPointer::Apply(CPU &cpu) const { 
@@ -36,9 +36,9 @@ template <AddressingMode MODE> void CPU::ShiftLeft<MODE>::Apply(CPU &cpu) const
   if constexpr (MODE == AddressingMode::Accumulator) {
     value_to_shift = cpu.m_registers[Register::A];
   } else if constexpr (MODE == AddressingMode::ZeroPage) {
-    value_to_shift = cpu.ReadFromMemory(address & 0xFF);
+    value_to_shift = cpu.ReadZeroPage(address);
   } else if constexpr (MODE == AddressingMode::ZeroPageX) {
-    value_to_shift = cpu.ReadFromMemory((address + cpu.m_registers[Register::X]) & 0xFF);
+    value_to_shift = cpu.ReadZeroPage(address + cpu.m_registers[Register::X]);
   } else if constexpr (MODE == AddressingMode::Absolute) {
     value_to_shift = cpu.ReadFromMemory(address);
   } else if constexpr (MODE == AddressingMode::AbsoluteX) {
@@ -54,9 +54,9 @@ template <AddressingMode MODE> void CPU::ShiftLeft<MODE>::Apply(CPU &cpu) const
   if constexpr (MODE == AddressingMode::Accumulator) {
     cpu.m_registers[Register::A] = value_to_store;
   } else if constexpr (MODE == AddressingMode::ZeroPage) {
-    cpu.WriteToMemory(address & 0xFF, value_to_store);
+    cpu.WriteZeroPage(address, value_to_store);
   } else if constexpr (MODE == AddressingMode::ZeroPageX) {
-    cpu.WriteToMemory((address + cpu.m_registers[Register::X]) & 0xFF, value_to_store);
+    cpu.WriteZeroPage(address + cpu.m_registers[Register::X], value_to_store);
   } else if constexpr (MODE == AddressingMode::Absolute) {
     cpu.WriteToMemory(address, value_to_store);
   } else if constexpr (MODE == AddressingMode::AbsoluteX) {
@@ -65,8 +65,7 @@ template <AddressingMode MODE> void CPU::ShiftLeft<MODE>::Apply(CPU &cpu) const
     TODO(fmt::format("ShiftLeft<{}>::Apply not implemented", magic_enum::enum_name(MODE)));
   }
 
-  cpu.SetStatusFlagValue(StatusFlag::Negative, value_to_store & 0x80);
-  cpu.SetStatusFlagValue(StatusFlag::Zero, value_to_store == 0);
+  cpu.SetZeroAndNegative(value_to_store);
   cpu.SetStatusFlagValue(StatusFlag::Carry, value_to_shift & 0x100);
 }
 
@@ -102,9 +101,9 @@ template <AddressingMode MODE> void CPU::ShiftRight<MODE>::Apply(CPU &cpu) const
   if constexpr (MODE == AddressingMode::Accumulator) {
     value_to_shift = cpu.m_registers[Register::A];
   } else if constexpr (MODE == AddressingMode::ZeroPage) {
-    value_to_shift = cpu.ReadFromMemory(address & 0xFF);
+    value_to_shift = cpu.ReadZeroPage(address);
   } else if constexpr (MODE == AddressingMode::ZeroPageX) {
-    value_to_shift = cpu.ReadFromMemory((address + cpu.m_registers[Register::X]) & 0xFF);
+    value_to_shift = cpu.ReadZeroPage(address + cpu.m_registers[Register::X]);
   } else if constexpr (MODE == AddressingMode::Absolute) {
     value_to_shift = cpu.ReadFromMemory(address);
   } else if constexpr (MODE == AddressingMode::AbsoluteX) {
@@ -118,9 +117,9 @@ template <AddressingMode MODE> void CPU::ShiftRight<MODE>::Apply(CPU &cpu) const
   if constexpr (MODE == AddressingMode::Accumulator) {
     cpu.m_registers[Register::A] = value_to_store;
   } else if constexpr (MODE == AddressingMode::ZeroPage) {
-    cpu.WriteToMemory(address & 0xFF, value_to_store);
+    cpu.WriteZeroPage(address, value_to_store);
   } else if constexpr (MODE == AddressingMode::ZeroPageX) {
-    cpu.WriteToMemory((address + cpu.m_registers[Register::X]) & 0xFF, value_to_store);
+    cpu.WriteZeroPage(address + cpu.m_registers[Register::X], value_to_store);
   } else if constexpr (MODE == AddressingMode::Absolute) {
     cpu.WriteToMemory(address, value_to_store);
   } else if constexpr (MODE == AddressingMode::AbsoluteX) {
@@ -129,8 +128,7 @@ template <AddressingMode MODE> void CPU::ShiftRight<MODE>::Apply(CPU &cpu) const
     TODO(fmt::format("ShiftRight<{}>::Apply not implemented", magic_enum::enum_name(MODE)));
   }
 
-  cpu.SetStatusFlagValue(StatusFlag::Negative, value_to_store & 0x80);
-  cpu.SetStatusFlagValue(StatusFlag::Zero, value_to_store == 0);
+  cpu.SetZeroAndNegative(value_to_store);
   cpu.SetStatusFlagValue(StatusFlag::Carry, value_to_shift & 0x1);
 }
 
@@ -166,9 +164,9 @@ template <AddressingMode MODE> void CPU::RotateRight<MODE>::Apply(CPU &cpu) cons
   if constexpr (MODE == AddressingMode::Accumulator) {
     value_to_rotate = cpu.m_registers[Register::A];
   } else if constexpr (MODE == AddressingMode::ZeroPage) {
-    value_to_rotate = cpu.ReadFromMemory(address & 0xFF);
+    value_to_rotate = cpu.ReadZeroPage(address);
   } else if constexpr (MODE == AddressingMode::ZeroPageX) {
-    value_to_rotate = cpu.ReadFromMemory((address + cpu.m_registers[Register::X]) & 0xFF);
+    value_to_rotate = cpu.ReadZeroPage(address + cpu.m_registers[Register::X]);
   } else if constexpr (MODE == AddressingMode::Absolute) {
     value_to_rotate = cpu.ReadFromMemory(address);
   } else if constexpr (MODE == AddressingMode::AbsoluteX) {
@@ -184,9 +182,9 @@ template <AddressingMode MODE> void CPU::RotateRight<MODE>::Apply(CPU &cpu) cons
   if constexpr (MODE == AddressingMode::Accumulator) {
     cpu.m_registers[Register::A] = value_to_store;
   } else if constexpr (MODE == AddressingMode::ZeroPage) {
-    cpu.WriteToMemory(address & 0xFF, value_to_store);
+    cpu.WriteZeroPage(address, value_to_store);
   } else if constexpr (MODE == AddressingMode::ZeroPageX) {
-    cpu.WriteToMemory((address + cpu.m_registers[Register::X]) & 0xFF, value_to_store);
+    cpu.WriteZeroPage(address + cpu.m_registers[Register::X], value_to_store);
   } else if constexpr (MODE == AddressingMode::Absolute) {
     cpu.WriteToMemory(address, value_to_store);
   } else if constexpr (MODE == AddressingMode::AbsoluteX) {
@@ -195,8 +193,7 @@ template <AddressingMode MODE> void CPU::RotateRight<MODE>::Apply(CPU &cpu) cons
     TODO(fmt::format("RotateRight<{}>::Apply not implemented", magic_enum::enum_name(MODE)));
   }
 
-  cpu.SetStatusFlagValue(StatusFlag::Negative, value_to_store & 0x80);
-  cpu.SetStatusFlagValue(StatusFlag::Zero, value_to_store == 0);
+  cpu.SetZeroAndNegative(value_to_store);
   cpu.SetStatusFlagValue(StatusFlag::Carry, new_carry);
 }
 
@@ -232,9 +229,9 @@ template <AddressingMode MODE> void CPU::RotateLeft<MODE>::Apply(CPU &cpu) const
   if constexpr (MODE == AddressingMode::Accumulator) {
     value_to_rotate = cpu.m_registers[Register::A];
   } else if constexpr (MODE == AddressingMode::ZeroPage) {
-    value_to_rotate = cpu.ReadFromMemory(address & 0xFF);
+    value_to_rotate = cpu.ReadZeroPage(address);
   } else if constexpr (MODE == AddressingMode::ZeroPageX) {
-    value_to_rotate = cpu.ReadFromMemory((address + cpu.m_registers[Register::X]) & 0xFF);
+    value_to_rotate = cpu.ReadZeroPage(address + cpu.m_registers[Register::X]);
   } else if constexpr (MODE == AddressingMode::Absolute) {
     value_to_rotate = cpu.ReadFromMemory(address);
   } else if constexpr (MODE == AddressingMode::AbsoluteX) {
@@ -250,9 +247,9 @@ template <AddressingMode MODE> void CPU::RotateLeft<MODE>::Apply(CPU &cpu) const
   if constexpr (MODE == AddressingMode::Accumulator) {
     cpu.m_registers[Register::A] = value_to_store;
   } else if constexpr (MODE == AddressingMode::ZeroPage) {
-    cpu.WriteToMemory(address & 0xFF, value_to_store);
+    cpu.WriteZeroPage(address, value_to_store);
   } else if constexpr (MODE == AddressingMode::ZeroPageX) {
-    cpu.WriteToMemory((address + cpu.m_registers[Register::X]) & 0xFF, value_to_store);
+    cpu.WriteZeroPage(address + cpu.m_registers[Register::X], value_to_store);
   } else if constexpr (MODE == AddressingMode::Absolute) {
     cpu.WriteToMemory(address, value_to_store);
   } else if constexpr (MODE == AddressingMode::AbsoluteX) {
@@ -261,8 +258,7 @@ template <AddressingMode MODE> void CPU::RotateLeft<MODE>::Apply(CPU &cpu) const
     TODO(fmt::format("RotateLeft<{}>::Apply not implemented", magic_enum::enum_name(MODE)));
   }
 
-  cpu.SetStatusFlagValue(StatusFlag::Negative, value_to_store & 0x80);
-  cpu.SetStatusFlagValue(StatusFlag::Zero, value_to_store == 0);
+  cpu.SetZeroAndNegative(value_to_store);
   cpu.SetStatusFlagValue(StatusFlag::Carry, new_carry);
 }
 
@@ -31,11 +31,11 @@ template <AddressingMode MODE> CPU::DecrementAndCompare<MODE>::DecrementAndCompa
 template <AddressingMode MODE> void CPU::DecrementAndCompare<MODE>::Apply(CPU &cpu) const {
   uint8_t value_to_compare = 0;
   if constexpr (MODE == AddressingMode::ZeroPage) {
-    value_to_compare = cpu.ReadFromMemory(address & 0xFF) - 1;
-    cpu.WriteToMemory(address & 0xFF, value_to_compare);
+    value_to_compare = cpu.ReadZeroPage(address) - 1;
+    cpu.WriteZeroPage(address, value_to_compare);
   } else if constexpr (MODE == AddressingMode::ZeroPageX) {
-    value_to_compare = cpu.ReadFromMemory((address + cpu.m_registers[Register::X]) & 0xFF) - 1;
-    cpu.WriteToMemory((address + cpu.m_registers[Register::X]) & 0xFF, value_to_compare);
+    value_to_compare = cpu.ReadZeroPage(address + cpu.m_registers[Register::X]) - 1;
+    cpu.WriteZeroPage(address + cpu.m_registers[Register::X], value_to_compare);
   } else if constexpr (MODE == AddressingMode::Absolute) {
     value_to_compare = cpu.ReadFromMemory(address) - 1;
     cpu.WriteToMemory(address, value_to_compare);
@@ -48,13 +48,13 @@ template <AddressingMode MODE> void CPU::DecrementAndCompare<MODE>::Apply(CPU &c
   } else if constexpr (MODE == AddressingMode::IndirectX) {
     Addr target_addr_low = (address + cpu.m_registers[Register::X]) & 0xFF;
     Addr target_addr_high = (address + cpu.m_registers[Register::X] + 1) & 0xFF;
-    Addr real_addr = cpu.ReadFromMemory(target_addr_high) << 8 | cpu.ReadFromMemory(target_addr_low);
+    Addr real_addr = cpu.ReadZeroPage(target_addr_high) << 8 | cpu.ReadZeroPage(target_addr_low);
     value_to_compare = cpu.ReadFromMemory(real_addr) - 1;
     cpu.WriteToMemory(real_addr, value_to_compare);
   } else if constexpr (MODE == AddressingMode::IndirectY) {
     Addr target_addr_low = address & 0xFF;
     Addr target_addr_high = (address + 1) & 0xFF;
-    Addr real_addr = cpu.ReadFromMemory(target_addr_high) << 8 | cpu.ReadFromMemory(target_addr_low);
+    Addr real_addr = cpu.ReadZeroPage(target_addr_high) << 8 | cpu.ReadZeroPage(target_addr_low);
     value_to_compare = cpu.ReadFromMemory(real_addr + cpu.m_registers[Register::Y]) - 1;
     cpu.WriteToMemory(real_addr + cpu.m_registers[Register::Y], value_to_compare);
   } else {
@@ -62,8 +62,7 @@ template <AddressingMode MODE> void CPU::DecrementAndCompare<MODE>::Apply(CPU &c
   }
 
   cpu.SetStatusFlagValue(StatusFlag::Carry, cpu.m_registers[Register::A] >= value_to_compare);
-  cpu.SetStatusFlagValue(StatusFlag::Zero, cpu.m_registers[Register::A] == value_to_compare);
-  cpu.SetStatusFlagValue(StatusFlag::Negative, (cpu.m_registers[Register::A] - value_to_compare) & 0x80);
+  cpu.SetZeroAndNegative(cpu.m_registers[Register::A] - value_to_compare);
 }
 
 // ===== IncrementAndSubtract =====
@@ -93,11 +92,11 @@ template <AddressingMode MODE> CPU::IncrementAndSubtract<MODE>::IncrementAndSubt
 template <AddressingMode MODE> void CPU::IncrementAndSubtract<MODE>::Apply(CPU &cpu) const {
   uint8_t value_to_write = 0;
   if constexpr (MODE == AddressingMode::ZeroPage) {
-    value_to_write = cpu.ReadFromMemory(address & 0xFF) + 1;
-    cpu.WriteToMemory(address & 0xFF, value_to_write);
+    value_to_write = cpu.ReadZeroPage(address) + 1;
+    cpu.WriteZeroPage(address, value_to_write);
   } else if constexpr (MODE == AddressingMode::ZeroPageX) {
-    value_to_write = cpu.ReadFromMemory((address + cpu.m_registers[Register::X]) & 0xFF) + 1;
-    cpu.WriteToMemory((address + cpu.m_registers[Register::X]) & 0xFF, value_to_write);
+    value_to_write = cpu.ReadZeroPage(address + cpu.m_registers[Register::X]) + 1;
+    cpu.WriteZeroPage(address + cpu.m_registers[Register::X], value_to_write);
   } else if constexpr (MODE == AddressingMode::Absolute) {
     value_to_write = cpu.ReadFromMemory(address) + 1;
     cpu.WriteToMemory(address, value_to_write);
@@ -110,13 +109,13 @@ template <AddressingMode MODE> void CPU::IncrementAndSubtract<MODE>::Apply(CPU &
   } else if constexpr (MODE == AddressingMode::IndirectX) {
     Addr target_addr_low = (address + cpu.m_registers[Register::X]) & 0xFF;
     Addr target_addr_high = (address + cpu.m_registers[Register::X] + 1) & 0xFF;
-    Addr real_addr = cpu.ReadFromMemory(target_addr_high) << 8 | cpu.ReadFromMemory(target_addr_low);
+    Addr real_addr = cpu.ReadZeroPage(target_addr_high) << 8 | cpu.ReadZeroPage(target_addr_low);
     value_to_write = cpu.ReadFromMemory(real_addr) + 1;
     cpu.WriteToMemory(real_addr, value_to_write);
   } else if constexpr (MODE == AddressingMode::IndirectY) {
     Addr target_addr_low = address & 0xFF;
     Addr target_addr_high = (address + 1) & 0xFF;
-    Addr real_addr = cpu.ReadFromMemory(target_addr_high) << 8 | cpu.ReadFromMemory(target_addr_low);
+    Addr real_addr = cpu.ReadZeroPage(target_addr_high) << 8 | cpu.ReadZeroPage(target_addr_low);
     value_to_write = cpu.ReadFromMemory(real_addr + cpu.m_registers[Register::Y]) + 1;
     cpu.WriteToMemory(real_addr + cpu.m_registers[Register::Y], value_to_write);
   } else {
@@ -136,8 +135,7 @@ template <AddressingMode MODE> void CPU::IncrementAndSubtract<MODE>::Apply(CPU &
 
   cpu.m_registers[Register::A] = result;
 
-  cpu.SetStatusFlagValue(StatusFlag::Negative, cpu.m_registers[Register::A] & 0x80);
-  cpu.SetStatusFlagValue(StatusFlag::Zero, cpu.m_registers[Register::A] == 0);
+  cpu.SetZeroAndNegative(cpu.m_registers[Register::A]);
   cpu.SetStatusFlagValue(StatusFlag::Carry, !(intermediate_result & 0x100)); // Inverted for subtraction
   // Overflow formula is the same as ADC when using one's complement
   cpu.SetStatusFlagValue(StatusFlag::Overflow, ((M ^ result) & (N ^ result) & 0x80) != 0);
@@ -170,9 +168,9 @@ template <AddressingMode MODE> CPU::ShiftLeftAndOR<MODE>::ShiftLeftAndOR(uint16_
 template <AddressingMode MODE> void CPU::ShiftLeftAndOR<MODE>::Apply(CPU &cpu) const {
   uint8_t value_to_shift = 0;
   if constexpr (MODE == AddressingMode::ZeroPage) {
-    value_to_shift = cpu.ReadFromMemory(address & 0xFF);
+    value_to_shift = cpu.ReadZeroPage(address);
   } else if constexpr (MODE == AddressingMode::ZeroPageX) {
-    value_to_shift = cpu.ReadFromMemory((address + cpu.m_registers[Register::X]) & 0xFF);
+    value_to_shift = cpu.ReadZeroPage(address + cpu.m_registers[Register::X]);
   } else if constexpr (MODE == AddressingMode::Absolute) {
     value_to_shift = cpu.ReadFromMemory(address);
   } else if constexpr (MODE == AddressingMode::AbsoluteX) {
@@ -182,12 +180,12 @@ template <AddressingMode MODE> void CPU::ShiftLeftAndOR<MODE>::Apply(CPU &cpu) c
   } else if constexpr (MODE == AddressingMode::IndirectX) {
     Addr target_addr_low = (address + cpu.m_registers[Register::X]) & 0xFF;
     Addr target_addr_high = (address + cpu.m_registers[Register::X] + 1) & 0xFF;
-    Addr real_addr = cpu.ReadFromMemory(target_addr_high) << 8 | cpu.ReadFromMemory(target_addr_low);
+    Addr real_addr = cpu.ReadZeroPage(target_addr_high) << 8 | cpu.ReadZeroPage(target_addr_low);
     value_to_shift = cpu.ReadFromMemory(real_addr);
   } else if constexpr (MODE == AddressingMode::IndirectY) {
     Addr target_addr_low = address & 0xFF;
     Addr target_addr_high = (address + 1) & 0xFF;
-    Addr real_addr = cpu.ReadFromMemory(target_addr_high) << 8 | cpu.ReadFromMemory(target_addr_low);
+    Addr real_addr = cpu.ReadZeroPage(target_addr_high) << 8 | cpu.ReadZeroPage(target_addr_low);
     value_to_shift = cpu.ReadFromMemory(real_addr + cpu.m_registers[Register::Y]);
   } else {
     TODO(fmt::format("ShiftLeftAndOR<{}>::Apply not implemented", magic_enum::enum_name(MODE)));
@@ -197,9 +195,9 @@ template <AddressingMode MODE> void CPU::ShiftLeftAndOR<MODE>::Apply(CPU &cpu) c
   uint8_t value_to_store = shifted_value & 0xFF;
 
   if constexpr (MODE == AddressingMode::ZeroPage) {
-    cpu.WriteToMemory(address & 0xFF, value_to_store);
+    cpu.WriteZeroPage(address, value_to_store);
   } else if constexpr (MODE == AddressingMode::ZeroPageX) {
-    cpu.WriteToMemory((address + cpu.m_registers[Register::X]) & 0xFF, value_to_store);
+    cpu.WriteZeroPage(address + cpu.m_registers[Register::X], value_to_store);
   } else if constexpr (MODE == AddressingMode::Absolute) {
     cpu.WriteToMemory(address, value_to_store);
   } else if constexpr (MODE == AddressingMode::AbsoluteX) {
@@ -209,12 +207,12 @@ template <AddressingMode MODE> void CPU::ShiftLeftAndOR<MODE>::Apply(CPU &cpu) c
   } else if constexpr (MODE == AddressingMode::IndirectX) {
     Addr target_addr_low = (address + cpu.m_registers[Register::X]) & 0xFF;
     Addr target_addr_high = (address + cpu.m_registers[Register::X] + 1) & 0xFF;
-    Addr real_addr = cpu.ReadFromMemory(target_addr_high) << 8 | cpu.ReadFromMemory(target_addr_low);
+    Addr real_addr = cpu.ReadZeroPage(target_addr_high) << 8 | cpu.ReadZeroPage(target_addr_low);
     cpu.WriteToMemory(real_addr, value_to_store);
   } else if constexpr (MODE == AddressingMode::IndirectY) {
     Addr target_addr_low = address & 0xFF;
     Addr target_addr_high = (address + 1) & 0xFF;
-    Addr real_addr = cpu.ReadFromMemory(target_addr_high) << 8 | cpu.ReadFromMemory(target_addr_low);
+    Addr real_addr = cpu.ReadZeroPage(target_addr_high) << 8 | cpu.ReadZeroPage(target_addr_low);
     cpu.WriteToMemory(real_addr + cpu.m_registers[Register::Y], value_to_store);
   } else {
     TODO(fmt::format("ShiftLeftAndOR<{}>::Apply not implemented", magic_enum::enum_name(MODE)));
@@ -222,8 +220,7 @@ template <AddressingMode MODE> void CPU::ShiftLeftAndOR<MODE>::Apply(CPU &cpu) c
 
   cpu.m_registers[Register::A] |= value_to_store;
 
-  cpu.SetStatusFlagValue(StatusFlag::Zero, cpu.m_registers[Register::A] == 0);
-  cpu.SetStatusFlagValue(StatusFlag::Negative, cpu.m_registers[Register::A] & 0x80);
+  cpu.SetZeroAndNegative(cpu.m_registers[Register::A]);
   cpu.SetStatusFlagValue(StatusFlag::Carry, shifted_value & 0x100);
 }
 
@@ -254,9 +251,9 @@ template <AddressingMode MODE> CPU::RotateLeftAndAND<MODE>::RotateLeftAndAND(uin
 template <AddressingMode MODE> void CPU::RotateLeftAndAND<MODE>::Apply(CPU &cpu) const {
   uint8_t value_to_rotate = 0;
   if constexpr (MODE == AddressingMode::ZeroPage) {
-    value_to_rotate = cpu.ReadFromMemory(address & 0xFF);
+    value_to_rotate = cpu.ReadZeroPage(address);
   } else if constexpr (MODE == AddressingMode::ZeroPageX) {
-    value_to_rotate = cpu.ReadFromMemory((address + cpu.m_registers[Register::X]) & 0xFF);
+    value_to_rotate = cpu.ReadZeroPage(address + cpu.m_registers[Register::X]);
   } else if constexpr (MODE == AddressingMode::Absolute) {
     value_to_rotate = cpu.ReadFromMemory(address);
   } else if constexpr (MODE == AddressingMode::AbsoluteX) {
@@ -266,12 +263,12 @@ template <AddressingMode MODE> void CPU::RotateLeftAndAND<MODE>::Apply(CPU &cpu)
   } else if constexpr (MODE == AddressingMode::IndirectX) {
     Addr target_addr_low = (address + cpu.m_registers[Register::X]) & 0xFF;
     Addr target_addr_high = (address + cpu.m_registers[Register::X] + 1) & 0xFF;
-    Addr real_addr = cpu.ReadFromMemory(target_addr_high) << 8 | cpu.ReadFromMemory(target_addr_low);
+    Addr real_addr = cpu.ReadZeroPage(target_addr_high) << 8 | cpu.ReadZeroPage(target_addr_low);
     value_to_rotate = cpu.ReadFromMemory(real_addr);
   } else if constexpr (MODE == AddressingMode::IndirectY) {
     Addr target_addr_low = address & 0xFF;
     Addr target_addr_high = (address + 1) & 0xFF;
-    Addr real_addr = cpu.ReadFromMemory(target_addr_high) << 8 | cpu.ReadFromMemory(target_addr_low);
+    Addr real_addr = cpu.ReadZeroPage(target_addr_high) << 8 | cpu.ReadZeroPage(target_addr_low);
     value_to_rotate = cpu.ReadFromMemory(real_addr + cpu.m_registers[Register::Y]);
   } else {
     TODO(fmt::format("RotateLeftAndAND<{}>::Apply not implemented", magic_enum::enum_name(MODE)));
@@ -282,9 +279,9 @@ template <AddressingMode MODE> void CPU::RotateLeftAndAND<MODE>::Apply(CPU &cpu)
   uint8_t value_to_store = (value_to_rotate << 1) | (old_carry ? 0x01 : 0x00);
 
   if constexpr (MODE == AddressingMode::ZeroPage) {
-    cpu.WriteToMemory(address & 0xFF, value_to_store);
+    cpu.WriteZeroPage(address, value_to_store);
   } else if constexpr (MODE == AddressingMode::ZeroPageX) {
-    cpu.WriteToMemory((address + cpu.m_registers[Register::X]) & 0xFF, value_to_store);
+    cpu.WriteZeroPage(address + cpu.m_registers[Register::X], value_to_store);
   } else if constexpr (MODE == AddressingMode::Absolute) {
     cpu.WriteToMemory(address, value_to_store);
   } else if constexpr (MODE == AddressingMode::AbsoluteX) {
@@ -294,12 +291,12 @@ template <AddressingMode MODE> void CPU::RotateLeftAndAND<MODE>::Apply(CPU &cpu)
   } else if constexpr (MODE == AddressingMode::IndirectX) {
     Addr target_addr_low = (address + cpu.m_registers[Register::X]) & 0xFF;
     Addr target_addr_high = (address + cpu.m_registers[Register::X] + 1) & 0xFF;
-    Addr real_addr = cpu.ReadFromMemory(target_addr_high) << 8 | cpu.ReadFromMemory(target_addr_low);
+    Addr real_addr = cpu.ReadZeroPage(target_addr_high) << 8 | cpu.ReadZeroPage(target_addr_low);
     cpu.WriteToMemory(real_addr, value_to_store);
   } else if constexpr (MODE == AddressingMode::IndirectY) {
     Addr target_addr_low = address & 0xFF;
     Addr target_addr_high = (address + 1) & 0xFF;
-    Addr real_addr = cpu.ReadFromMemory(target_addr_high) << 8 | cpu.ReadFromMemory(target_addr_low);
+    Addr real_addr = cpu.ReadZeroPage(target_addr_high) << 8 | cpu.ReadZeroPage(target_addr_low);
     cpu.WriteToMemory(real_addr + cpu.m_registers[Register::Y], value_to_store);
   } else {
     TODO(fmt::format("RotateLeftAndAND<{}>::Apply not implemented", magic_enum::enum_name(MODE)));
@@ -307,8 +304,7 @@ template <AddressingMode MODE> void CPU::RotateLeftAndAND<MODE>::Apply(CPU &cpu)
 
   cpu.m_registers[Register::A] &= value_to_store;
 
-  cpu.SetStatusFlagValue(StatusFlag::Negative, cpu.m_registers[Register::A] & 0x80);
-  cpu.SetStatusFlagValue(StatusFlag::Zero, cpu.m_registers[Register::A] == 0);
+  cpu.SetZeroAndNegative(cpu.m_registers[Register::A]);
   cpu.SetStatusFlagValue(StatusFlag::Carry, new_carry);
 }
 
@@ -339,9 +335,9 @@ template <AddressingMode MODE> CPU::ShiftRightAndEOR<MODE>::ShiftRightAndEOR(uin
 template <AddressingMode MODE> void CPU::ShiftRightAndEOR<MODE>::Apply(CPU &cpu) const {
   uint8_t value_to_shift = 0;
   if constexpr (MODE == AddressingMode::ZeroPage) {
-    value_to_shift = cpu.ReadFromMemory(address & 0xFF);
+    value_to_shift = cpu.ReadZeroPage(address);
   } else if constexpr (MODE == AddressingMode::ZeroPageX) {
-    value_to_shift = cpu.ReadFromMemory((address + cpu.m_registers[Register::X]) & 0xFF);
+    value_to_shift = cpu.ReadZeroPage(address + cpu.m_registers[Register::X]);
   } else if constexpr (MODE == AddressingMode::Absolute) {
     value_to_shift = cpu.ReadFromMemory(address);
   } else if constexpr (MODE == AddressingMode::AbsoluteX) {
@@ -351,12 +347,12 @@ template <AddressingMode MODE> void CPU::ShiftRightAndEOR<MODE>::Apply(CPU &cpu)
   } else if constexpr (MODE == AddressingMode::IndirectX) {
     Addr target_addr_low = (address + cpu.m_registers[Register::X]) & 0xFF;
     Addr target_addr_high = (address + cpu.m_registers[Register::X] + 1) & 0xFF;
-    Addr real_addr = cpu.ReadFromMemory(target_addr_high) << 8 | cpu.ReadFromMemory(target_addr_low);
+    Addr real_addr = cpu.ReadZeroPage(target_addr_high) << 8 | cpu.ReadZeroPage(target_addr_low);
     value_to_shift = cpu.ReadFromMemory(real_addr);
   } else if constexpr (MODE == AddressingMode::IndirectY) {
     Addr target_addr_low = address & 0xFF;
     Addr target_addr_high = (address + 1) & 0xFF;
-    Addr real_addr = cpu.ReadFromMemory(target_addr_high) << 8 | cpu.ReadFromMemory(target_addr_low);
+    Addr real_addr = cpu.ReadZeroPage(target_addr_high) << 8 | cpu.ReadZeroPage(target_addr_low);
     value_to_shift = cpu.ReadFromMemory(real_addr + cpu.m_registers[Register::Y]);
   } else {
     TODO(fmt::format("ShiftRightAndEOR<{}>::Apply not implemented", magic_enum::enum_name(MODE)));
@@ -367,9 +363,9 @@ template <AddressingMode MODE> void CPU::ShiftRightAndEOR<MODE>::Apply(CPU &cpu)
   cpu.SetStatusFlagValue(StatusFlag::Carry, value_to_shift & 0x1);
 
   if constexpr (MODE == AddressingMode::ZeroPage) {
-    cpu.WriteToMemory(address & 0xFF, value_to_store);
+    cpu.WriteZeroPage(address, value_to_store);
   } else if constexpr (MODE == AddressingMode::ZeroPageX) {
-    cpu.WriteToMemory((address + cpu.m_registers[Register::X]) & 0xFF, value_to_store);
+    cpu.WriteZeroPage(address + cpu.m_registers[Register::X], value_to_store);
   } else if constexpr (MODE == AddressingMode::Absolute) {
     cpu.WriteToMemory(address, value_to_store);
   } else if constexpr (MODE == AddressingMode::AbsoluteX) {
@@ -379,12 +375,12 @@ template <AddressingMode MODE> void CPU::ShiftRightAndEOR<MODE>::Apply(CPU &cpu)
   } else if constexpr (MODE == AddressingMode::IndirectX) {
     Addr target_addr_low = (address + cpu.m_registers[Register::X]) & 0xFF;
     Addr target_addr_high = (address + cpu.m_registers[Register::X] + 1) & 0xFF;
-    Addr real_addr = cpu.ReadFromMemory(target_addr_high) << 8 | cpu.ReadFromMemory(target_addr_low);
+    Addr real_addr = cpu.ReadZeroPage(target_addr_high) << 8 | cpu.ReadZeroPage(target_addr_low);
     cpu.WriteToMemory(real_addr, value_to_store);
   } else if constexpr (MODE == AddressingMode::IndirectY) {
     Addr target_addr_low = address & 0xFF;
     Addr target_addr_high = (address + 1) & 0xFF;
-    Addr real_addr = cpu.ReadFromMemory(target_addr_high) << 8 | cpu.ReadFromMemory(target_addr_low);
+    Addr real_addr = cpu.ReadZeroPage(target_addr_high) << 8 | cpu.ReadZeroPage(target_addr_low);
     cpu.WriteToMemory(real_addr + cpu.m_registers[Register::Y], value_to_store);
   } else {
     TODO(fmt::format("ShiftRightAndEOR<{}>::Apply not implemented", magic_enum::enum_name(MODE)));
@@ -392,8 +388,7 @@ template <AddressingMode MODE> void CPU::ShiftRightAndEOR<MODE>::Apply(CPU &cpu)
 
   cpu.m_registers[Register::A] ^= value_to_store;
 
-  cpu.SetStatusFlagValue(StatusFlag::Zero, cpu.m_registers[Register::A] == 0);
-  cpu.SetStatusFlagValue(StatusFlag::Negative, cpu.m_registers[Register::A] & 0x80);
+  cpu.SetZeroAndNegative(cpu.m_registers[Register::A]);
 }
 
 // ===== RotateRightAndAdd =====
@@ -423,9 +418,9 @@ template <AddressingMode MODE> CPU::RotateRightAndAdd<MODE>::RotateRightAndAdd(u
 template <AddressingMode MODE> void CPU::RotateRightAndAdd<MODE>::Apply(CPU &cpu) const {
   uint8_t value_to_rotate = 0;
   if constexpr (MODE == AddressingMode::ZeroPage) {
-    value_to_rotate = cpu.ReadFromMemory(address & 0xFF);
+    value_to_rotate = cpu.ReadZeroPage(address);
   } else if constexpr (MODE == AddressingMode::ZeroPageX) {
-    value_to_rotate = cpu.ReadFromMemory((address + cpu.m_registers[Register::X]) & 0xFF);
+    value_to_rotate = cpu.ReadZeroPage(address + cpu.m_registers[Register::X]);
   } else if constexpr (MODE == AddressingMode::Absolute) {
     value_to_rotate = cpu.ReadFromMemory(address);
   } else if constexpr (MODE == AddressingMode::AbsoluteX) {
@@ -435,12 +430,12 @@ template <AddressingMode MODE> void CPU::RotateRightAndAdd<MODE>::Apply(CPU &cpu
   } else if constexpr (MODE == AddressingMode::IndirectX) {
     Addr target_addr_low = (address + cpu.m_registers[Register::X]) & 0xFF;
     Addr target_addr_high = (address + cpu.m_registers[Register::X] + 1) & 0xFF;
-    Addr real_addr = cpu.ReadFromMemory(target_addr_high) << 8 | cpu.ReadFromMemory(target_addr_low);
+    Addr real_addr = cpu.ReadZeroPage(target_addr_high) << 8 | cpu.ReadZeroPage(target_addr_low);
     value_to_rotate = cpu.ReadFromMemory(real_addr);
   } else if constexpr (MODE == AddressingMode::IndirectY) {
     Addr target_addr_low = address & 0xFF;
     Addr target_addr_high = (address + 1) & 0xFF;
-    Addr real_addr = cpu.ReadFromMemory(target_addr_high) << 8 | cpu.ReadFromMemory(target_addr_low);
+    Addr real_addr = cpu.ReadZeroPage(target_addr_high) << 8 | cpu.ReadZeroPage(target_addr_low);
     value_to_rotate = cpu.ReadFromMemory(real_addr + cpu.m_registers[Register::Y]);
   } else {
     TODO(fmt::format("RotateRightAndAdd<{}>::Apply not implemented", magic_enum::enum_name(MODE)));
@@ -451,9 +446,9 @@ template <AddressingMode MODE> void CPU::RotateRightAndAdd<MODE>::Apply(CPU &cpu
   uint8_t value_to_store = (value_to_rotate >> 1) | (old_carry ? 0x80 : 0x00);
 
   if constexpr (MODE == AddressingMode::ZeroPage) {
-    cpu.WriteToMemory(address & 0xFF, value_to_store);
+    cpu.WriteZeroPage(address, value_to_store);
   } else if constexpr (MODE == AddressingMode::ZeroPageX) {
-    cpu.WriteToMemory((address + cpu.m_registers[Register::X]) & 0xFF, value_to_store);
+    cpu.WriteZeroPage(address + cpu.m_registers[Register::X], value_to_store);
   } else if constexpr (MODE == AddressingMode::Absolute) {
     cpu.WriteToMemory(address, value_to_store);
   } else if constexpr (MODE == AddressingMode::AbsoluteX) {
@@ -463,12 +458,12 @@ template <AddressingMode MODE> void CPU::RotateRightAndAdd<MODE>::Apply(CPU &cpu
   } else if constexpr (MODE == AddressingMode::IndirectX) {
     Addr target_addr_low = (address + cpu.m_registers[Register::X]) & 0xFF;
     Addr target_addr_high = (address + cpu.m_registers[Register::X] + 1) & 0xFF;
-    Addr real_addr = cpu.ReadFromMemory(target_addr_high) << 8 | cpu.ReadFromMemory(target_addr_low);
+    Addr real_addr = cpu.ReadZeroPage(target_addr_high) << 8 | cpu.ReadZeroPage(target_addr_low);
     cpu.WriteToMemory(real_addr, value_to_store);
   } else if constexpr (MODE == AddressingMode::IndirectY) {
     Addr target_addr_low = address & 0xFF;
     Addr target_addr_high = (address + 1) & 0xFF;
-    Addr real_addr = cpu.ReadFromMemory(target_addr_high) << 8 | cpu.ReadFromMemory(target_addr_low);
+    Addr real_addr = cpu.ReadZeroPage(target_addr_high) << 8 | cpu.ReadZeroPage(target_addr_low);
     cpu.WriteToMemory(real_addr + cpu.m_registers[Register::Y], value_to_store);
   } else {
     TODO(fmt::format("RotateRightAndAdd<{}>::Apply not implemented", magic_enum::enum_name(MODE)));
@@ -487,8 +482,7 @@ template <AddressingMode MODE> void CPU::RotateRightAndAdd<MODE>::Apply(CPU &cpu
 
   cpu.m_registers[Register::A] = result;
 
-  cpu.SetStatusFlagValue(StatusFlag::Negative, cpu.m_registers[Register::A] & 0x80);
-  cpu.SetStatusFlagValue(StatusFlag::Zero, cpu.m_registers[Register::A] == 0);
+  cpu.SetZeroAndNegative(cpu.m_registers[Register::A]);
   cpu.SetStatusFlagValue(StatusFlag::Carry, intermediate_result & 0x100);
   // Overflow if both operands are positive and result is negative, or both operands are negative and result is
   // positive.
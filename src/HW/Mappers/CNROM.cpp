@@ -0,0 +1,21 @@
+//
+// Created by Valerio Formato on 17-Oct-26.
+//
+
+#include "HW/Mappers/CNROM.h"
+
+namespace BNES::HW {
+
+void CNROM::Reset() {
+  // 16KB of PRG ROM show up twice, this takes care of the mirroring
+  MapProgramBank(0x8000, 0x4000, 0);
+  MapProgramBank(0xC000, 0x4000, 1);
+  MapCharacterBank(0x0000, 0x2000, 0);
+}
+
+bool CNROM::WriteRegister([[maybe_unused]] Addr address, uint8_t value) {
+  MapCharacterBank(0x0000, 0x2000, value);
+  return true;
+}
+
+} // namespace BNES::HW
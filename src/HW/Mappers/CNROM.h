@@ -0,0 +1,24 @@
+//
+// Created by Valerio Formato on 17-Oct-26.
+//
+
+#ifndef BNES_CNROM_H
+#define BNES_CNROM_H
+
+#include "HW/Mappers/Mapper.h"
+
+namespace BNES::HW {
+
+// Mapper 3: fixed PRG like NROM, plus a switchable 8KB CHR bank
+class CNROM : public Mapper {
+public:
+  using Mapper::Mapper;
+
+  [[nodiscard]] uint16_t Number() const override { return 3; }
+
+  void Reset() override;
+  bool WriteRegister(Addr address, uint8_t value) override;
+};
+} // namespace BNES::HW
+
+#endif // BNES_CNROM_H
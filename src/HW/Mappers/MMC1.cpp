@@ -0,0 +1,104 @@
+//
+// Created by Valerio Formato on 17-Oct-26.
+//
+
+#include "HW/Mappers/MMC1.h"
+
+namespace BNES::HW {
+
+void MMC1::Reset() {
+  m_shift_register = 0;
+  m_shift_count = 0;
+  // Power-on state: last PRG bank fixed at $C000
+  m_control = 0x0C;
+  m_chr_bank0 = 0;
+  m_chr_bank1 = 0;
+  m_prg_bank = 0;
+
+  UpdateBanks();
+}
+
+bool MMC1::WriteRegister(Addr address, uint8_t value) {
+  // Writing a value with bit 7 set resets the shift register and goes back to the power-on PRG mode
+  if (value & 0x80) {
+    m_shift_register = 0;
+    m_shift_count = 0;
+    m_control |= 0x0C;
+    UpdateBanks();
+    return true;
+  }
+
+  // Bits come in LSB first
+  m_shift_register |= (value & 0x1) << m_shift_count;
+  if (++m_shift_count < 5) {
+    return true;
+  }
+
+  switch ((address >> 13) & 0x3) {
+  case 0:
+    m_control = m_shift_register;
+    break;
+  case 1:
+    m_chr_bank0 = m_shift_register;
+    break;
+  case 2:
+    m_chr_bank1 = m_shift_register;
+    break;
+  case 3:
+    m_prg_bank = m_shift_register;
+    break;
+  }
+
+  m_shift_register = 0;
+  m_shift_count = 0;
+  UpdateBanks();
+  return true;
+}
+
+void MMC1::UpdateBanks() {
+  switch (m_control & 0x3) {
+  case 0:
+    SetMirroring(Rom::Mirroring::SingleScreenLower);
+    break;
+  case 1:
+    SetMirroring(Rom::Mirroring::SingleScreenUpper);
+    break;
+  case 2:
+    SetMirroring(Rom::Mirroring::Vertical);
+    break;
+  case 3:
+    SetMirroring(Rom::Mirroring::Horizontal);
+    break;
+  }
+
+  // Bit 4 of the PRG register disables PRG-RAM, there's none mapped yet
+  const int prg_bank = m_prg_bank & 0x0F;
+  switch ((m_control >> 2) & 0x3) {
+  case 0:
+  case 1:
+    // 32KB at a time, the low bit of the bank number is ignored
+    MapProgramBank(0x8000, 0x8000, prg_bank >> 1);
+    break;
+  case 2:
+    // First bank fixed at $8000, switchable one at $C000
+    MapProgramBank(0x8000, 0x4000, 0);
+    MapProgramBank(0xC000, 0x4000, prg_bank);
+    break;
+  case 3:
+    // Switchable bank at $8000, last one fixed at $C000
+    MapProgramBank(0x8000, 0x4000, prg_bank);
+    MapProgramBank(0xC000, 0x4000, -1);
+    break;
+  }
+
+  if (m_control & 0x10) {
+    // Two separate 4KB banks
+    MapCharacterBank(0x0000, 0x1000, m_chr_bank0);
+    MapCharacterBank(0x1000, 0x1000, m_chr_bank1);
+  } else {
+    // 8KB at a time, the low bit of the bank number is ignored
+    MapCharacterBank(0x0000, 0x2000, m_chr_bank0 >> 1);
+  }
+}
+
+} // namespace BNES::HW
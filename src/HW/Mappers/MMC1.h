@@ -0,0 +1,37 @@
+//
+// Created by Valerio Formato on 17-Oct-26.
+//
+
+#ifndef BNES_MMC1_H
+#define BNES_MMC1_H
+
+#include "HW/Mappers/Mapper.h"
+
+namespace BNES::HW {
+
+// Mapper 1 (SxROM). Registers are loaded one bit at a time through a 5-bit shift register, the address of the fifth
+// write selects which one: control ($8000), CHR bank 0 ($A000), CHR bank 1 ($C000) and PRG bank ($E000).
+// See https://www.nesdev.org/wiki/MMC1
+class MMC1 : public Mapper {
+public:
+  using Mapper::Mapper;
+
+  [[nodiscard]] uint16_t Number() const override { return 1; }
+
+  void Reset() override;
+  bool WriteRegister(Addr address, uint8_t value) override;
+
+private:
+  uint8_t m_shift_register{0};
+  uint8_t m_shift_count{0};
+
+  uint8_t m_control{0x0C};
+  uint8_t m_chr_bank0{0};
+  uint8_t m_chr_bank1{0};
+  uint8_t m_prg_bank{0};
+
+  void UpdateBanks();
+};
+} // namespace BNES::HW
+
+#endif // BNES_MMC1_H
@@ -0,0 +1,107 @@
+//
+// Created by Valerio Formato on 17-Oct-26.
+//
+
+#include "HW/Mappers/MMC3.h"
+
+namespace BNES::HW {
+
+void MMC3::Reset() {
+  m_bank_select = 0;
+  m_bank_registers = {0, 2, 4, 5, 6, 7, 0, 1};
+  m_irq_latch = 0;
+  m_irq_counter = 0;
+  m_irq_reload = false;
+  m_irq_enabled = false;
+  SetIRQ(false);
+
+  UpdateBanks();
+}
+
+bool MMC3::WriteRegister(Addr address, uint8_t value) {
+  // Registers are selected by the address range and whether the address is even or odd
+  switch (address & 0xE001) {
+  case 0x8000: // Bank select
+    m_bank_select = value;
+    UpdateBanks();
+    break;
+  case 0x8001: // Bank data
+    m_bank_registers[m_bank_select & 0x7] = value;
+    UpdateBanks();
+    break;
+  case 0xA000: // Mirroring, hardwired on four-screen boards
+    if (Cartridge().mirroring != Rom::Mirroring::FourScreen) {
+      SetMirroring((value & 0x1) ? Rom::Mirroring::Horizontal : Rom::Mirroring::Vertical);
+    }
+    break;
+  case 0xC000: // IRQ latch
+    m_irq_latch = value;
+    break;
+  case 0xC001: // IRQ reload, the counter is reloaded on the next clock
+    m_irq_counter = 0;
+    m_irq_reload = true;
+    break;
+  case 0xE000: // IRQ disable, also acknowledges a pending one
+    m_irq_enabled = false;
+    SetIRQ(false);
+    break;
+  case 0xE001: // IRQ enable
+    m_irq_enabled = true;
+    break;
+  default:
+    // PRG-RAM protection ($A001) is not emulated yet
+    break;
+  }
+
+  return true;
+}
+
+void MMC3::ClockScanlineCounter() {
+  if (m_irq_counter == 0 || m_irq_reload) {
+    m_irq_counter = m_irq_latch;
+    m_irq_reload = false;
+  } else {
+    --m_irq_counter;
+  }
+
+  // Newer MMC3 revisions: the IRQ fires whenever the counter is zero after a clock, a latch of 0 fires on every one
+  if (m_irq_counter == 0 && m_irq_enabled) {
+    SetIRQ(true);
+  }
+}
+
+std::optional<unsigned int> MMC3::ClocksUntilIRQ() const {
+  if (!m_irq_enabled) {
+    return std::nullopt;
+  }
+
+  // One clock to reload, then count down the latch
+  if (m_irq_counter == 0 || m_irq_reload) {
+    return m_irq_latch == 0 ? 1u : 1u + m_irq_latch;
+  }
+  return m_irq_counter;
+}
+
+void MMC3::UpdateBanks() {
+  // Bit 6 swaps the fixed second-to-last bank at $C000 with the R6 bank at $8000
+  if (m_bank_select & 0x40) {
+    MapProgramBank(0x8000, 0x2000, -2);
+    MapProgramBank(0xC000, 0x2000, m_bank_registers[6]);
+  } else {
+    MapProgramBank(0x8000, 0x2000, m_bank_registers[6]);
+    MapProgramBank(0xC000, 0x2000, -2);
+  }
+  MapProgramBank(0xA000, 0x2000, m_bank_registers[7]);
+  MapProgramBank(0xE000, 0x2000, -1);
+
+  // Bit 7 swaps the two pattern tables. CHR bank numbers are always in 1KB units, the 2KB banks ignore the low bit.
+  const Addr chr_inversion = (m_bank_select & 0x80) ? 0x1000 : 0x0000;
+  MapCharacterBank(0x0000 ^ chr_inversion, 0x800, m_bank_registers[0] >> 1);
+  MapCharacterBank(0x0800 ^ chr_inversion, 0x800, m_bank_registers[1] >> 1);
+  MapCharacterBank(0x1000 ^ chr_inversion, 0x400, m_bank_registers[2]);
+  MapCharacterBank(0x1400 ^ chr_inversion, 0x400, m_bank_registers[3]);
+  MapCharacterBank(0x1800 ^ chr_inversion, 0x400, m_bank_registers[4]);
+  MapCharacterBank(0x1C00 ^ chr_inversion, 0x400, m_bank_registers[5]);
+}
+
+} // namespace BNES::HW
@@ -0,0 +1,46 @@
+//
+// Created by Valerio Formato on 17-Oct-26.
+//
+
+#ifndef BNES_MMC3_H
+#define BNES_MMC3_H
+
+#include "HW/Mappers/Mapper.h"
+
+#include <array>
+
+namespace BNES::HW {
+
+// Mapper 4 (TxROM). Eight bank registers (R0-R7) are written through the bank select/bank data pair at $8000/$8001:
+// R0-R5 select the CHR banks (two 2KB and four 1KB ones), R6 and R7 two 8KB PRG banks. The other two 8KB PRG slots
+// hold the last two banks of the ROM.
+// The scanline counter is clocked on rising edges of PPU A12, which the PPU predicts rather than simulates (see
+// PPU::ScheduleEvents), and raises an IRQ when it reaches zero.
+// See https://www.nesdev.org/wiki/MMC3
+class MMC3 : public Mapper {
+public:
+  using Mapper::Mapper;
+
+  [[nodiscard]] uint16_t Number() const override { return 4; }
+
+  void Reset() override;
+  bool WriteRegister(Addr address, uint8_t value) override;
+
+  [[nodiscard]] bool CountsScanlines() const override { return true; }
+  void ClockScanlineCounter() override;
+  [[nodiscard]] std::optional<unsigned int> ClocksUntilIRQ() const override;
+
+private:
+  uint8_t m_bank_select{0};
+  std::array<uint8_t, 8> m_bank_registers{};
+
+  uint8_t m_irq_latch{0};
+  uint8_t m_irq_counter{0};
+  bool m_irq_reload{false};
+  bool m_irq_enabled{false};
+
+  void UpdateBanks();
+};
+} // namespace BNES::HW
+
+#endif // BNES_MMC3_H
@@ -0,0 +1,67 @@
+//
+// Created by Valerio Formato on 17-Oct-26.
+//
+
+#include "HW/Mappers/Mapper.h"
+#include "HW/Mappers/CNROM.h"
+#include "HW/Mappers/MMC1.h"
+#include "HW/Mappers/MMC3.h"
+#include "HW/Mappers/NROM.h"
+#include "HW/Mappers/UxROM.h"
+
+#include <optional>
+
+namespace BNES::HW {
+
+ErrorOr<std::unique_ptr<Mapper>> Mapper::FromRom(Bus &bus, const Rom &rom) {
+  switch (rom.mapper) {
+  case 0:
+    return std::make_unique<NROM>(bus, rom);
+  case 1:
+    return std::make_unique<MMC1>(bus, rom);
+  case 2:
+    return std::make_unique<UxROM>(bus, rom);
+  case 3:
+    return std::make_unique<CNROM>(bus, rom);
+  case 4:
+    return std::make_unique<MMC3>(bus, rom);
+  default:
+    return make_error(std::errc::not_supported, fmt::format("Mapper {} is not supported", rom.mapper));
+  }
+}
+
+// Where the given bank starts, if there is any memory at all
+static std::optional<size_t> BankOffset(size_t data_size, size_t size, int bank) {
+  const auto n_banks = static_cast<int>(data_size / size);
+  if (n_banks == 0) {
+    return std::nullopt;
+  }
+
+  return static_cast<size_t>(((bank % n_banks) + n_banks) % n_banks) * size;
+}
+
+void Mapper::MapProgramBank(Addr address, size_t size, int bank) {
+  const auto &program_rom = m_rom->program_rom;
+  const auto offset = BankOffset(program_rom.size(), size, bank);
+  m_bus->MapProgramBank(address, static_cast<Addr>(address + size - 1),
+                        offset ? program_rom.data() + *offset : nullptr);
+}
+
+void Mapper::MapCharacterBank(Addr address, size_t size, int bank) {
+  const auto last = static_cast<Addr>(address + size - 1);
+
+  // Boards without CHR ROM have CHR-RAM in its place, which the PPU can also write to
+  if (m_rom->character_rom.empty()) {
+    auto character_ram = m_bus->CharacterRam();
+    const auto offset = BankOffset(character_ram.size(), size, bank);
+    uint8_t *data = offset ? character_ram.data() + *offset : nullptr;
+    m_bus->MapCharacterBank(address, last, data, data);
+    return;
+  }
+
+  const auto &character_rom = m_rom->character_rom;
+  const auto offset = BankOffset(character_rom.size(), size, bank);
+  m_bus->MapCharacterBank(address, last, offset ? character_rom.data() + *offset : nullptr);
+}
+
+} // namespace BNES::HW
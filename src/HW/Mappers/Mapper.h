@@ -0,0 +1,79 @@
+//
+// Created by Valerio Formato on 17-Oct-26.
+//
+
+#ifndef BNES_MAPPER_H
+#define BNES_MAPPER_H
+
+#include "HW/Bus.h"
+#include "HW/Rom.h"
+#include "common/Types/non_owning_ptr.h"
+#include "common/Utils.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+
+namespace BNES::HW {
+
+// The cartridge hardware sitting between the console and the ROM chips. The mapper decides which PRG banks the CPU
+// sees at $8000-$FFFF and which CHR banks the PPU sees at $0000-$1FFF, and most of them let the program change that by
+// writing to registers in the PRG ROM range.
+// Bank switches only move the page pointers of the Bus around, reads never do any bank arithmetic.
+class Mapper {
+public:
+  using Addr = Bus::Addr;
+
+  Mapper() = delete;
+  explicit Mapper(Bus &bus, const Rom &rom) : m_bus{&bus}, m_rom{&rom} {}
+  virtual ~Mapper() = default;
+
+  Mapper(const Mapper &) = delete;
+  Mapper &operator=(const Mapper &) = delete;
+
+  // Builds the mapper for the iNES mapper number of the ROM
+  static ErrorOr<std::unique_ptr<Mapper>> FromRom(Bus &bus, const Rom &rom);
+
+  [[nodiscard]] virtual uint16_t Number() const = 0;
+
+  // Maps the banks selected at power-on
+  virtual void Reset() = 0;
+
+  // CPU writes to $8000-$FFFF. Returns false if the mapper has nothing listening there.
+  virtual bool WriteRegister(Addr address, uint8_t value) = 0;
+
+  // Scanline counting, for the mappers that watch PPU A12 to raise IRQs. CountsScanlines() must not change over the
+  // lifetime of the mapper, the bus only asks once.
+  [[nodiscard]] virtual bool CountsScanlines() const { return false; }
+  virtual void ClockScanlineCounter() {}
+  // How many more clocks until the IRQ is raised, nothing if it won't be
+  [[nodiscard]] virtual std::optional<unsigned int> ClocksUntilIRQ() const { return std::nullopt; }
+
+protected:
+  // Maps `size` bytes starting at `address` to the given bank, in units of `size`. Bank numbers wrap around the size
+  // of the ROM (as unconnected high bank lines do on real boards), negative ones count from the last bank.
+  // CHR banks come from CHR-RAM when the cartridge has no CHR ROM.
+  void MapProgramBank(Addr address, size_t size, int bank);
+  void MapCharacterBank(Addr address, size_t size, int bank);
+
+  // Same, a single page at a time, for memory that doesn't come in whole banks
+  void MapProgramPage(Addr address, const uint8_t *data) {
+    m_bus->MapProgramBank(address, static_cast<Addr>(address + Bus::PAGE_SIZE - 1), data);
+  }
+  void MapCharacterPage(Addr address, const uint8_t *data) {
+    m_bus->MapCharacterBank(address, static_cast<Addr>(address + Bus::CHR_PAGE_SIZE - 1), data);
+  }
+
+  void SetMirroring(Rom::Mirroring mirroring) { m_bus->SetMirroring(mirroring); }
+  void SetIRQ(bool asserted) { m_bus->SetMapperIRQ(asserted); }
+
+  [[nodiscard]] const Rom &Cartridge() const { return *m_rom; }
+
+private:
+  non_owning_ptr<Bus *> m_bus;
+  non_owning_ptr<const Rom *> m_rom;
+};
+} // namespace BNES::HW
+
+#endif // BNES_MAPPER_H
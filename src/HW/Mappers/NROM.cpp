@@ -0,0 +1,37 @@
+//
+// Created by Valerio Formato on 17-Oct-26.
+//
+
+#include "HW/Mappers/NROM.h"
+
+namespace BNES::HW {
+
+void NROM::Reset() {
+  const auto &program_rom = Cartridge().program_rom;
+  const auto &character_rom = Cartridge().character_rom;
+
+  // Mapped page by page: test programs loaded straight into the bus don't need to fill a whole bank, and the pages
+  // they don't reach read as open bus
+  for (size_t address = Bus::ROM_START_REGISTER; address <= Bus::MAX_ADDRESSABLE_ROM_ADDRESS;
+       address += Bus::PAGE_SIZE) {
+    auto offset = address - Bus::ROM_START_REGISTER;
+    // 16KB ROMs are mirrored in the upper half
+    if (program_rom.size() == 0x4000) {
+      offset %= 0x4000;
+    }
+    MapProgramPage(static_cast<Addr>(address),
+                   offset + Bus::PAGE_SIZE <= program_rom.size() ? program_rom.data() + offset : nullptr);
+  }
+
+  if (character_rom.empty()) {
+    MapCharacterBank(0x0000, 0x2000, 0);
+    return;
+  }
+
+  for (size_t address = 0; address < 0x2000; address += Bus::CHR_PAGE_SIZE) {
+    MapCharacterPage(static_cast<Addr>(address),
+                     address + Bus::CHR_PAGE_SIZE <= character_rom.size() ? character_rom.data() + address : nullptr);
+  }
+}
+
+} // namespace BNES::HW
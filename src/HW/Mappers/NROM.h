@@ -0,0 +1,24 @@
+//
+// Created by Valerio Formato on 17-Oct-26.
+//
+
+#ifndef BNES_NROM_H
+#define BNES_NROM_H
+
+#include "HW/Mappers/Mapper.h"
+
+namespace BNES::HW {
+
+// Mapper 0: no bank switching at all. 16KB or 32KB of PRG ROM (the former mirrored at $C000) and 8KB of CHR ROM.
+class NROM : public Mapper {
+public:
+  using Mapper::Mapper;
+
+  [[nodiscard]] uint16_t Number() const override { return 0; }
+
+  void Reset() override;
+  bool WriteRegister(Addr, uint8_t) override { return false; }
+};
+} // namespace BNES::HW
+
+#endif // BNES_NROM_H
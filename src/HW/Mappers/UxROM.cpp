@@ -0,0 +1,21 @@
+//
+// Created by Valerio Formato on 17-Oct-26.
+//
+
+#include "HW/Mappers/UxROM.h"
+
+namespace BNES::HW {
+
+void UxROM::Reset() {
+  MapProgramBank(0x8000, 0x4000, 0);
+  MapProgramBank(0xC000, 0x4000, -1);
+  MapCharacterBank(0x0000, 0x2000, 0);
+}
+
+bool UxROM::WriteRegister([[maybe_unused]] Addr address, uint8_t value) {
+  // Any address in $8000-$FFFF selects the bank at $8000 (UNROM only decodes 3 bits, UOROM 4, we just wrap around)
+  MapProgramBank(0x8000, 0x4000, value);
+  return true;
+}
+
+} // namespace BNES::HW
@@ -0,0 +1,24 @@
+//
+// Created by Valerio Formato on 17-Oct-26.
+//
+
+#ifndef BNES_UXROM_H
+#define BNES_UXROM_H
+
+#include "HW/Mappers/Mapper.h"
+
+namespace BNES::HW {
+
+// Mapper 2: a switchable 16KB PRG bank at $8000, with the last one fixed at $C000. CHR is not banked.
+class UxROM : public Mapper {
+public:
+  using Mapper::Mapper;
+
+  [[nodiscard]] uint16_t Number() const override { return 2; }
+
+  void Reset() override;
+  bool WriteRegister(Addr address, uint8_t value) override;
+};
+} // namespace BNES::HW
+
+#endif // BNES_UXROM_H
@@ -0,0 +1,62 @@
+//
+// Created by Valerio Formato on 17-Oct-26.
+//
+
+#ifndef BNES_OPCODEPAIRPROFILE_H
+#define BNES_OPCODEPAIRPROFILE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace BNES::HW {
+
+struct OpCodePairCount {
+  uint8_t first;
+  uint8_t second;
+  size_t count;
+};
+
+// Counts how many times each opcode is immediately followed by each other opcode. Used to pick which pairs are
+// worth fusing into superinstructions (see CPU::FusedPair).
+class OpCodePairProfile {
+public:
+  OpCodePairProfile() : m_counts(256 * 256, 0) {}
+
+  void Record(uint8_t opcode) {
+    if (m_previous) {
+      ++m_counts[(*m_previous << 8) | opcode];
+    }
+    m_previous = opcode;
+  }
+
+  // Interrupts break the sequence, the handler doesn't follow the interrupted instruction
+  void Break() { m_previous.reset(); }
+
+  // The most frequent pairs, sorted by count
+  [[nodiscard]] std::vector<OpCodePairCount> MostFrequent(size_t n) const {
+    std::vector<OpCodePairCount> pairs;
+    for (size_t i = 0; i < m_counts.size(); ++i) {
+      if (m_counts[i] > 0) {
+        pairs.push_back({static_cast<uint8_t>(i >> 8), static_cast<uint8_t>(i & 0xFF), m_counts[i]});
+      }
+    }
+
+    n = std::min(n, pairs.size());
+    std::ranges::partial_sort(pairs, pairs.begin() + static_cast<std::ptrdiff_t>(n), std::ranges::greater{},
+                              &OpCodePairCount::count);
+    pairs.resize(n);
+    return pairs;
+  }
+
+  [[nodiscard]] size_t Count(uint8_t first, uint8_t second) const { return m_counts[(first << 8) | second]; }
+
+private:
+  std::vector<size_t> m_counts;
+  std::optional<uint8_t> m_previous;
+};
+} // namespace BNES::HW
+
+#endif // BNES_OPCODEPAIRPROFILE_H
@@ -4,15 +4,23 @@
 
 #include "HW/PPU.h"
 #include "HW/Constants.h"
+#include "HW/Mappers/Mapper.h"
+#include "HW/TileDecoder.h"
 #include "common/ranges_compat.h"
 
+#include <algorithm>
 #include <bit>
-#include <bitset>
 #include <cstring>
+#include <utility>
 #include <spdlog/sinks/stdout_color_sinks.h>
 
 namespace BNES::HW {
 
+static constexpr unsigned int DOTS_PER_SCANLINE = 341;
+static constexpr unsigned int SCANLINES_PER_FRAME = 262;
+
+static constexpr bool IsRenderingScanline(unsigned int scanline) { return scanline < 240 || scanline == 261; }
+
 std::shared_ptr<spdlog::logger> PPU::s_logger = []() {
   auto logger = spdlog::get("PPU");
   if (!logger) {
@@ -32,10 +40,7 @@ std::span<const uint8_t> PPU::ActiveNametable() const {
 }
 
 std::span<const uint8_t> PPU::Nametable(uint8_t nametable_index) const {
-  // Compute the VRAM index for the selected nametable and return a span into m_vram.
-  Addr start_addr = VRAM_START_ADDRESS + static_cast<Addr>(nametable_index) * 0x400;
-  Addr vram_index = MirrorVRAMAddress(start_addr);
-  return std::span<const uint8_t>(m_vram).subspan(vram_index, 0x400);
+  return std::span<const uint8_t>(m_vram).subspan(m_nametable_pages[nametable_index & 0x3] * 0x400, 0x400);
 }
 
 std::span<const uint8_t, 4> PPU::BackgroundPalette(uint8_t index) const {
@@ -53,19 +58,31 @@ std::array<PPU::SpriteData, 64> PPU::SpriteOAMData() const {
 }
 
 PPU::TilePixelValues PPU::DecodeTile(std::span<const uint8_t> tile_chr_data) {
-  TilePixelValues tile_pixels_v{0};
-
-  for (const auto [index, byte] : rv::enumerate(tile_chr_data)) {
-    auto row_index = index % TILE_WIDTH;
-    auto bit_pos = index / TILE_WIDTH;
+  TilePixelValues tile_pixels_v;
+  TileDecoder::Decode(tile_chr_data.first(TILE_MEMORY_SIZE), tile_pixels_v);
+  return tile_pixels_v;
+}
 
-    for (size_t x = 0; x < TILE_WIDTH; ++x) {
-      bool value = std::bitset<8>(byte)[TILE_WIDTH - x - 1];
-      tile_pixels_v[row_index * TILE_WIDTH + x] |= (value << bit_pos);
+const PPU::TilePixelValues &PPU::DecodedTile(uint8_t table, uint8_t index, bool flip_horizontal,
+                                             bool flip_vertical) const {
+  const size_t slot = table * 256 + index;
+  auto &variants = (*m_decoded_tiles)[slot];
+  if (m_dirty_tiles[slot]) {
+    variants[0] = DecodeTile(PatternTile(table, index));
+    for (size_t y = 0; y < TILE_HEIGHT; ++y) {
+      for (size_t x = 0; x < TILE_WIDTH; ++x) {
+        const auto value = variants[0][y * TILE_WIDTH + x];
+        const auto flipped_x = TILE_WIDTH - x - 1;
+        const auto flipped_y = TILE_HEIGHT - y - 1;
+        variants[1][y * TILE_WIDTH + flipped_x] = value;
+        variants[2][flipped_y * TILE_WIDTH + x] = value;
+        variants[3][flipped_y * TILE_WIDTH + flipped_x] = value;
+      }
     }
+    m_dirty_tiles.reset(slot);
   }
 
-  return tile_pixels_v;
+  return variants[flip_horizontal | (flip_vertical << 1)];
 }
 
 void PPU::UpdateSprite0Hit(unsigned int cycles_to_advance) {
@@ -79,73 +96,351 @@ void PPU::UpdateSprite0Hit(unsigned int cycles_to_advance) {
     return;
   }
 
-  // sprite 0 hit cannot occur if background or sprite rendering is disabled
-  if (!RenderBackground() || !RenderSprites()) {
-    return;
+  // Where the hit happens only depends on registers and memory that invalidate it when written, so all that's left
+  // to do here is to see if we're going past it
+  const auto hit_dot = Sprite0HitDot();
+  const auto now = FrameDot();
+  if (hit_dot && *hit_dot >= now && *hit_dot < now + cycles_to_advance) {
+    m_status_register |= 0b01000000;
+  }
+}
+
+std::optional<unsigned int> PPU::Sprite0HitDot() const {
+  // A different CHR bank or a CHR-RAM write might have changed either tile
+  if (m_sprite0_chr_changes.any()) {
+    m_sprite0_chr_changes.reset();
+    m_sprite0_hit_stale = true;
   }
 
-  unsigned int current_x = m_cycles;
-  unsigned int current_y = m_current_scanline;
-  unsigned int target_x = m_cycles + cycles_to_advance;
-  unsigned int target_y = m_current_scanline;
-  if (target_x > 341) {
-    target_x -= 341;
-    target_y += 1;
+  if (m_sprite0_hit_stale) {
+    m_sprite0_hit_dot = FindSprite0Hit();
+    m_sprite0_hit_stale = false;
+  }
+  return m_sprite0_hit_dot;
+}
+
+std::optional<unsigned int> PPU::FindSprite0Hit() const {
+  // sprite 0 hit cannot occur if background or sprite rendering is disabled
+  if (!RenderBackground() || !RenderSprites()) {
+    return std::nullopt;
   }
 
-  // Get position for sprite 0
   SpriteData sprite0;
-  memcpy(&sprite0, m_oam_data.data(), sizeof(sprite0));
+  std::memcpy(&sprite0, m_oam_data.data(), sizeof(sprite0));
 
-  unsigned int sprite0_pos_x = sprite0.pos_x;
-  unsigned int sprite0_pos_y = sprite0.pos_y;
+  // pos_y in OAM is stored as actual_y - 1 (delayed by one scanline)
+  const unsigned int sprite_top = sprite0.pos_y + 1;
+  const unsigned int sprite_height = SpriteSize() ? 2 * TILE_HEIGHT : TILE_HEIGHT;
+  const bool left_clipping = !ShowBackgroundLeftBorder() || !ShowSpritesLeftBorder();
 
-  auto is_position_on_sprite = [](unsigned int x, unsigned int y, const SpriteData &sprite) {
-    // pos_y in OAM is stored as actual_y - 1 (delayed by one scanline)
-    unsigned int sprite_top = sprite.pos_y + 1;
-    return x >= sprite.pos_x && x < sprite.pos_x + TILE_WIDTH && y >= sprite_top && y < sprite_top + TILE_HEIGHT;
-  };
+  // Pixels are looked at in the order they are drawn, the first overlap is the hit
+  for (unsigned int row = 0; row < sprite_height && sprite_top + row < NES_SCREEN_H; ++row) {
+    const unsigned int y = sprite_top + row;
+    const uint8_t *sprite_row = SpriteRow(sprite0, row);
 
-  // are we intersecting sprite0?
-  if (is_position_on_sprite(current_x, current_y, sprite0) || is_position_on_sprite(target_x, target_y, sprite0)) {
-    for (unsigned int i_pix = 0; i_pix < cycles_to_advance; ++i_pix) {
-      auto x = current_x + i_pix;
-      auto y = current_y;
-      if (x > 341) {
-        x -= 341;
-        y += 1;
-      }
+    for (unsigned int column = 0; column < TILE_WIDTH; ++column) {
+      const unsigned int x = sprite0.pos_x + column;
 
-      if (!is_position_on_sprite(x, y, sprite0)) {
+      // sprite 0 hit never occurs at x=255, or at x=0..7 when left-side clipping is active
+      if (x >= NES_SCREEN_W - 1) {
+        break;
+      }
+      if (x < TILE_WIDTH && left_clipping) {
         continue;
       }
 
-      // sprite 0 hit never occurs at x=255, or at x=0..7 when left-side clipping is active
-      if (x == 255 || (x <= 7 && (!ShowBackgroundLeftBorder() || !ShowSpritesLeftBorder()))) {
+      if (sprite_row[column] && BackgroundPixel(x, y)) {
+        return y * DOTS_PER_SCANLINE + x;
+      }
+    }
+  }
+
+  return std::nullopt;
+}
+
+const uint8_t *PPU::SpriteRow(const SpriteData &sprite, unsigned int row) const {
+  const unsigned int sprite_height = SpriteSize() ? 2 * TILE_HEIGHT : TILE_HEIGHT;
+  const unsigned int tile_row = sprite.flip_vertical ? sprite_height - row - 1 : row;
+
+  // 8x16 sprites take the pattern table from bit 0 of the tile index, the bottom half is the next tile
+  const uint8_t table = SpriteSize() ? sprite.tile_index & 0x1 : SpritePatternTableAddress();
+  const uint8_t tile_index = SpriteSize() ? (sprite.tile_index & 0xFE) + tile_row / TILE_HEIGHT : sprite.tile_index;
+  return DecodedTile(table, tile_index, sprite.flip_horizontal).data() + (tile_row % TILE_HEIGHT) * TILE_WIDTH;
+}
+
+unsigned int PPU::ScrollX() const { return (m_ppu_scroll_x & 0xFF) + (m_control_register & 0x1) * NES_SCREEN_W; }
+
+uint8_t PPU::BackgroundPixel(unsigned int x, unsigned int y) const {
+  // The four nametables make up a 512x480 plane the scroll position moves around on
+  const unsigned int plane_x = (ScrollX() + x) % (2 * NES_SCREEN_W);
+  const unsigned int plane_y = (m_scroll_y + y) % (2 * NES_SCREEN_H);
+
+  const auto nametable = Nametable(plane_x / NES_SCREEN_W + 2 * (plane_y / NES_SCREEN_H));
+  const auto tile_index =
+      nametable[(plane_y % NES_SCREEN_H) / TILE_HEIGHT * 32 + (plane_x % NES_SCREEN_W) / TILE_WIDTH];
+  return DecodedTile(BankIndex(), tile_index)[(plane_y % TILE_HEIGHT) * TILE_WIDTH + plane_x % TILE_WIDTH];
+}
+
+void PPU::RenderScanlines(unsigned int cycles_to_advance) {
+  // Each visible scanline is drawn once its last pixel is output (dot 256), with the settings of that moment. The
+  // vertical scroll is reloaded on the pre-render scanline, writes to it during the frame only count for the next one.
+  const auto end = static_cast<unsigned int>(m_cycles) + cycles_to_advance;
+  unsigned int scanline = m_current_scanline;
+  for (unsigned int line_start = 0; line_start < end; line_start += DOTS_PER_SCANLINE) {
+    if (scanline < NES_SCREEN_H && line_start + 256 >= m_cycles && line_start + 256 < end) {
+      RenderScanline(scanline);
+    } else if (scanline == 261 && line_start + 280 >= m_cycles && line_start + 280 < end) {
+      m_scroll_y = (m_ppu_scroll_y & 0xFF) + ((m_control_register >> 1) & 0x1) * NES_SCREEN_H;
+      m_sprite0_hit_stale = true;
+    }
+    scanline = (scanline + 1) % SCANLINES_PER_FRAME;
+  }
+}
+
+void PPU::RenderScanline(unsigned int scanline) {
+  // Palette RAM offsets of the background (0-15) and sprite (16-31) pixels, 0 where transparent
+  std::array<uint8_t, NES_SCREEN_W> background{};
+  std::array<uint8_t, NES_SCREEN_W> sprites{};
+  std::array<bool, NES_SCREEN_W> sprite_behind_background{};
+
+  if (RenderBackground()) {
+    CheckBackgroundPatterns();
+
+    const unsigned int plane_x = ScrollX();
+    const unsigned int plane_y = (m_scroll_y + scanline) % (2 * NES_SCREEN_H);
+    const unsigned int y = plane_y % NES_SCREEN_H;
+    const std::array nametables{VRAMNametable(2 * (plane_y / NES_SCREEN_H)),
+                                VRAMNametable(2 * (plane_y / NES_SCREEN_H) + 1)};
+    for (auto nametable : nametables) {
+      RedrawDirtyTiles(nametable, y / TILE_HEIGHT);
+    }
+
+    // The line starts plane_x pixels into the left nametable and wraps around to the start of it from the right one
+    const unsigned int start = plane_x % (2 * NES_SCREEN_W);
+    const auto &images = *m_nametable_images;
+    const uint8_t *first = images[nametables[start / NES_SCREEN_W]].pixels.data() + y * NES_SCREEN_W;
+    const uint8_t *second = images[nametables[1 - start / NES_SCREEN_W]].pixels.data() + y * NES_SCREEN_W;
+    const unsigned int first_pixels = NES_SCREEN_W - start % NES_SCREEN_W;
+    std::copy_n(first + start % NES_SCREEN_W, first_pixels, background.begin());
+    std::copy_n(second, NES_SCREEN_W - first_pixels, background.begin() + first_pixels);
+
+    if (!ShowBackgroundLeftBorder()) {
+      std::fill_n(background.begin(), TILE_WIDTH, 0);
+    }
+  }
+
+  if (RenderSprites()) {
+    const unsigned int sprite_height = SpriteSize() ? 2 * TILE_HEIGHT : TILE_HEIGHT;
+    const unsigned int first_x = ShowSpritesLeftBorder() ? 0 : TILE_WIDTH;
+
+    // Only the first 8 sprites on the line are drawn, and where they overlap the one that comes first in OAM wins
+    unsigned int sprites_on_line = 0;
+    for (const auto &sprite : SpriteOAMData()) {
+      const unsigned int sprite_top = sprite.pos_y + 1;
+      if (scanline < sprite_top || scanline >= sprite_top + sprite_height) {
         continue;
       }
+      if (++sprites_on_line > 8) {
+        break;
+      }
 
-      auto chr_tiles = CharacterRom() | rv::chunk(TILE_MEMORY_SIZE);
+      const uint8_t *row = SpriteRow(sprite, scanline - sprite_top);
+      for (unsigned int pixel = 0; pixel < TILE_WIDTH; ++pixel) {
+        const unsigned int x = sprite.pos_x + pixel;
+        if (x >= NES_SCREEN_W) {
+          break;
+        }
+        if (x >= first_x && row[pixel] && !sprites[x]) {
+          sprites[x] = 0x10 + sprite.palette_idx * 4 + row[pixel];
+          sprite_behind_background[x] = sprite.priority;
+        }
+      }
+    }
+  }
 
-      const auto nametable = ActiveNametable().subspan(0, 960);
-      unsigned int bkg_tile_idx = (x / TILE_WIDTH) + (y / TILE_HEIGHT) * 32;
-      const auto bkg_tile = chr_tiles[256 * BankIndex() + nametable[bkg_tile_idx]];
-      TilePixelValues bkg_tile_data = DecodeTile(bkg_tile);
+  // Transparent pixels show the backdrop color at $3F00
+  auto line = std::span{(*m_screen_buffers)[m_drawing_buffer]}.subspan(scanline * NES_SCREEN_W, NES_SCREEN_W);
+  for (unsigned int x = 0; x < NES_SCREEN_W; ++x) {
+    const bool sprite_visible = sprites[x] && (!sprite_behind_background[x] || !background[x]);
+    line[x] = m_palette_table[sprite_visible ? sprites[x] : background[x]] & 0x3F;
+  }
+  m_mask_buffers[m_drawing_buffer][scanline] = m_mask_register;
 
-      const auto sprite_raw = chr_tiles[256 * SpritePatternTableAddress() + sprite0.tile_index];
-      TilePixelValues sprite_data = DecodeTile(sprite_raw);
+  if (scanline == NES_SCREEN_H - 1) {
+    m_tiles_redrawn_last_frame = std::exchange(m_tiles_redrawn, 0);
+    m_drawing_buffer ^= 1;
+  }
+}
 
-      const auto bkg_pos_x = (bkg_tile_idx * TILE_WIDTH) % NES_SCREEN_W;
-      const auto bkg_pos_y = (bkg_tile_idx / (NES_SCREEN_W / TILE_WIDTH)) * TILE_HEIGHT;
+void PPU::MarkNametableDirty(Addr vram_index) {
+  auto &dirty_rows = (*m_nametable_images)[vram_index / 0x400].dirty_rows;
+  const unsigned int offset = vram_index % 0x400;
+  if (offset < 0x3C0) {
+    dirty_rows[offset / 32] |= 1u << (offset % 32);
+    return;
+  }
+
+  // Each attribute byte covers 4x4 tiles, only half of them on the last row
+  const unsigned int first_row = (offset - 0x3C0) / 8 * 4;
+  const unsigned int first_column = (offset - 0x3C0) % 8 * 4;
+  for (unsigned int row = first_row; row < std::min(first_row + 4, 30u); ++row) {
+    dirty_rows[row] |= 0xFu << first_column;
+  }
+}
 
-      auto sprite_pix_idx = x - sprite0.pos_x + (y - (sprite0.pos_y + 1)) * TILE_WIDTH;
-      auto bkg_tile_pix_idx = x - bkg_pos_x + (y - bkg_pos_y) * TILE_WIDTH;
+void PPU::CheckBackgroundPatterns() {
+  if (BankIndex() != m_nametable_images_bank) {
+    m_nametable_images_bank = BankIndex();
+    for (auto &image : *m_nametable_images) {
+      image.dirty_rows.fill(ALL_TILES_IN_ROW);
+    }
+    m_background_chr_changes.reset();
+    return;
+  }
 
-      // finally, let's check if both pixels are opaque and set the sprite0 hit flag
-      if (sprite_data[sprite_pix_idx] && bkg_tile_data[bkg_tile_pix_idx]) {
-        m_status_register |= 0b01000000;
+  // Changes to the other pattern table don't matter until the bank is switched, and then everything is redrawn
+  if (m_background_chr_changes.none()) {
+    return;
+  }
+  const unsigned int first_tile = m_nametable_images_bank * 256;
+  for (unsigned int nametable = 0; nametable < m_nametable_images->size(); ++nametable) {
+    for (unsigned int entry = 0; entry < 0x3C0; ++entry) {
+      if (m_background_chr_changes[first_tile + m_vram[nametable * 0x400 + entry]]) {
+        (*m_nametable_images)[nametable].dirty_rows[entry / 32] |= 1u << (entry % 32);
+      }
+    }
+  }
+  m_background_chr_changes.reset();
+}
+
+void PPU::RedrawDirtyTiles(unsigned int vram_nametable, unsigned int tile_row) {
+  auto &image = (*m_nametable_images)[vram_nametable];
+  const uint8_t *nametable = m_vram.data() + vram_nametable * 0x400;
+
+  for (uint32_t dirty = std::exchange(image.dirty_rows[tile_row], 0); dirty; dirty &= dirty - 1) {
+    const unsigned int tile_x = std::countr_zero(dirty);
+    const uint8_t attribute = nametable[0x3C0 + (tile_row / 4) * 8 + tile_x / 4];
+    const uint8_t palette = (attribute >> (((tile_row & 0x2) << 1) | (tile_x & 0x2))) & 0x3;
+    const auto &tile = DecodedTile(m_nametable_images_bank, nametable[tile_row * 32 + tile_x]);
+
+    uint8_t *pixels = image.pixels.data() + tile_row * TILE_HEIGHT * NES_SCREEN_W + tile_x * TILE_WIDTH;
+    for (unsigned int row = 0; row < TILE_HEIGHT; ++row, pixels += NES_SCREEN_W) {
+      for (unsigned int pixel = 0; pixel < TILE_WIDTH; ++pixel) {
+        const uint8_t value = tile[row * TILE_WIDTH + pixel];
+        pixels[pixel] = value ? palette * 4 + value : 0;
       }
     }
+    ++m_tiles_redrawn;
+  }
+}
+
+void PPU::ScheduleEvents(Scheduler &scheduler) const {
+  auto dots_until_scanline = [this](unsigned int scanline) {
+    unsigned int lines = (scanline + SCANLINES_PER_FRAME - m_current_scanline) % SCANLINES_PER_FRAME;
+    if (lines == 0) {
+      lines = SCANLINES_PER_FRAME;
+    }
+    return lines * DOTS_PER_SCANLINE - static_cast<unsigned int>(m_cycles);
+  };
+
+  const auto now = scheduler.Now();
+  scheduler.Schedule(Event::VBlankStart, now + dots_until_scanline(241));
+  scheduler.Schedule(Event::PreRender, now + dots_until_scanline(261));
+  scheduler.Schedule(Event::FrameEnd, now + dots_until_scanline(0));
+
+  // OAMADDR is reset during ticks 257-320 of rendering scanlines, which only matters if it's not zero already
+  if (m_oam_address != 0) {
+    if ((m_current_scanline < 241 || m_current_scanline == 261) && m_cycles < 257) {
+      scheduler.Schedule(Event::OAMAddrReset, now + 257 - m_cycles);
+    } else {
+      scheduler.Schedule(Event::OAMAddrReset, now + dots_until_scanline(m_current_scanline + 1) + 257);
+    }
+  } else {
+    scheduler.Cancel(Event::OAMAddrReset);
+  }
+
+  // The sprite 0 hit position is known in advance, we only need to get there in time
+  std::optional<unsigned int> hit_dot;
+  if (!(m_status_register & 0b01000000)) {
+    hit_dot = Sprite0HitDot();
+  }
+  if (hit_dot && *hit_dot >= FrameDot()) {
+    scheduler.Schedule(Event::Sprite0, now + *hit_dot - FrameDot() + 1);
+  } else {
+    scheduler.Cancel(Event::Sprite0);
+  }
+
+  // The mapper IRQ lands on a known A12 edge, which can only move when the rendering settings or the mapper registers
+  // are written, and both sync the PPU
+  std::optional<unsigned int> irq_dots;
+  if (m_bus->HasScanlineCounter()) {
+    if (const auto clocks = m_bus->CartridgeMapper()->ClocksUntilIRQ()) {
+      irq_dots = DotsUntilA12Edges(*clocks);
+    }
+  }
+  if (irq_dots) {
+    scheduler.Schedule(Event::MapperIRQ, now + *irq_dots);
+  } else {
+    scheduler.Cancel(Event::MapperIRQ);
+  }
+}
+
+std::optional<unsigned int> PPU::A12RisingEdgeDot() const {
+  // NOTE: from NESDev:
+  //       The MMC3 scanline counter is based entirely on PPU A12, triggered on a rising edge after the line has
+  //       remained low for three falling edges of M2.
+  //       Nametable fetches keep A12 low for too little to count, so what's left is the switch between the pattern
+  //       tables: sprite tiles are fetched during dots 257-320, the first two background tiles of the next line
+  //       during dots 321-336. In 8x16 mode the unused sprite slots fetch tile $FF, which lives in the $1000 table.
+  if (!RenderBackground() && !RenderSprites()) {
+    return std::nullopt;
+  }
+
+  const bool sprites_high = SpriteSize() || SpritePatternTableAddress();
+  const bool background_high = BackgroundPatternTableAddress();
+  if (sprites_high && !background_high) {
+    return 260;
+  }
+  if (background_high && !sprites_high) {
+    return 324;
+  }
+
+  // Both on the same table, A12 never stays low long enough
+  return std::nullopt;
+}
+
+std::optional<unsigned int> PPU::DotsUntilA12Edges(unsigned int edges) const {
+  const auto edge_dot = A12RisingEdgeDot();
+  if (!edge_dot || edges == 0) {
+    return std::nullopt;
+  }
+
+  // Dots are counted from the start of the current scanline. The edge counts once the PPU has gone past it.
+  unsigned int scanline = m_current_scanline;
+  for (unsigned int line_start = 0;; line_start += DOTS_PER_SCANLINE) {
+    const unsigned int edge = line_start + *edge_dot;
+    if (IsRenderingScanline(scanline) && edge >= m_cycles && --edges == 0) {
+      return edge - static_cast<unsigned int>(m_cycles) + 1;
+    }
+    scanline = (scanline + 1) % SCANLINES_PER_FRAME;
+  }
+}
+
+void PPU::ClockA12Edges(unsigned int cycles_to_advance) {
+  const auto edge_dot = A12RisingEdgeDot();
+  if (!edge_dot) {
+    return;
+  }
+
+  // At most one edge per scanline, so we only need to look at the scanlines we're about to go through
+  const auto end = static_cast<unsigned int>(m_cycles) + cycles_to_advance;
+  unsigned int scanline = m_current_scanline;
+  for (unsigned int line_start = 0; line_start < end; line_start += DOTS_PER_SCANLINE) {
+    const unsigned int edge = line_start + *edge_dot;
+    if (IsRenderingScanline(scanline) && edge >= m_cycles && edge < end) {
+      m_bus->ClockScanlineCounter();
+    }
+    scanline = (scanline + 1) % SCANLINES_PER_FRAME;
   }
 }
 
@@ -153,6 +448,10 @@ void PPU::Tick(unsigned int cycles) {
   static std::chrono::time_point<std::chrono::steady_clock> last_time = std::chrono::steady_clock::now();
 
   UpdateSprite0Hit(cycles);
+  RenderScanlines(cycles);
+  if (m_bus->HasScanlineCounter()) {
+    ClockA12Edges(cycles);
+  }
 
   m_cycles += cycles;
 
@@ -171,13 +470,13 @@ void PPU::Tick(unsigned int cycles) {
 
     if (m_current_scanline == 241) {
       m_status_register |= 0b10000000;
+      m_bus->SignalFrameComplete();
       if (VblankNMIEnabled()) {
         const auto now = std::chrono::steady_clock::now();
         m_last_frame_time = now - last_time;
         last_time = now;
 
-        m_bus->PropagateNMI();
-        m_cycles += 7 * 3; // NMI takes 7 CPU cycles to process
+        m_bus->RaiseNMI();
       }
     }
 
@@ -214,6 +513,7 @@ void PPU::WritePPUSCROLL(uint8_t value) {
   } else {
     m_ppu_scroll_y = value | ((m_control_register & 0x2) << 8);
   }
+  m_sprite0_hit_stale = true;
 
   m_internal_registers[Register::W] = 1 - m_internal_registers[Register::W];
 }
@@ -225,6 +525,7 @@ void PPU::WritePPUCTRL(uint8_t value) {
   bool last_vblank_nmi_enabled = VblankNMIEnabled();
 
   m_control_register = value;
+  m_sprite0_hit_stale = true;
 
   if (VRAMAddressIncrement()) {
     m_vram_address_increment = 32;
@@ -236,41 +537,50 @@ void PPU::WritePPUCTRL(uint8_t value) {
   //  - PPU is VBLANK state
   //  - "Generate NMI" bit in the control Register is updated from 0 to 1.
   if (!last_vblank_nmi_enabled && VblankNMIEnabled() && IsInVblank()) {
-    m_bus->PropagateNMI();
+    m_bus->RaiseNMI();
   }
 }
 
-PPU::Addr PPU::MirrorVRAMAddress(Addr address) const {
-  Addr mirrored_vram = address & 0b10111111111111;
-  Addr vram_index = mirrored_vram - VRAM_START_ADDRESS;
-  uint8_t name_table = vram_index / 0x400;
-
-  if (m_mirroring == Rom::Mirroring::Vertical && (name_table == 2 || name_table == 3)) {
-    return vram_index - 0x800;
-  }
-
-  if (m_mirroring == Rom::Mirroring::Horizontal && (name_table == 2 || name_table == 1)) {
-    return vram_index - 0x400;
+void PPU::SetMirroring(Rom::Mirroring mirroring) {
+  switch (mirroring) {
+  case Rom::Mirroring::Vertical:
+    m_nametable_pages = {0, 1, 0, 1};
+    break;
+  case Rom::Mirroring::Horizontal:
+    m_nametable_pages = {0, 0, 1, 1};
+    break;
+  case Rom::Mirroring::FourScreen:
+    m_nametable_pages = {0, 1, 2, 3};
+    break;
+  case Rom::Mirroring::SingleScreenLower:
+    m_nametable_pages = {0, 0, 0, 0};
+    break;
+  case Rom::Mirroring::SingleScreenUpper:
+    m_nametable_pages = {1, 1, 1, 1};
+    break;
   }
-
-  if (m_mirroring == Rom::Mirroring::Horizontal && name_table == 3) {
-    return vram_index - 0x800;
-  }
-
-  return vram_index;
+  m_sprite0_hit_stale = true;
 }
 
-void PPU::WritePPUDATA(uint8_t value) {
-  if (m_address_register < VRAM_START_ADDRESS) {
-    throw std::runtime_error(
-        fmt::format("Invalid write to PPUADDR value {} - Inside character ROM", m_address_register));
-  }
+void PPU::WritePPUDATA(uint8_t value) noexcept {
+  // The PPU address bus is 14 bits wide, everything above is a mirror
+  const Addr address = m_address_register & 0x3FFF;
 
-  if (m_address_register >= VRAM_START_ADDRESS && m_address_register <= MAX_ADDRESSABLE_VRAM_ADDRESS) {
-    m_vram[MirrorVRAMAddress(m_address_register)] = value;
-  } else if (m_address_register >= PALETTE_TABLE_START_ADDRESS &&
-             m_address_register <= MAX_ADDRESSABLE_PALETTE_TABLE_ADDRESS) {
-    uint16_t palette_offset = (m_address_register - PALETTE_TABLE_START_ADDRESS) % 0x20;
+  if (address <= MAX_ADDRESSABLE_CHR_ROM_ADDRESS) {
+    // CHR-RAM takes the write, CHR ROM has nothing to write to. Games do this while clearing VRAM, or by mistake.
+    if (!m_bus->WriteCharacter(address, value)) {
+      ++m_ignored_chr_writes;
+    }
+  } else if (address < PALETTE_TABLE_START_ADDRESS) {
+    // $3000-$3EFF mirror the nametables. Games often write the same value again, which doesn't need any redrawing.
+    const Addr vram_index = MirrorVRAMAddress(address);
+    if (m_vram[vram_index] != value) {
+      m_vram[vram_index] = value;
+      MarkNametableDirty(vram_index);
+      m_sprite0_hit_stale = true;
+    }
+  } else {
+    uint16_t palette_offset = (address - PALETTE_TABLE_START_ADDRESS) % 0x20;
     m_palette_table[palette_offset] = value;
   }
 
@@ -280,6 +590,7 @@ void PPU::WritePPUDATA(uint8_t value) {
 void PPU::WritePPUMASK(uint8_t value) {
   // TODO: After power/reset, writes to this register are ignored until the first pre-render scanline.
   m_mask_register = value;
+  m_sprite0_hit_stale = true;
 }
 
 void PPU::WriteOAMADDR(uint8_t value) { m_oam_address = value; }
@@ -298,32 +609,36 @@ void PPU::WriteOAMDATA(uint8_t value) {
   if (!RenderingInProgress()) {
     m_oam_data[m_oam_address] = value;
     m_oam_address = (m_oam_address + 1);
+    m_sprite0_hit_stale = true;
   } else {
     m_oam_address = (m_oam_address + 4);
   }
 }
 
-void PPU::OAMDMATransfer(std::span<const uint8_t, 256> oam_data) { rg::copy(oam_data, m_oam_data.begin()); }
+void PPU::OAMDMATransfer(std::span<const uint8_t, 256> oam_data) {
+  rg::copy(oam_data, m_oam_data.begin());
+  m_sprite0_hit_stale = true;
+}
 
-uint8_t PPU::ReadPPUDATA() {
+uint8_t PPU::ReadPPUDATA() noexcept {
   uint8_t value_to_return{m_read_buffer};
-
-  if (m_address_register <= MAX_ADDRESSABLE_CHR_ROM_ADDRESS) {
-    m_read_buffer = m_character_rom[m_address_register];
-  } else if (m_address_register >= VRAM_START_ADDRESS && m_address_register <= MAX_ADDRESSABLE_VRAM_ADDRESS) {
-    m_read_buffer = m_vram[MirrorVRAMAddress(m_address_register)];
-  } else if (m_address_register >= PALETTE_TABLE_START_ADDRESS &&
-             m_address_register <= MAX_ADDRESSABLE_PALETTE_TABLE_ADDRESS) {
-    uint16_t palette_offset = (m_address_register - PALETTE_TABLE_START_ADDRESS) % 0x20;
+  // The PPU address bus is 14 bits wide, everything above is a mirror
+  const Addr address = m_address_register & 0x3FFF;
+
+  if (address <= MAX_ADDRESSABLE_CHR_ROM_ADDRESS) {
+    m_read_buffer = m_bus->ReadCharacter(address);
+  } else if (address < PALETTE_TABLE_START_ADDRESS) {
+    // $3000-$3EFF mirror the nametables
+    m_read_buffer = m_vram[MirrorVRAMAddress(address)];
+  } else {
+    uint16_t palette_offset = (address - PALETTE_TABLE_START_ADDRESS) % 0x20;
     value_to_return = m_palette_table[palette_offset];
     // Palette reads also update the buffer with the "underneath" nametable memory
     // $3Fxx maps to $2Fxx underneath (following $3xxx -> $2xxx mirror pattern)
 
     // TODO: check this if possible. Not sure how this interacts with different mirrorings
-    Addr underlying_address = m_address_register - 0x1000;
+    Addr underlying_address = address - 0x1000;
     m_read_buffer = m_vram[MirrorVRAMAddress(underlying_address)];
-  } else {
-    throw std::runtime_error(fmt::format("Invalid read of PPUADDR value {}", m_address_register));
   }
 
   m_address_register += m_vram_address_increment;
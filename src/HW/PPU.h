@@ -6,12 +6,15 @@
 #define BNES_PPU_H
 
 #include "HW/Bus.h"
+#include "HW/Scheduler.h"
 #include "common/Types/EnumArray.h"
 
 #include <spdlog/sinks/stdout_color_sinks.h>
 
 #include <array>
 #include <cstdint>
+#include <memory>
+#include <optional>
 #include <span>
 
 namespace BNES::Tools {
@@ -49,13 +52,26 @@ public:
   };
 
   PPU() = delete;
-  explicit PPU(Bus &bus) : m_bus{&bus} { m_bus->Attach(this); };
-
-  void Init() {
-    m_mirroring = m_bus->Rom().mirroring;
-    m_character_rom = m_bus->Rom().character_rom;
+  explicit PPU(Bus &bus) : m_bus{&bus} {
+    m_bus->Attach(this);
+    m_bus->TrackCharacterTiles(&m_dirty_tiles);
+    m_bus->TrackCharacterTiles(&m_sprite0_chr_changes);
+    m_bus->TrackCharacterTiles(&m_background_chr_changes);
+    for (auto &image : *m_nametable_images) {
+      image.dirty_rows.fill(ALL_TILES_IN_ROW);
+    }
+  };
+  ~PPU() {
+    m_bus->UntrackCharacterTiles(&m_dirty_tiles);
+    m_bus->UntrackCharacterTiles(&m_sprite0_chr_changes);
+    m_bus->UntrackCharacterTiles(&m_background_chr_changes);
   }
 
+  PPU(const PPU &) = delete;
+  PPU &operator=(const PPU &) = delete;
+
+  void Init() { SetMirroring(m_bus->NametableMirroring()); }
+
   [[nodiscard]] EnumArray<uint16_t, Register> InternalRegisters() const { return m_internal_registers; };
 
   [[nodiscard]] bool IsGrayScale() const { return m_mask_register & 0b00000001; }
@@ -68,9 +84,19 @@ public:
 
   [[nodiscard]] uint16_t CurrentScanline() const { return m_current_scanline; }
   [[nodiscard]] size_t Cycles() const { return m_cycles; }
+  // PPUDATA writes that landed on CHR ROM and were dropped
+  [[nodiscard]] size_t IgnoredCHRWrites() const { return m_ignored_chr_writes; }
+
+  // Registers the deadlines of everything the CPU could notice (vblank/NMI, sprite-0 check, OAMADDR reset), taking
+  // the current time of the scheduler as the current PPU position. Up to the first of them the PPU can be advanced in
+  // one go without changing the outcome compared to ticking it after every CPU instruction.
+  void ScheduleEvents(Scheduler &scheduler) const;
   [[nodiscard]] uint8_t BankIndex() const { return (m_control_register & 0b00010000) != 0; }
 
-  [[nodiscard]] std::span<const uint8_t> CharacterRom() const { return m_character_rom; }
+  // Pattern tables are banked by the cartridge mapper, tiles are looked up through the bus CHR page table
+  [[nodiscard]] std::span<const uint8_t, TILE_MEMORY_SIZE> PatternTile(uint8_t table, uint8_t index) const {
+    return m_bus->CharacterTile(table * 0x1000 + index * TILE_MEMORY_SIZE);
+  }
   [[nodiscard]] std::span<const uint8_t> ActiveNametable() const;
   [[nodiscard]] std::span<const uint8_t> Nametable(uint8_t index) const;
   [[nodiscard]] uint8_t BackgroundColor() const { return m_palette_table[0]; };
@@ -78,22 +104,43 @@ public:
   [[nodiscard]] std::span<const uint8_t, 4> BackgroundPalette(uint8_t index) const;
   [[nodiscard]] std::span<const uint8_t, 4> SpritePalette(uint8_t index) const;
 
+  // The last complete frame, one color index (of the 64 the NES can output) per pixel. Scanlines are drawn into a
+  // second buffer as the PPU goes through them, and the two are swapped once the last one is done, so the picture
+  // never mixes two frames.
+  [[nodiscard]] std::span<const uint8_t, 256 * 240> ScreenData() const {
+    return (*m_screen_buffers)[m_drawing_buffer ^ 1];
+  }
+  // PPUMASK as it was when each line of ScreenData was drawn. Bits 5-7 are the color emphasis and bit 0 grayscale,
+  // which apply on top of the color index.
+  [[nodiscard]] std::span<const uint8_t, 240> ScanlineMasks() const { return m_mask_buffers[m_drawing_buffer ^ 1]; }
+  // Background tiles drawn again during the last frame. The background of every nametable is kept from one frame to
+  // the next, and only tiles whose nametable entry, attribute or pattern changed since are drawn again.
+  [[nodiscard]] unsigned int TilesRedrawn() const { return m_tiles_redrawn_last_frame; }
+
   using TilePixelValues = std::array<uint8_t, TILE_WIDTH * TILE_HEIGHT>;
   static TilePixelValues DecodeTile(std::span<const uint8_t> tile_chr_data);
 
+  // Pixel values of a pattern table tile as currently banked in, optionally flipped the way sprites can be. Tiles are
+  // decoded once and kept until the bus reports them as changed (new cartridge, CHR bank switch or CHR-RAM write).
+  [[nodiscard]] const TilePixelValues &DecodedTile(uint8_t table, uint8_t index, bool flip_horizontal = false,
+                                                   bool flip_vertical = false) const;
+
 protected:
   void Tick(unsigned int cycles);
 
+  // Called by the bus when the cartridge or the mapper switches the nametable layout
+  void SetMirroring(Rom::Mirroring mirroring);
+
   void WritePPUADDR(uint8_t value);
   void WritePPUCTRL(uint8_t value);
-  void WritePPUDATA(uint8_t value);
+  void WritePPUDATA(uint8_t value) noexcept;
   void WritePPUMASK(uint8_t value);
   void WritePPUSCROLL(uint8_t value);
   void WriteOAMADDR(uint8_t value);
   void WriteOAMDATA(uint8_t value);
   void OAMDMATransfer(std::span<const uint8_t, 256> oam_data);
 
-  [[nodiscard]] uint8_t ReadPPUDATA();
+  [[nodiscard]] uint8_t ReadPPUDATA() noexcept;
   [[nodiscard]] uint8_t ReadPPUSTATUS();
   [[nodiscard]] uint8_t ReadOAMDATA();
 
@@ -112,21 +159,40 @@ protected:
   [[nodiscard]] bool IsInVblank() const { return m_status_register & 0b10000000; };
 
   void UpdateSprite0Hit(unsigned int cycles_to_advance);
+  // Dot of the frame (scanline * 341 + dot) where sprite 0 hits the background, if it does at all. It's computed
+  // again only after OAM, PPUCTRL, PPUMASK, the scroll, the nametables or the pattern tables change.
+  [[nodiscard]] std::optional<unsigned int> Sprite0HitDot() const;
+
+  void RenderScanlines(unsigned int cycles_to_advance);
+  void RenderScanline(unsigned int scanline);
+
+  // A12 is the pattern table select line. Rather than simulating every fetch, we derive the dot of the A12 rising edge
+  // (as seen through the MMC3 filter) on rendering scanlines from the pattern tables used by background and sprites.
+  [[nodiscard]] std::optional<unsigned int> A12RisingEdgeDot() const;
+  [[nodiscard]] std::optional<unsigned int> DotsUntilA12Edges(unsigned int edges) const;
+  void ClockA12Edges(unsigned int cycles_to_advance);
 
   // Protected members for testing
   std::array<uint8_t, 32> m_palette_table{0};
-  std::array<uint8_t, 0x800> m_vram{0};
-  std::array<uint8_t, 256 * 240> m_screen_data{0};
+  // 2KB in the console, the other two nametables are only there for four-screen cartridges
+  std::array<uint8_t, 0x1000> m_vram{0};
+  // The frame being drawn and the last complete one, see ScreenData. This and the other images of the screen are
+  // allocated apart, together they would make the PPU half a megabyte large.
+  using ScreenBuffers = std::array<std::array<uint8_t, 256 * 240>, 2>;
+  std::unique_ptr<ScreenBuffers> m_screen_buffers{std::make_unique<ScreenBuffers>()};
+  std::array<std::array<uint8_t, 240>, 2> m_mask_buffers{};
+  unsigned int m_drawing_buffer{0};
 
 private:
   size_t m_cycles{0};
+  size_t m_ignored_chr_writes{0};
   uint16_t m_current_scanline{0};
 
   non_owning_ptr<Bus *> m_bus;
 
-  Rom::Mirroring m_mirroring{Rom::Mirroring::Vertical};
+  // Which 1KB page of VRAM each of the four nametables maps to, as set by the mirroring
+  std::array<uint8_t, 4> m_nametable_pages{0, 1, 0, 1};
 
-  std::span<const uint8_t> m_character_rom;
   std::array<uint8_t, 256> m_oam_data{0};
 
   uint8_t m_control_register{0};
@@ -136,6 +202,8 @@ private:
   uint8_t m_oam_address{0};
   uint16_t m_ppu_scroll_x{0};
   uint16_t m_ppu_scroll_y{0};
+  // Vertical scroll of the frame being drawn, on the 512x480 plane made by the four nametables
+  unsigned int m_scroll_y{0};
 
   EnumArray<uint16_t, Register> m_internal_registers{};
 
@@ -144,9 +212,50 @@ private:
 
   std::chrono::duration<double> m_last_frame_time{0.0};
 
+  // Decoded pattern tables, every tile in its four orientations (none, horizontal, vertical, both)
+  using DecodedTiles = std::array<std::array<TilePixelValues, 4>, Bus::CHR_TILE_COUNT>;
+  std::unique_ptr<DecodedTiles> m_decoded_tiles{std::make_unique<DecodedTiles>()};
+  mutable Bus::CharacterTileBitmap m_dirty_tiles;
+
   static std::shared_ptr<spdlog::logger> s_logger;
 
-  Addr MirrorVRAMAddress(Addr address) const;
+  // Index in m_vram of a nametable address ($2000-$3EFF)
+  [[nodiscard]] Addr MirrorVRAMAddress(Addr address) const {
+    return (m_nametable_pages[(address >> 10) & 0x3] << 10) | (address & 0x3FF);
+  }
+
+  // Sprite 0 hit position, for the current state of the PPU
+  mutable std::optional<unsigned int> m_sprite0_hit_dot;
+  mutable bool m_sprite0_hit_stale{true};
+  mutable Bus::CharacterTileBitmap m_sprite0_chr_changes;
+
+  // Background of each nametable in VRAM as palette RAM offsets (0-15, 0 where transparent). The palette lookup comes
+  // later, so palette writes don't make anything stale. Each row of 32 tiles has one bit per tile to draw again.
+  static constexpr uint32_t ALL_TILES_IN_ROW = 0xFFFFFFFF;
+  struct NametableImage {
+    std::array<uint8_t, 256 * 240> pixels{};
+    std::array<uint32_t, 30> dirty_rows{};
+  };
+  std::unique_ptr<std::array<NametableImage, 4>> m_nametable_images{std::make_unique<std::array<NametableImage, 4>>()};
+  uint8_t m_nametable_images_bank{0};
+  Bus::CharacterTileBitmap m_background_chr_changes;
+  unsigned int m_tiles_redrawn{0};
+  unsigned int m_tiles_redrawn_last_frame{0};
+
+  // Page of VRAM that the given nametable (0-3) maps to
+  [[nodiscard]] unsigned int VRAMNametable(uint8_t nametable_index) const { return m_nametable_pages[nametable_index]; }
+  void MarkNametableDirty(Addr vram_index);
+  void CheckBackgroundPatterns();
+  void RedrawDirtyTiles(unsigned int vram_nametable, unsigned int tile_row);
+
+  [[nodiscard]] std::optional<unsigned int> FindSprite0Hit() const;
+  // Background color index (0 is transparent) at the given screen position, with the current scroll
+  [[nodiscard]] uint8_t BackgroundPixel(unsigned int x, unsigned int y) const;
+  // Horizontal scroll on the 512x480 nametable plane
+  [[nodiscard]] unsigned int ScrollX() const;
+  // The 8 pixel values of a row of the sprite (counted from the top of the sprite as drawn)
+  [[nodiscard]] const uint8_t *SpriteRow(const SpriteData &sprite, unsigned int row) const;
+  [[nodiscard]] unsigned int FrameDot() const { return m_current_scanline * 341 + static_cast<unsigned int>(m_cycles); }
 };
 
 } // namespace BNES::HW
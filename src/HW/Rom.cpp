@@ -86,6 +86,7 @@ ErrorOr<Rom> Rom::FromFile(std::string_view path) {
   logger->debug("NES 2.0: {}", is_nes_v2);
 
   Rom rom{.is_nes_v2 = is_nes_v2};
+  rom.has_battery = (cbyte1 & 0b10) != 0;
 
   if (is_nes_v2) {
     rom.mapper = mapper_upper | mapper_lower | ((byte8 & 0x0F) << 8);
@@ -126,6 +127,17 @@ ErrorOr<Rom> Rom::FromFile(std::string_view path) {
 
     rom.program_rom.resize(n_prg_rom_banks * 0x4000);
     rom.character_rom.resize(n_chr_rom_banks * 0x2000);
+
+    // iNES 1.0 has no reliable way to say if there is PRG-RAM. Byte 8 is its size in 8KB units (0 still means 8KB),
+    // and we assume every board but NROM has some, as most emulators do.
+    if (rom.mapper != 0 || rom.has_battery) {
+      const size_t prg_ram_size = std::max<size_t>(byte8, 1) * 0x2000;
+      if (rom.has_battery) {
+        rom.prg_nvram_size = prg_ram_size;
+      } else {
+        rom.prg_ram_size = prg_ram_size;
+      }
+    }
   }
 
   bool is_four_screen = (cbyte1 & 0b1000) != 0;
@@ -19,6 +19,9 @@ public:
     Vertical,
     Horizontal,
     FourScreen,
+    // Only selectable by some mappers at runtime (e.g. MMC1)
+    SingleScreenLower,
+    SingleScreenUpper,
   };
 
   enum class TimingMode {
@@ -46,6 +49,7 @@ public:
   size_t prg_nvram_size{0};
   size_t chr_ram_size{0};
   size_t chr_nvram_size{0};
+  bool has_battery{false};
   uint8_t vs_system_type{0};
   uint8_t extended_console_type{0};
   uint8_t misc_rom_count{0};
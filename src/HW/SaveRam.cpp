@@ -0,0 +1,130 @@
+//
+// Created by Valerio Formato on 17-Oct-26.
+//
+
+#include "HW/SaveRam.h"
+
+#include <cerrno>
+#include <fstream>
+#include <system_error>
+#include <utility>
+
+#if BNES_SAVERAM_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace BNES::HW {
+
+static std::error_code LastError() { return {errno, std::generic_category()}; }
+
+SaveRam::~SaveRam() { Release(); }
+
+SaveRam::SaveRam(SaveRam &&other) noexcept
+    : m_data{std::exchange(other.m_data, nullptr)}, m_size{std::exchange(other.m_size, 0)},
+      m_path{std::move(other.m_path)}, m_memory{std::move(other.m_memory)},
+      m_mapped{std::exchange(other.m_mapped, false)} {
+  other.m_path.clear();
+}
+
+SaveRam &SaveRam::operator=(SaveRam &&other) noexcept {
+  if (this != &other) {
+    Release();
+    m_data = std::exchange(other.m_data, nullptr);
+    m_size = std::exchange(other.m_size, 0);
+    m_path = std::move(other.m_path);
+    other.m_path.clear();
+    m_memory = std::move(other.m_memory);
+    m_mapped = std::exchange(other.m_mapped, false);
+  }
+  return *this;
+}
+
+SaveRam SaveRam::Volatile(size_t size) {
+  SaveRam ram;
+  ram.m_memory.resize(size, 0);
+  ram.m_data = ram.m_memory.data();
+  ram.m_size = size;
+  return ram;
+}
+
+ErrorOr<SaveRam> SaveRam::FromFile(const std::filesystem::path &path, size_t size) {
+  SaveRam ram;
+  ram.m_path = path;
+  ram.m_size = size;
+
+#if BNES_SAVERAM_MMAP
+  const int fd = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+  if (fd < 0) {
+    return make_error(LastError(), fmt::format("Could not open {}", path.string()));
+  }
+
+  // Shorter (or new) files are padded with zeros, longer ones keep their tail untouched
+  struct stat file_stat {};
+  if (fstat(fd, &file_stat) != 0 ||
+      (static_cast<size_t>(file_stat.st_size) < size && ftruncate(fd, static_cast<off_t>(size)) != 0)) {
+    const auto error = LastError();
+    close(fd);
+    return make_error(error, fmt::format("Could not resize {}", path.string()));
+  }
+
+  void *data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  // The mapping keeps the file open by itself
+  close(fd);
+  if (data == MAP_FAILED) {
+    return make_error(LastError(), fmt::format("Could not map {}", path.string()));
+  }
+
+  ram.m_data = static_cast<uint8_t *>(data);
+  ram.m_mapped = true;
+#else
+  ram.m_memory.resize(size, 0);
+  if (std::ifstream file{path, std::ios::binary}) {
+    file.read(reinterpret_cast<char *>(ram.m_memory.data()), static_cast<std::streamsize>(size));
+  }
+  ram.m_data = ram.m_memory.data();
+#endif
+
+  return ram;
+}
+
+ErrorOr<void> SaveRam::Flush() {
+  if (!IsBatteryBacked() || !m_data) {
+    return {};
+  }
+
+#if BNES_SAVERAM_MMAP
+  if (msync(m_data, m_size, MS_SYNC) != 0) {
+    return make_error(LastError(), fmt::format("Could not write {}", m_path.string()));
+  }
+#else
+  std::ofstream file{m_path, std::ios::binary | std::ios::trunc};
+  if (!file.write(reinterpret_cast<const char *>(m_data), static_cast<std::streamsize>(m_size))) {
+    return make_error(std::errc::io_error, fmt::format("Could not write {}", m_path.string()));
+  }
+#endif
+
+  return {};
+}
+
+void SaveRam::Release() {
+  if (auto result = Flush(); !result) {
+    spdlog::error("Save RAM lost: {}", result.error().Message());
+  }
+
+#if BNES_SAVERAM_MMAP
+  if (m_mapped) {
+    munmap(m_data, m_size);
+  }
+#endif
+
+  m_data = nullptr;
+  m_size = 0;
+  m_path.clear();
+  m_memory.clear();
+  m_mapped = false;
+}
+
+} // namespace BNES::HW
@@ -0,0 +1,64 @@
+//
+// Created by Valerio Formato on 17-Oct-26.
+//
+
+#ifndef BNES_SAVERAM_H
+#define BNES_SAVERAM_H
+
+#include "common/Utils.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+#if defined(__linux__) || defined(__APPLE__)
+#define BNES_SAVERAM_MMAP 1
+#else
+#define BNES_SAVERAM_MMAP 0
+#endif
+
+namespace BNES::HW {
+
+// PRG-RAM on the cartridge. Battery-backed RAM is a shared memory mapping of the save file: the CPU writes straight
+// into it through the bus page table, and the OS writes dirty pages back to disk on its own schedule, so the save
+// survives even if we crash. Flush() forces the write-back (e.g. on exit).
+// Where mmap is not available the file is read on load and written back only by Flush().
+class SaveRam {
+public:
+  SaveRam() = default;
+  ~SaveRam();
+
+  SaveRam(const SaveRam &) = delete;
+  SaveRam &operator=(const SaveRam &) = delete;
+  SaveRam(SaveRam &&other) noexcept;
+  SaveRam &operator=(SaveRam &&other) noexcept;
+
+  // Plain work RAM, lost on power off
+  static SaveRam Volatile(size_t size);
+  // Battery-backed RAM, the file is created (zero-filled) if it doesn't exist yet
+  static ErrorOr<SaveRam> FromFile(const std::filesystem::path &path, size_t size);
+
+  [[nodiscard]] uint8_t *Data() { return m_data; }
+  [[nodiscard]] const uint8_t *Data() const { return m_data; }
+  [[nodiscard]] size_t Size() const { return m_size; }
+  [[nodiscard]] bool IsBatteryBacked() const { return !m_path.empty(); }
+  [[nodiscard]] const std::filesystem::path &Path() const { return m_path; }
+
+  // Makes sure everything written so far is on disk. Does nothing for volatile RAM.
+  ErrorOr<void> Flush();
+
+private:
+  uint8_t *m_data{nullptr};
+  size_t m_size{0};
+  std::filesystem::path m_path;
+
+  // Volatile RAM, or the whole save when we can't map the file
+  std::vector<uint8_t> m_memory;
+  bool m_mapped{false};
+
+  void Release();
+};
+} // namespace BNES::HW
+
+#endif // BNES_SAVERAM_H
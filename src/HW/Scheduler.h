@@ -0,0 +1,93 @@
+//
+// Created by Valerio Formato on 17-Oct-26.
+//
+
+#ifndef BNES_SCHEDULER_H
+#define BNES_SCHEDULER_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+
+namespace BNES::HW {
+
+// Things a device wants to happen (or at least be looked at) at a given point in time
+enum class Event : uint8_t {
+  VBlankStart = 0, // vblank flag set (the PPU raises the NMI itself while ticking, if enabled)
+  PreRender,       // sprite-0 hit flag reset
+  FrameEnd,        // vblank flag reset
+  Sprite0,         // the sprite 0 hit flag gets set
+  OAMAddrReset,    // OAMADDR is reset during ticks 257-320 of rendering scanlines
+  MapperIRQ,       // the mapper scanline counter (clocked by PPU A12 rising edges) reaches zero
+  Count,
+};
+
+// Master clock for the whole system, counting PPU dots since power on. Devices register deadlines for the events they
+// care about, and whoever drives the clock only needs to compare the current time against the earliest one.
+// There's at most one pending deadline per event type, so the queue is a tiny array kept sorted by timestamp.
+class Scheduler {
+public:
+  using Timestamp = uint64_t;
+  static constexpr Timestamp Never = std::numeric_limits<Timestamp>::max();
+
+  [[nodiscard]] Timestamp Now() const { return m_now; }
+  void Advance(Timestamp dots) { m_now += dots; }
+
+  // Earliest deadline, or Never if nothing is scheduled
+  [[nodiscard]] Timestamp NextEventTime() const { return m_size > 0 ? m_queue[0].time : Never; }
+  [[nodiscard]] bool EventDue() const { return m_now >= NextEventTime(); }
+
+  // Replaces any deadline already scheduled for the same event
+  void Schedule(Event event, Timestamp time) {
+    Remove(event);
+
+    auto position = std::ranges::upper_bound(m_queue.begin(), m_queue.begin() + m_size, time, {}, &Entry::time);
+    std::move_backward(position, m_queue.begin() + m_size, m_queue.begin() + m_size + 1);
+    *position = {time, event};
+    ++m_size;
+  }
+
+  void Cancel(Event event) { Remove(event); }
+
+  [[nodiscard]] std::optional<Timestamp> Deadline(Event event) const {
+    const auto it = std::ranges::find(m_queue.begin(), m_queue.begin() + m_size, event, &Entry::event);
+    return it == m_queue.begin() + m_size ? std::nullopt : std::optional{it->time};
+  }
+
+  // Removes and returns the earliest event, if its deadline has passed
+  std::optional<Event> PopDueEvent() {
+    if (!EventDue()) {
+      return std::nullopt;
+    }
+
+    const auto event = m_queue[0].event;
+    std::move(m_queue.begin() + 1, m_queue.begin() + m_size, m_queue.begin());
+    --m_size;
+    return event;
+  }
+
+private:
+  struct Entry {
+    Timestamp time;
+    Event event;
+  };
+
+  void Remove(Event event) {
+    const auto end = m_queue.begin() + m_size;
+    const auto it = std::ranges::find(m_queue.begin(), end, event, &Entry::event);
+    if (it != end) {
+      std::move(it + 1, end, it);
+      --m_size;
+    }
+  }
+
+  Timestamp m_now{0};
+  std::array<Entry, static_cast<size_t>(Event::Count)> m_queue{};
+  size_t m_size{0};
+};
+} // namespace BNES::HW
+
+#endif // BNES_SCHEDULER_H
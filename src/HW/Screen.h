@@ -5,10 +5,13 @@
 #ifndef BNES_SCREEN_H
 #define BNES_SCREEN_H
 
+#include "HW/ColorConverter.h"
 #include "HW/PPU.h"
 #include "SDLBind/Graphics/Texture.h"
 #include "SDLBind/Graphics/Window.h"
 
+#include <filesystem>
+
 namespace BNES::HW {
 
 class Screen {
@@ -17,18 +20,29 @@ public:
   static constexpr unsigned int NES_SCREEN_H = 240;
 
   Screen() = delete;
-  explicit Screen(Bus &bus) { bus.Attach(this); };
+  explicit Screen(Bus &bus);
 
   ErrorOr<void> Init(const SDL::Window &window);
 
+  // Replaces the built-in colors with the ones from a .pal file
+  ErrorOr<void> LoadPalette(const std::filesystem::path &path);
+
+  // Keeps the color indices of a finished frame. They're turned into RGB only when the frame gets drawn, so frames
+  // the window never shows cost just a copy.
   ErrorOr<void> FillFromPPU(const PPU &ppu);
-  ErrorOr<void> FillBackground(const PPU &ppu);
-  ErrorOr<void> FillSprites(const PPU &ppu);
 
   ErrorOr<void> DrawScreen(SDL::Window &window, float scale_factor = 1);
 
 private:
+  ErrorOr<void> ConvertFrame();
+
   SDL::Texture m_texture;
+
+  std::array<uint8_t, NES_SCREEN_W * NES_SCREEN_H> m_color_indices{0};
+  std::array<uint8_t, NES_SCREEN_H> m_scanline_masks{0};
+  // One for each combination of PPUMASK color emphasis and grayscale, see PaletteVariant()
+  std::array<ColorConverter::Palette, 16> m_palettes;
+  bool m_frame_pending{false};
 };
 
 } // namespace BNES::HW
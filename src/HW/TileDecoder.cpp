@@ -0,0 +1,154 @@
+//
+// Created by Valerio Formato on 17-Oct-26.
+//
+
+#include "HW/TileDecoder.h"
+#include "HW/CpuFeatures.h"
+
+#include <array>
+#include <bit>
+#include <bitset>
+#include <cstring>
+
+#if BNES_CPUFEATURES_X86
+#include <immintrin.h>
+#endif
+
+namespace BNES::HW {
+
+namespace {
+void DecodeReference(const uint8_t *chr_data, uint8_t *pixels, size_t n_tiles) {
+  for (size_t tile = 0; tile < n_tiles; ++tile) {
+    const uint8_t *tile_data = chr_data + tile * TileDecoder::TILE_BYTES;
+    uint8_t *tile_pixels = pixels + tile * TileDecoder::TILE_PIXELS;
+    std::memset(tile_pixels, 0, TileDecoder::TILE_PIXELS);
+
+    for (size_t index = 0; index < TileDecoder::TILE_BYTES; ++index) {
+      auto row_index = index % 8;
+      auto bit_pos = index / 8;
+
+      for (size_t x = 0; x < 8; ++x) {
+        bool value = std::bitset<8>(tile_data[index])[8 - x - 1];
+        tile_pixels[row_index * 8 + x] |= (value << bit_pos);
+      }
+    }
+  }
+}
+
+// Byte x of entry b is bit (7 - x) of b, i.e. the leftmost pixel comes first in memory whatever the endianness
+constexpr auto s_spread_table = [] {
+  std::array<uint64_t, 256> table{};
+  for (unsigned int value = 0; value < 256; ++value) {
+    std::array<uint8_t, 8> bytes{};
+    for (unsigned int x = 0; x < 8; ++x) {
+      bytes[x] = (value >> (7 - x)) & 0x1;
+    }
+    table[value] = std::bit_cast<uint64_t>(bytes);
+  }
+  return table;
+}();
+
+void DecodeSpreadTable(const uint8_t *chr_data, uint8_t *pixels, size_t n_tiles) {
+  for (size_t tile = 0; tile < n_tiles; ++tile) {
+    const uint8_t *tile_data = chr_data + tile * TileDecoder::TILE_BYTES;
+    uint8_t *tile_pixels = pixels + tile * TileDecoder::TILE_PIXELS;
+
+    for (size_t row = 0; row < 8; ++row) {
+      // Every byte is 0 or 1, so the shift can't carry into the next pixel
+      const uint64_t row_pixels = s_spread_table[tile_data[row]] | (s_spread_table[tile_data[row + 8]] << 1);
+      std::memcpy(tile_pixels + row * 8, &row_pixels, sizeof(row_pixels));
+    }
+  }
+}
+
+#if BNES_CPUFEATURES_X86
+// Each plane byte is repeated over the 8 bytes of its row, then every byte keeps only the bit of its own pixel
+void DecodeSSE2(const uint8_t *chr_data, uint8_t *pixels, size_t n_tiles) {
+  const __m128i pixel_bits = _mm_set1_epi64x(0x0102040810204080);
+  const __m128i ones = _mm_set1_epi8(1);
+
+  auto pixel_values = [&](__m128i low_plane, __m128i high_plane) {
+    const __m128i low = _mm_and_si128(_mm_cmpeq_epi8(_mm_and_si128(low_plane, pixel_bits), pixel_bits), ones);
+    const __m128i high = _mm_and_si128(_mm_cmpeq_epi8(_mm_and_si128(high_plane, pixel_bits), pixel_bits), ones);
+    return _mm_or_si128(low, _mm_add_epi8(high, high));
+  };
+
+  for (size_t tile = 0; tile < n_tiles; ++tile) {
+    const __m128i planes =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(chr_data + tile * TileDecoder::TILE_BYTES));
+    auto *out = reinterpret_cast<__m128i *>(pixels + tile * TileDecoder::TILE_PIXELS);
+
+    // l0 l0 l1 l1 ... l7 l7 and h0 h0 h1 h1 ... h7 h7
+    const __m128i low_x2 = _mm_unpacklo_epi8(planes, planes);
+    const __m128i high_x2 = _mm_unpackhi_epi8(planes, planes);
+    // Rows 0-3 and 4-7, four copies of each byte
+    const __m128i low_x4[2] = {_mm_unpacklo_epi16(low_x2, low_x2), _mm_unpackhi_epi16(low_x2, low_x2)};
+    const __m128i high_x4[2] = {_mm_unpacklo_epi16(high_x2, high_x2), _mm_unpackhi_epi16(high_x2, high_x2)};
+
+    for (size_t half = 0; half < 2; ++half) {
+      // Two rows per register
+      _mm_storeu_si128(out + half * 2, pixel_values(_mm_unpacklo_epi32(low_x4[half], low_x4[half]),
+                                                    _mm_unpacklo_epi32(high_x4[half], high_x4[half])));
+      _mm_storeu_si128(out + half * 2 + 1, pixel_values(_mm_unpackhi_epi32(low_x4[half], low_x4[half]),
+                                                        _mm_unpackhi_epi32(high_x4[half], high_x4[half])));
+    }
+  }
+}
+
+// Same idea, four rows per register: a byte shuffle picks the plane byte of the row for every pixel
+__attribute__((target("avx2"))) void DecodeAVX2(const uint8_t *chr_data, uint8_t *pixels, size_t n_tiles) {
+  const __m256i pixel_bits = _mm256_set1_epi64x(0x0102040810204080);
+  const __m256i ones = _mm256_set1_epi8(1);
+  // Rows 0-1 in the low lane and 2-3 in the high one, then rows 4-7. High plane bytes sit 8 bytes later.
+  const __m256i low_rows[2] = {
+      _mm256_setr_epi64x(0x0000000000000000, 0x0101010101010101, 0x0202020202020202, 0x0303030303030303),
+      _mm256_setr_epi64x(0x0404040404040404, 0x0505050505050505, 0x0606060606060606, 0x0707070707070707),
+  };
+  const __m256i high_offset = _mm256_set1_epi8(8);
+
+  for (size_t tile = 0; tile < n_tiles; ++tile) {
+    const __m128i tile_data =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(chr_data + tile * TileDecoder::TILE_BYTES));
+    const __m256i planes = _mm256_broadcastsi128_si256(tile_data);
+    auto *out = reinterpret_cast<__m256i *>(pixels + tile * TileDecoder::TILE_PIXELS);
+
+    for (size_t half = 0; half < 2; ++half) {
+      const __m256i low_plane = _mm256_shuffle_epi8(planes, low_rows[half]);
+      const __m256i high_plane = _mm256_shuffle_epi8(planes, _mm256_add_epi8(low_rows[half], high_offset));
+      const __m256i low =
+          _mm256_and_si256(_mm256_cmpeq_epi8(_mm256_and_si256(low_plane, pixel_bits), pixel_bits), ones);
+      const __m256i high =
+          _mm256_and_si256(_mm256_cmpeq_epi8(_mm256_and_si256(high_plane, pixel_bits), pixel_bits), ones);
+      _mm256_storeu_si256(out + half, _mm256_or_si256(low, _mm256_add_epi8(high, high)));
+    }
+  }
+}
+#endif
+
+using Dispatch = CpuDispatch<TileDecoder::Implementation, void (*)(const uint8_t *, uint8_t *, size_t)>;
+using enum TileDecoder::Implementation;
+
+constexpr Dispatch::Entry entries[] = {
+    {Reference, CpuFeature::None, DecodeReference},
+    {SpreadTable, CpuFeature::None, DecodeSpreadTable},
+#if BNES_CPUFEATURES_X86
+    {SSE2, CpuFeature::SSE2, DecodeSSE2},
+    {AVX2, CpuFeature::AVX2, DecodeAVX2},
+#endif
+};
+constexpr TileDecoder::Implementation preferred[] = {AVX2, SSE2, SpreadTable};
+constexpr Dispatch dispatch{entries, preferred};
+} // namespace
+
+const TileDecoder::DecodeFunction TileDecoder::s_decode = dispatch.Get(dispatch.Best());
+
+void TileDecoder::Decode(Implementation implementation, std::span<const uint8_t> chr_data,
+                         std::span<uint8_t> pixels) {
+  dispatch.Get(implementation)(chr_data.data(), pixels.data(), chr_data.size() / TILE_BYTES);
+}
+
+bool TileDecoder::Supported(Implementation implementation) { return dispatch.Supported(implementation); }
+
+TileDecoder::Implementation TileDecoder::Best() { return dispatch.Best(); }
+
+} // namespace BNES::HW
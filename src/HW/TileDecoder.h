@@ -0,0 +1,45 @@
+//
+// Created by Valerio Formato on 17-Oct-26.
+//
+
+#ifndef BNES_TILEDECODER_H
+#define BNES_TILEDECODER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace BNES::HW {
+
+// Turns pattern table tiles (two bitplanes of 8 bytes each) into one 2-bit color index per pixel, row by row.
+// Any number of consecutive tiles can be decoded in one call, up to whole pattern tables. The fastest implementation
+// the CPU supports is picked at runtime, the others are kept around for testing and benchmarking.
+class TileDecoder {
+public:
+  static constexpr size_t TILE_BYTES = 16;
+  static constexpr size_t TILE_PIXELS = 64;
+
+  enum class Implementation {
+    Reference,   // bit by bit, as the PPU used to do it
+    SpreadTable, // 256-entry table spreading the 8 bits of a plane into 8 bytes
+    SSE2,
+    AVX2,
+  };
+
+  // `pixels` has to hold TILE_PIXELS bytes for every TILE_BYTES of `chr_data`
+  static void Decode(std::span<const uint8_t> chr_data, std::span<uint8_t> pixels) {
+    s_decode(chr_data.data(), pixels.data(), chr_data.size() / TILE_BYTES);
+  }
+  static void Decode(Implementation implementation, std::span<const uint8_t> chr_data, std::span<uint8_t> pixels);
+
+  [[nodiscard]] static bool Supported(Implementation implementation);
+  [[nodiscard]] static Implementation Best();
+
+private:
+  using DecodeFunction = void (*)(const uint8_t *chr_data, uint8_t *pixels, size_t n_tiles);
+  static const DecodeFunction s_decode;
+};
+
+} // namespace BNES::HW
+
+#endif // BNES_TILEDECODER_H
@@ -24,6 +24,19 @@ ErrorOr<SDL::Texture> CPUDebugger::BuildTexture(const SDL::Window &main_window)
   lines.push_back("              NV1BDIZC");
   lines.push_back(fmt::format("Status Flags: {}", m_cpu->StatusFlags().to_string()));
 
+  const auto &icache_stats = m_cpu->GetInstructionCacheStats();
+  lines.push_back("");
+  lines.push_back(fmt::format("I-cache: {} hits / {} misses", icache_stats.hits, icache_stats.misses));
+  if (m_cpu->Engine() == CPU::ExecutionEngine::Block || m_cpu->Engine() == CPU::ExecutionEngine::Dynarec) {
+    const auto &block_stats = m_cpu->GetBlockCacheStats();
+    lines.push_back(fmt::format("Blocks: {} (avg. length {:.1f})", block_stats.blocks_built,
+                                block_stats.AverageBlockLength()));
+  }
+  if (m_cpu->Engine() == CPU::ExecutionEngine::Dynarec) {
+    lines.push_back(fmt::format("Native blocks: {} ({} flushes)", m_cpu->GetDynarecStats().compiled_blocks,
+                                m_cpu->GetDynarecStats().flushes));
+  }
+
   std::string content = rg::fold_left(lines, std::string{},
                                       [](auto &&current, auto &&text) { return fmt::format("{}{}\n", current, text); });
 
@@ -85,19 +85,15 @@ ErrorOr<SDL::Texture> PPUDebugger::BuildChrRomTexture(const SDL::Window &main_wi
       }));
   SDL::Buffer &chr_rom_buffer = texture.Buffer();
 
-  static constexpr auto tile_memory_size = PPU::TILE_MEMORY_SIZE;
-
-  const auto &chr_rom = m_ppu->m_bus->Rom().character_rom;
-  auto tiles = chr_rom | rv::chunk(tile_memory_size);
-
   static constexpr auto tile_width = PPU::TILE_WIDTH;
   static constexpr auto tile_height = PPU::TILE_HEIGHT;
 
   using TilePixelData = std::array<SDL::Pixel, tile_width * tile_height>;
 
-  for (const auto &[tile_index, tile] : rv::enumerate(tiles)) {
+  // Show the pattern tables as currently banked in by the mapper
+  for (unsigned int tile_index = 0; tile_index < 512; ++tile_index) {
+    const auto &tile_data = m_ppu->DecodedTile(tile_index / 256, tile_index % 256);
     TilePixelData tile_pixels;
-    auto tile_data = PPU::DecodeTile(tile);
     std::ranges::copy(tile_data | rv::transform([](uint8_t value) {
                         // FIXME: we should actually look into the palette data and choose the right color. For now
                         //        let's make it bright enough to be seen on screen...
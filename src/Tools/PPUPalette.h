@@ -6,6 +6,12 @@
 #define BNES_PPUPALETTE_H
 
 #include "SDLBind/Graphics/Color.h"
+#include "common/Types/Error.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
 
 namespace BNES::HW {
 static constexpr std::array<SDL::Pixel, 64> PPUPalette{{
@@ -23,6 +29,61 @@ static constexpr std::array<SDL::Pixel, 64> PPUPalette{{
     {{0xFF, 0xEF, 0xA6}}, {{0xFF, 0xF7, 0x9C}}, {{0xD7, 0xE8, 0x95}}, {{0xA6, 0xED, 0xAF}}, {{0xA2, 0xF2, 0xDA}},
     {{0x99, 0xFF, 0xFC}}, {{0xDD, 0xDD, 0xDD}}, {{0x11, 0x11, 0x11}}, {{0x11, 0x11, 0x11}},
 }};
+
+// The three color emphasis bits and the grayscale bit of PPUMASK give 16 versions of the palette. They're all worked
+// out in advance, so that applying them is just a matter of picking the right one.
+static constexpr size_t N_PALETTE_VARIANTS = 16;
+using PaletteVariants = std::array<std::array<SDL::Pixel, 64>, N_PALETTE_VARIANTS>;
+
+constexpr size_t PaletteVariant(uint8_t ppu_mask) { return ((ppu_mask >> 4) & 0b1110) | (ppu_mask & 0b1); }
+
+// Grayscale keeps only the brightness column of the color index. Each emphasis bit (red, green and blue for bits 5, 6
+// and 7 on NTSC) darkens the other two components, so with all three set the whole picture gets darker.
+constexpr PaletteVariants ExpandPalette(std::span<const SDL::Pixel, 64> colors) {
+  auto attenuate = [](uint8_t value, bool darker) { return darker ? static_cast<uint8_t>(value * 816 / 1000) : value; };
+
+  PaletteVariants variants{};
+  for (size_t variant = 0; variant < N_PALETTE_VARIANTS; ++variant) {
+    const bool grayscale = variant & 0b1;
+    const unsigned int emphasis = variant >> 1;
+    for (size_t index = 0; index < 64; ++index) {
+      SDL::Pixel pixel = colors[grayscale ? index & 0x30 : index];
+      pixel.color.r = attenuate(pixel.color.r, emphasis & 0b110);
+      pixel.color.g = attenuate(pixel.color.g, emphasis & 0b101);
+      pixel.color.b = attenuate(pixel.color.b, emphasis & 0b011);
+      variants[variant][index] = pixel;
+    }
+  }
+  return variants;
+}
+
+static constexpr PaletteVariants PPUPaletteVariants = ExpandPalette(PPUPalette);
+
+// A .pal file is a list of RGB triplets: either the 64 colors, or 8 sets of them already emphasized (in the order of
+// PPUMASK bits 5-7).
+inline ErrorOr<PaletteVariants> PaletteFromPalFile(std::span<const uint8_t> data) {
+  if (data.size() != 64 * 3 && data.size() != 8 * 64 * 3) {
+    return make_error(std::errc::invalid_argument, "A palette file has either 64 or 512 RGB colors");
+  }
+
+  std::array<SDL::Pixel, 8 * 64> colors{};
+  for (size_t i = 0; i < data.size() / 3; ++i) {
+    colors[i] = SDL::Pixel{{data[3 * i], data[3 * i + 1], data[3 * i + 2]}};
+  }
+  if (data.size() == 64 * 3) {
+    return ExpandPalette(std::span{colors}.first<64>());
+  }
+
+  PaletteVariants variants{};
+  for (size_t variant = 0; variant < N_PALETTE_VARIANTS; ++variant) {
+    const bool grayscale = variant & 0b1;
+    const auto emphasized = std::span{colors}.subspan((variant >> 1) * 64, 64);
+    for (size_t index = 0; index < 64; ++index) {
+      variants[variant][index] = emphasized[grayscale ? index & 0x30 : index];
+    }
+  }
+  return variants;
+}
 }
 
 #endif // BNES_PPUPALETTE_H
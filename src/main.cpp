@@ -28,6 +28,9 @@ int main(int argc, char **argv) {
   // clang-format off
   options.add_options()
     ("s,stepping", "Start with single stepping enabled")
+    ("e,engine", "CPU execution engine (variant, table, block, dynarec)", cxxopts::value<std::string>()->default_value(std::string{magic_enum::enum_name(BNES::HW::CPU::DefaultExecutionEngine)}))
+    ("profile-pairs", "Count the most frequent opcode pairs and print them on exit")
+    ("p,palette", "Load the colors from a .pal file", cxxopts::value<std::string>())
     ("v,verbose", "Verbosity level (use -v for Debug, -vv for Trace)", cxxopts::value<int>()->default_value("0")->implicit_value("1"))
     ("romfile", "ROM to load", cxxopts::value<std::string>())
     ("version", "Print version information")
@@ -70,9 +73,19 @@ int main(int argc, char **argv) {
       return 1;
     }
 
+    auto engine = magic_enum::enum_cast<BNES::HW::CPU::ExecutionEngine>(result["engine"].as<std::string>(),
+                                                                        magic_enum::case_insensitive);
+    if (!engine) {
+      spdlog::error("Unknown CPU engine '{}'", result["engine"].as<std::string>());
+      return 1;
+    }
+
     BNES::App application{{
         .rom_path = result["romfile"].as<std::string>(),
         .stepping = result["stepping"].as<bool>(),
+        .engine = *engine,
+        .profile_pairs = result["profile-pairs"].as<bool>(),
+        .palette_path = result.count("palette") ? result["palette"].as<std::string>() : std::string{},
     }};
 
     auto main_result = application.Run();
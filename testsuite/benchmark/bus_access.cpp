@@ -0,0 +1,82 @@
+#include "HW/Bus.h"
+#include "HW/CPU.h"
+#include "HW/PPU.h"
+
+#include <cxxopts.hpp>
+#include <fmt/format.h>
+
+#include <chrono>
+#include <string_view>
+#include <vector>
+
+using namespace BNES::HW;
+
+namespace {
+// Returns the number of bus accesses per second
+template <typename ACCESS> double RunBenchmark(ACCESS access, size_t n_accesses) {
+  Bus bus;
+  if (auto result = bus.LoadIntoProgramRom(std::vector<uint8_t>(0x8000, 0xEA)); !result) {
+    fmt::println("Could not load benchmark program: {}", result.error().Message());
+    return 0.0;
+  }
+  PPU ppu{bus};
+  CPU cpu{bus};
+
+  uint8_t checksum = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < n_accesses; ++i) {
+    checksum ^= access(bus, i);
+  }
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+  // Make sure the reads can't be optimized away
+  volatile uint8_t sink = checksum;
+  (void)sink;
+
+  return static_cast<double>(n_accesses) / elapsed.count();
+}
+
+void Report(std::string_view name, double rate) { fmt::println("{:<16} {:>8.2f} M accesses/s", name, rate / 1e6); }
+} // namespace
+
+int main(int argc, char **argv) {
+  cxxopts::Options options("bus_access_benchmark", "Measure the throughput of CPU bus reads and writes");
+
+  // clang-format off
+  options.add_options()
+    ("n,accesses", "Number of bus accesses per pattern", cxxopts::value<size_t>()->default_value("100000000"))
+    ("h,help", "Print usage");
+  // clang-format on
+
+  try {
+    auto result = options.parse(argc, argv);
+    if (result.count("help")) {
+      fmt::println("{}", options.help());
+      return 0;
+    }
+
+    const auto n = result["accesses"].as<size_t>();
+
+    // Where the CPU goes most of the time: opcode and operand fetches from PRG ROM, zero page and stack, other RAM
+    Report("RAM read", RunBenchmark([](Bus &bus, size_t i) { return bus.Read(i & 0x7FF); }, n));
+    Report("RAM mirror read", RunBenchmark([](Bus &bus, size_t i) { return bus.Read(0x800 | (i & 0x17FF)); }, n));
+    Report("ROM read", RunBenchmark([](Bus &bus, size_t i) { return bus.Read(0x8000 | (i & 0x7FFF)); }, n));
+    Report("mixed read", RunBenchmark(
+                             [](Bus &bus, size_t i) {
+                               // 3 fetches for each zero page/stack access
+                               return bus.Read((i & 3) ? 0x8000 | (i & 0x7FFF) : i & 0x1FF);
+                             },
+                             n));
+    Report("RAM write", RunBenchmark(
+                            [](Bus &bus, size_t i) {
+                              bus.Write(0x200 | (i & 0x5FF), static_cast<uint8_t>(i));
+                              return uint8_t{0};
+                            },
+                            n));
+
+    return 0;
+  } catch (const cxxopts::exceptions::exception &e) {
+    fmt::println("Error parsing options: {}", e.what());
+    return 1;
+  }
+}
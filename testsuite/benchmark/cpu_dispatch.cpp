@@ -0,0 +1,95 @@
+#include "HW/Bus.h"
+#include "HW/CPU.h"
+#include "HW/Constants.h"
+#include "HW/PPU.h"
+
+#include <cxxopts.hpp>
+#include <fmt/format.h>
+#include <magic_enum.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+using namespace BNES::HW;
+
+namespace {
+// A small copy/add loop with a nested subroutine call, representative of the kind of code games spend their time in
+// clang-format off
+constexpr std::array<uint8_t, 26> benchmark_program{
+    0xA2, 0x00,       // $8000 LDX #$00
+    0xBD, 0x00, 0x02, // $8002 LDA $0200,X
+    0x18,             // $8005 CLC
+    0x69, 0x03,       // $8006 ADC #$03
+    0x9D, 0x00, 0x03, // $8008 STA $0300,X
+    0xE8,             // $800B INX
+    0xD0, 0xF4,       // $800C BNE $8002
+    0x20, 0x14, 0x80, // $800E JSR $8014
+    0x4C, 0x00, 0x80, // $8011 JMP $8000
+    0xA0, 0x10,       // $8014 LDY #$10
+    0x88,             // $8016 DEY
+    0xD0, 0xFD,       // $8017 BNE $8016
+    0x60,             // $8019 RTS
+};
+// clang-format on
+
+// Returns the number of emulated CPU cycles per second
+double RunBenchmark(CPU::ExecutionEngine engine, size_t n_cycles, bool catch_up) {
+  std::vector<uint8_t> rom(0x8000, 0x00);
+  std::ranges::copy(benchmark_program, rom.begin());
+  // Reset vector -> $8000
+  rom[0x7FFC] = 0x00;
+  rom[0x7FFD] = 0x80;
+
+  Bus bus;
+  if (auto result = bus.LoadIntoProgramRom(rom); !result) {
+    fmt::println("Could not load benchmark program: {}", result.error().Message());
+    return 0.0;
+  }
+  PPU ppu{bus};
+  CPU cpu{bus};
+  cpu.Init();
+  cpu.SetEngine(engine);
+  bus.SetCatchUpEnabled(catch_up);
+
+  auto start = std::chrono::steady_clock::now();
+  // Engines run a different amount of instructions per step, so we measure emulated cycles instead
+  while (cpu.Cycles() < n_cycles) {
+    cpu.Step();
+  }
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+  return static_cast<double>(cpu.Cycles()) / elapsed.count();
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  cxxopts::Options options("cpu_dispatch_benchmark", "Compare the throughput of the CPU execution engines");
+
+  // clang-format off
+  options.add_options()
+    ("n,cycles", "Number of CPU cycles to run per engine", cxxopts::value<size_t>()->default_value("50000000"))
+    ("c,catch-up", "Only synchronize the PPU when needed (see Bus::SetCatchUpEnabled)")
+    ("h,help", "Print usage");
+  // clang-format on
+
+  try {
+    auto result = options.parse(argc, argv);
+    if (result.count("help")) {
+      fmt::println("{}", options.help());
+      return 0;
+    }
+
+    const auto n_cycles = result["cycles"].as<size_t>();
+    for (auto engine : magic_enum::enum_values<CPU::ExecutionEngine>()) {
+      const auto rate = RunBenchmark(engine, n_cycles, result["catch-up"].as<bool>());
+      fmt::println("{:<8} {:>8.2f} M cycles/s ({:.1f}x real time)", magic_enum::enum_name(engine), rate / 1e6,
+                   rate / NES_CPU_FREQ_HZ);
+    }
+
+    return 0;
+  } catch (const cxxopts::exceptions::exception &e) {
+    fmt::println("Error parsing options: {}", e.what());
+    return 1;
+  }
+}
@@ -0,0 +1,138 @@
+#include "HW/Bus.h"
+#include "HW/CPU.h"
+#include "HW/Constants.h"
+#include "HW/PPU.h"
+
+#include <cxxopts.hpp>
+#include <fmt/format.h>
+#include <magic_enum.hpp>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <span>
+#include <string_view>
+#include <vector>
+
+using namespace BNES::HW;
+
+namespace {
+struct Program {
+  std::string_view name;
+  std::span<const uint8_t> code;
+};
+
+// Flag-heavy loops built from the instructions covered by the math unit tests. Almost every instruction here computes
+// N and Z, and only the branches (and the occasional ADC/ROL reading the carry) look at them.
+// clang-format off
+constexpr auto add_subtract_program = std::to_array<uint8_t>({
+    0xA2, 0x00,       // $8000 LDX #$00
+    0x18,             // $8002 CLC
+    0xA5, 0x10,       // $8003 LDA $10
+    0x69, 0x07,       // $8005 ADC #$07
+    0x85, 0x10,       // $8007 STA $10
+    0xA5, 0x11,       // $8009 LDA $11
+    0x69, 0x00,       // $800B ADC #$00
+    0x85, 0x11,       // $800D STA $11
+    0x38,             // $800F SEC
+    0xE5, 0x10,       // $8010 SBC $10
+    0x95, 0x20,       // $8012 STA $20,X
+    0xE8,             // $8014 INX
+    0xD0, 0xEB,       // $8015 BNE $8002
+    0x4C, 0x00, 0x80, // $8017 JMP $8000
+});
+
+constexpr auto increment_compare_program = std::to_array<uint8_t>({
+    0xA0, 0x00,       // $8000 LDY #$00
+    0xE6, 0x30,       // $8002 INC $30
+    0xC6, 0x31,       // $8004 DEC $31
+    0xA5, 0x30,       // $8006 LDA $30
+    0xC5, 0x31,       // $8008 CMP $31
+    0xF0, 0x01,       // $800A BEQ $800D
+    0xC8,             // $800C INY
+    0xC0, 0x80,       // $800D CPY #$80
+    0x90, 0xF1,       // $800F BCC $8002
+    0x4C, 0x00, 0x80, // $8011 JMP $8000
+});
+
+constexpr auto shift_rotate_program = std::to_array<uint8_t>({
+    0xA2, 0x00,       // $8000 LDX #$00
+    0xB5, 0x40,       // $8002 LDA $40,X
+    0x0A,             // $8004 ASL A
+    0x26, 0x50,       // $8005 ROL $50
+    0x4A,             // $8007 LSR A
+    0x66, 0x51,       // $8008 ROR $51
+    0x95, 0x40,       // $800A STA $40,X
+    0xE8,             // $800C INX
+    0xE0, 0x40,       // $800D CPX #$40
+    0xD0, 0xF1,       // $800F BNE $8002
+    0x4C, 0x00, 0x80, // $8011 JMP $8000
+});
+// clang-format on
+
+constexpr std::array programs{
+    Program{"add/subtract", add_subtract_program},
+    Program{"inc/dec/compare", increment_compare_program},
+    Program{"shift/rotate", shift_rotate_program},
+};
+
+// Returns the number of emulated CPU cycles per second
+double RunBenchmark(const Program &program, CPU::ExecutionEngine engine, size_t n_cycles) {
+  std::vector<uint8_t> rom(0x8000, 0x00);
+  std::ranges::copy(program.code, rom.begin());
+  // Reset vector -> $8000
+  rom[0x7FFC] = 0x00;
+  rom[0x7FFD] = 0x80;
+
+  Bus bus;
+  if (auto result = bus.LoadIntoProgramRom(rom); !result) {
+    fmt::println("Could not load benchmark program: {}", result.error().Message());
+    return 0.0;
+  }
+  PPU ppu{bus};
+  CPU cpu{bus};
+  cpu.Init();
+  cpu.SetEngine(engine);
+  bus.SetCatchUpEnabled(true);
+
+  auto start = std::chrono::steady_clock::now();
+  while (cpu.Cycles() < n_cycles) {
+    cpu.Step();
+  }
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+  return static_cast<double>(cpu.Cycles()) / elapsed.count();
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  cxxopts::Options options("cpu_flags_benchmark", "Measure the cost of status flag handling on arithmetic code");
+
+  // clang-format off
+  options.add_options()
+    ("n,cycles", "Number of CPU cycles to run per program and engine", cxxopts::value<size_t>()->default_value("20000000"))
+    ("h,help", "Print usage");
+  // clang-format on
+
+  try {
+    auto result = options.parse(argc, argv);
+    if (result.count("help")) {
+      fmt::println("{}", options.help());
+      return 0;
+    }
+
+    const auto n_cycles = result["cycles"].as<size_t>();
+    for (const auto &program : programs) {
+      for (auto engine : magic_enum::enum_values<CPU::ExecutionEngine>()) {
+        const auto rate = RunBenchmark(program, engine, n_cycles);
+        fmt::println("{:<16} {:<8} {:>8.2f} M cycles/s ({:.1f}x real time)", program.name,
+                     magic_enum::enum_name(engine), rate / 1e6, rate / NES_CPU_FREQ_HZ);
+      }
+    }
+
+    return 0;
+  } catch (const cxxopts::exceptions::exception &e) {
+    fmt::println("Error parsing options: {}", e.what());
+    return 1;
+  }
+}
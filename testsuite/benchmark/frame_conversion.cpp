@@ -0,0 +1,80 @@
+#include "HW/ColorConverter.h"
+
+#include <cxxopts.hpp>
+#include <fmt/format.h>
+#include <magic_enum.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+using namespace BNES::HW;
+
+namespace {
+// Returns the average time it takes to convert a frame, in seconds
+double RunBenchmark(ColorConverter::Implementation implementation, const std::vector<uint8_t> &color_indices,
+                    const ColorConverter::Palette &palette, size_t n_frames) {
+  std::vector<uint32_t> pixels(color_indices.size());
+
+  uint32_t checksum = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < n_frames; ++i) {
+    ColorConverter::Convert(implementation, color_indices, palette, pixels);
+    checksum ^= pixels[i % pixels.size()];
+  }
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+  // Make sure the conversion can't be optimized away
+  volatile uint32_t sink = checksum;
+  (void)sink;
+
+  return elapsed.count() / static_cast<double>(n_frames);
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  cxxopts::Options options("frame_conversion_benchmark", "Measure how long it takes to turn a frame into RGB pixels");
+
+  // clang-format off
+  options.add_options()
+    ("n,frames", "Number of frames to convert", cxxopts::value<size_t>()->default_value("20000"))
+    ("h,help", "Print usage");
+  // clang-format on
+
+  try {
+    auto result = options.parse(argc, argv);
+    if (result.count("help")) {
+      fmt::println("{}", options.help());
+      return 0;
+    }
+
+    // A 256x240 frame of noise and a palette whose bytes are all different
+    std::vector<uint8_t> color_indices(256 * 240);
+    uint32_t state = 12345;
+    for (auto &index : color_indices) {
+      state = state * 1664525 + 1013904223;
+      index = static_cast<uint8_t>((state >> 24) & 0x3F);
+    }
+    ColorConverter::Palette palette{};
+    for (uint32_t color = 0; color < ColorConverter::N_COLORS; ++color) {
+      palette[color] = color * 0x01030507;
+    }
+
+    const auto n_frames = result["frames"].as<size_t>();
+    fmt::println("Dispatching to {}", magic_enum::enum_name(ColorConverter::Best()));
+    for (auto implementation : magic_enum::enum_values<ColorConverter::Implementation>()) {
+      if (!ColorConverter::Supported(implementation)) {
+        fmt::println("{:<8} not supported", magic_enum::enum_name(implementation));
+        continue;
+      }
+
+      const auto frame_time = RunBenchmark(implementation, color_indices, palette, n_frames);
+      fmt::println("{:<8} {:>8.2f} us/frame", magic_enum::enum_name(implementation), frame_time * 1e6);
+    }
+
+    return 0;
+  } catch (const cxxopts::exceptions::exception &e) {
+    fmt::println("Error parsing options: {}", e.what());
+    return 1;
+  }
+}
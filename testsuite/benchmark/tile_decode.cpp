@@ -0,0 +1,76 @@
+#include "HW/TileDecoder.h"
+
+#include <cxxopts.hpp>
+#include <fmt/format.h>
+#include <magic_enum.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+using namespace BNES::HW;
+
+namespace {
+// Returns the number of tiles decoded per second
+double RunBenchmark(TileDecoder::Implementation implementation, const std::vector<uint8_t> &chr_data,
+                    size_t n_tables) {
+  std::vector<uint8_t> pixels(chr_data.size() / TileDecoder::TILE_BYTES * TileDecoder::TILE_PIXELS);
+
+  uint8_t checksum = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < n_tables; ++i) {
+    TileDecoder::Decode(implementation, chr_data, pixels);
+    checksum ^= pixels[i % pixels.size()];
+  }
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+  // Make sure the decoding can't be optimized away
+  volatile uint8_t sink = checksum;
+  (void)sink;
+
+  return static_cast<double>(n_tables * (chr_data.size() / TileDecoder::TILE_BYTES)) / elapsed.count();
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  cxxopts::Options options("tile_decode_benchmark", "Measure the throughput of the pattern table tile decoders");
+
+  // clang-format off
+  options.add_options()
+    ("n,tables", "Number of times both pattern tables are decoded", cxxopts::value<size_t>()->default_value("20000"))
+    ("h,help", "Print usage");
+  // clang-format on
+
+  try {
+    auto result = options.parse(argc, argv);
+    if (result.count("help")) {
+      fmt::println("{}", options.help());
+      return 0;
+    }
+
+    // Both pattern tables, filled with noise so that every plane byte value shows up
+    std::vector<uint8_t> chr_data(0x2000);
+    uint32_t state = 12345;
+    for (auto &byte : chr_data) {
+      state = state * 1664525 + 1013904223;
+      byte = static_cast<uint8_t>(state >> 24);
+    }
+
+    const auto n_tables = result["tables"].as<size_t>();
+    fmt::println("Dispatching to {}", magic_enum::enum_name(TileDecoder::Best()));
+    for (auto implementation : magic_enum::enum_values<TileDecoder::Implementation>()) {
+      if (!TileDecoder::Supported(implementation)) {
+        fmt::println("{:<12} not supported", magic_enum::enum_name(implementation));
+        continue;
+      }
+
+      const auto rate = RunBenchmark(implementation, chr_data, n_tables);
+      fmt::println("{:<12} {:>8.2f} M tiles/s", magic_enum::enum_name(implementation), rate / 1e6);
+    }
+
+    return 0;
+  } catch (const cxxopts::exceptions::exception &e) {
+    fmt::println("Error parsing options: {}", e.what());
+    return 1;
+  }
+}
@@ -52,37 +52,314 @@ SCENARIO("Bus NMI propagation tests", "[Bus][NMI]") {
     CPUMock cpu{bus};
     PPU ppu{bus}; // PPU needed for bus.Tick() calls
 
-    // Setup minimal ROM for NMI vector
+    // Setup minimal ROM for NMI vector, with a NOP at the handler
     std::vector<uint8_t> rom(0x8000, 0x00);
     rom[0x7FFA] = 0xEF;
     rom[0x7FFB] = 0xBE; // NMI vector -> 0xBEEF
+    rom[0x3EEF] = 0xEA;
     auto load_result = bus.LoadIntoProgramRom(rom);
     REQUIRE(load_result.has_value());
 
-    WHEN("PropagateNMI is called") {
+    WHEN("RaiseNMI is called") {
       auto original_pc = cpu.ProgramCounter();
       auto original_sp = cpu.StackPointer();
 
-      bus.PropagateNMI();
+      bus.RaiseNMI();
 
-      THEN("The CPU's ProcessNMI should be invoked") {
-        REQUIRE(cpu.ProgramCounter() == 0xBEEF);
-        REQUIRE(cpu.StackPointer() == original_sp - 3);
-        REQUIRE(cpu.TestStatusFlag(CPU::StatusFlag::InterruptDisable) == true);
+      THEN("The NMI is only latched in the CPU") {
+        REQUIRE(cpu.InterruptPending(CPU::Interrupt::NMI));
+        REQUIRE(cpu.ProgramCounter() == original_pc);
+        REQUIRE(cpu.StackPointer() == original_sp);
+      }
+
+      AND_WHEN("The CPU runs its next instruction") {
+        cpu.Step();
+
+        THEN("The NMI handler is entered first") {
+          REQUIRE_FALSE(cpu.InterruptPending(CPU::Interrupt::NMI));
+          REQUIRE(cpu.ProgramCounter() == 0xBEF0);
+          REQUIRE(cpu.StackPointer() == original_sp - 3);
+          REQUIRE(cpu.TestStatusFlag(CPU::StatusFlag::InterruptDisable) == true);
+        }
       }
     }
 
-    WHEN("PropagateNMI is called multiple times") {
+    WHEN("RaiseNMI is called multiple times before the CPU runs") {
       auto original_sp = cpu.StackPointer();
 
-      bus.PropagateNMI();
-      auto sp_after_first = cpu.StackPointer();
-      REQUIRE(sp_after_first == original_sp - 3);
+      bus.RaiseNMI();
+      bus.RaiseNMI();
+      cpu.Step();
+
+      THEN("The NMI is serviced once") { REQUIRE(cpu.StackPointer() == original_sp - 3); }
+    }
+  }
+
+  GIVEN("A bus without a CPU") {
+    Bus bus;
+
+    WHEN("RaiseNMI is called") {
+      THEN("Nothing happens") { REQUIRE_NOTHROW(bus.RaiseNMI()); }
+    }
+  }
+}
+
+SCENARIO("Bus frame-complete hook", "[Bus][PPU]") {
+  GIVEN("A bus with a PPU and a frame-complete hook") {
+    Bus bus;
+    CPUMock cpu{bus};
+    PPU ppu{bus};
+    REQUIRE(bus.LoadIntoProgramRom(std::vector<uint8_t>(0x8000, 0x00)).has_value());
+
+    unsigned int frames = 0;
+    bus.SetFrameCompleteHook([&frames](const PPU &) { ++frames; });
+
+    WHEN("The PPU hasn't reached vblank yet") {
+      bus.Tick(240 * 341 / Bus::PPU_FREQ_RATIO);
+      bus.DeliverCompletedFrame();
+
+      THEN("The hook is not called") { REQUIRE(frames == 0); }
+    }
+
+    WHEN("The PPU reaches vblank") {
+      bus.Tick(242 * 341 / Bus::PPU_FREQ_RATIO);
+
+      THEN("The hook only runs once the frame is delivered") {
+        REQUIRE(frames == 0);
+
+        bus.DeliverCompletedFrame();
+        REQUIRE(frames == 1);
+
+        bus.DeliverCompletedFrame();
+        REQUIRE(frames == 1);
+      }
+    }
+  }
+}
+
+SCENARIO("Bus catch-up PPU synchronization", "[Bus][PPU]") {
+  GIVEN("A bus in catch-up mode") {
+    Bus bus;
+    CPUMock cpu{bus};
+    PPU ppu{bus};
+    REQUIRE(bus.LoadIntoProgramRom(std::vector<uint8_t>(0x8000, 0x00)).has_value());
+    bus.SetCatchUpEnabled(true);
+
+    WHEN("The CPU runs for a few cycles") {
+      bus.Tick(10);
+
+      THEN("The PPU is not ticked yet") {
+        REQUIRE(ppu.Cycles() == 0);
+        REQUIRE(bus.CyclesUntilNextEvent() == 241 * 341 / Bus::PPU_FREQ_RATIO - 10);
+      }
+
+      AND_WHEN("RAM is accessed") {
+        bus.Write(0x0010, 0x42);
+        REQUIRE(bus.Read(0x0010) == 0x42);
+
+        THEN("The PPU is still not ticked") { REQUIRE(ppu.Cycles() == 0); }
+      }
+
+      AND_WHEN("A PPU register is read") {
+        [[maybe_unused]] auto status = bus.Read(0x2002);
+
+        THEN("The PPU catches up first") { REQUIRE(ppu.Cycles() == 10 * Bus::PPU_FREQ_RATIO); }
+      }
+
+      AND_WHEN("The state is synchronized explicitly") {
+        bus.Sync();
+
+        THEN("The PPU catches up") { REQUIRE(ppu.Cycles() == 10 * Bus::PPU_FREQ_RATIO); }
+      }
+    }
+
+    WHEN("The CPU runs up to vblank") {
+      bus.Tick(241 * 341 / Bus::PPU_FREQ_RATIO + 1);
+
+      THEN("The PPU is ticked right away") {
+        REQUIRE(ppu.CurrentScanline() == 241);
+        REQUIRE(ppu.Cycles() == 1);
+      }
+    }
+  }
+}
+
+SCENARIO("Bus memory map", "[Bus]") {
+  GIVEN("A bus with a program loaded") {
+    Bus bus;
+    CPUMock cpu{bus};
+    std::vector<uint8_t> rom(0x4000, 0xEA);
+    rom[0x0000] = 0x12;
+    REQUIRE(bus.LoadIntoProgramRom(rom).has_value());
+
+    THEN("RAM and its mirrors share the same memory") {
+      bus.Write(0x0123, 0x45);
+      REQUIRE(bus.Read(0x0923) == 0x45);
+      REQUIRE(bus.Read(0x1923) == 0x45);
+    }
+
+    THEN("A 16KB program is mirrored in the upper half") {
+      REQUIRE(bus.Read(0x8000) == 0x12);
+      REQUIRE(bus.Read(0xC000) == 0x12);
+    }
+
+    THEN("Page accessors and instruction fetches see the same memory as Read/Write") {
+      bus.WritePage<0x01>(0xFD, 0x34);
+      REQUIRE(bus.Read(0x01FD) == 0x34);
+      REQUIRE(bus.ReadPage<0x09>(0xFD) == 0x34);
+      REQUIRE(bus.FetchInstruction(0xBFFF) == std::array<uint8_t, 3>{0xEA, 0x12, 0xEA});
+    }
+
+    WHEN("Some memory is mapped at $6000") {
+      std::vector<uint8_t> prg_ram(0x2000, 0x00);
+      bus.MapPages(0x6000, 0x7FFF, prg_ram.data(), prg_ram.data());
+      bus.Write(0x6789, 0xAB);
+
+      THEN("Accesses go straight to it") {
+        REQUIRE(prg_ram[0x0789] == 0xAB);
+        REQUIRE(bus.Read(0x6789) == 0xAB);
+      }
+
+      AND_WHEN("It's unmapped again") {
+        bus.UnmapPages(0x6000, 0x7FFF);
+
+        THEN("The bus doesn't see it anymore") { REQUIRE(bus.Read(0x6789) == 0x67); }
+      }
+    }
+
+    WHEN("Hooks are installed") {
+      std::vector<Bus::Addr> written;
+      bus.AddWriteHook(0x0200, 0x02FF, [&written](Bus::Addr address, uint8_t value) {
+        written.push_back(address);
+        return value;
+      });
+      bus.AddReadHook(0x8000, 0x8000, [](Bus::Addr, uint8_t) -> uint8_t { return 0x99; });
+
+      bus.Write(0x0210, 0x01);
+      bus.Write(0x0310, 0x02);
+
+      THEN("Watchpoints see the accesses in their range only") {
+        REQUIRE(written == std::vector<Bus::Addr>{0x0210});
+        REQUIRE(bus.Read(0x0210) == 0x01);
+      }
+
+      THEN("Zero page writes still reach the watchpoints") {
+        bus.AddWriteHook(0x0010, 0x0010, [&written](Bus::Addr address, uint8_t value) {
+          written.push_back(address);
+          return value;
+        });
+        bus.WritePage<0x00>(0x10, 0x03);
+        REQUIRE(written == std::vector<Bus::Addr>{0x0210, 0x0010});
+      }
+
+      THEN("Cheats can replace the values read") {
+        REQUIRE(bus.Read(0x8000) == 0x99);
+        REQUIRE(bus.FetchInstruction(0x8000)[0] == 0x99);
+        REQUIRE(bus.Read(0x8001) == 0xEA);
+      }
+
+      AND_WHEN("The hooks are cleared") {
+        bus.ClearHooks();
+
+        THEN("The original values are back") { REQUIRE(bus.Read(0x8000) == 0x12); }
+      }
+    }
+  }
+}
+
+SCENARIO("Bus open bus behaviour", "[Bus]") {
+  GIVEN("A bus with a CPU and a PPU attached") {
+    Bus bus;
+    CPUMock cpu{bus};
+    PPU ppu{bus};
+    REQUIRE(bus.LoadIntoProgramRom(std::vector<uint8_t>(0x4000, 0xEA)).has_value());
+
+    WHEN("A write-only PPU register is read") {
+      bus.Write(0x2001, 0x1E);
+      const auto value = bus.Read(0x2000);
+
+      THEN("The last value on the PPU data bus comes back") {
+        REQUIRE(value == 0x1E);
+        REQUIRE(bus.Diagnostics().write_only_reads == 1);
+      }
+    }
+
+    WHEN("An address nothing answers to is read") {
+      const auto value = bus.Read(0x5123);
 
-      bus.PropagateNMI();
-      auto sp_after_second = cpu.StackPointer();
+      THEN("The high byte of the address is still on the data bus") {
+        REQUIRE(value == 0x51);
+        REQUIRE(bus.Diagnostics().open_bus_reads == 1);
+      }
+    }
+
+    WHEN("PRG ROM is written to") {
+      bus.Write(0x8000, 0x01);
+
+      THEN("The write is counted and the ROM is untouched") {
+        REQUIRE(bus.Diagnostics().rom_writes == 1);
+        REQUIRE(bus.Read(0x8000) == 0xEA);
+      }
+    }
+
+    WHEN("An APU register is written to") {
+      bus.Write(0x4015, 0x0F);
+
+      THEN("The write is counted as unmapped") { REQUIRE(bus.Diagnostics().unmapped_writes == 1); }
+    }
+  }
+
+  GIVEN("A program that doesn't fill its last page") {
+    Bus bus;
+    REQUIRE(bus.LoadIntoProgramRom(std::vector<uint8_t>(0x180, 0xEA)).has_value());
+
+    WHEN("PRG ROM is read past the program") {
+      THEN("The last page reads as zero, and the ones after it as open bus") {
+        REQUIRE(bus.Read(0x817F) == 0xEA);
+        REQUIRE(bus.Read(0x8180) == 0x00);
+        REQUIRE(bus.Read(0x8200) == 0x82);
+        REQUIRE(bus.Read(0xC000) == 0xC0);
+        REQUIRE(bus.Diagnostics().open_bus_reads == 2);
+      }
+    }
+  }
+}
+
+SCENARIO("Bus PRG-RAM", "[Bus][PRGRAM]") {
+  GIVEN("A cartridge with 2KB of PRG-RAM") {
+    Rom rom;
+    rom.mapper = 0;
+    rom.program_rom.resize(0x8000, 0xEA);
+    rom.prg_ram_size = 0x800;
+
+    Bus bus;
+    REQUIRE(bus.LoadRom(std::move(rom)).has_value());
+
+    WHEN("The RAM is written to") {
+      bus.Write(0x6010, 0x42);
+
+      THEN("It can be read back, mirrored over $6000-$7FFF") {
+        REQUIRE(bus.Read(0x6010) == 0x42);
+        REQUIRE(bus.Read(0x6810) == 0x42);
+        REQUIRE(bus.Read(0x7810) == 0x42);
+        REQUIRE(bus.Diagnostics().unmapped_writes == 0);
+        REQUIRE(bus.Diagnostics().open_bus_reads == 0);
+      }
+    }
+
+    THEN("It is not battery-backed") {
+      REQUIRE(bus.PrgRam().Size() == 0x800);
+      REQUIRE_FALSE(bus.PrgRam().IsBatteryBacked());
+    }
+  }
+
+  GIVEN("A cartridge without PRG-RAM") {
+    Bus bus;
+    REQUIRE(bus.LoadIntoProgramRom(std::vector<uint8_t>(0x8000, 0xEA)).has_value());
 
-      THEN("Each call should invoke CPU's ProcessNMI") { REQUIRE(sp_after_second == sp_after_first - 3); }
+    THEN("Nothing answers at $6000") {
+      REQUIRE(bus.PrgRam().Size() == 0);
+      REQUIRE(bus.Read(0x6000) == 0x60);
     }
   }
 }
@@ -1,4 +1,5 @@
 #include "HW/CPU.h"
+#include "HW/PPU.h"
 
 #include <catch2/catch_test_macros.hpp>
 
@@ -27,3 +28,47 @@ SCENARIO("6502 initialization") {
     }
   }
 }
+
+SCENARIO("6502 status register packing") {
+  GIVEN("a new CPU instance") {
+    Bus bus;
+    CPU cpu{bus};
+    PPU ppu{bus}; // needed for the bus ticks
+
+    WHEN("an instruction leaves a zero result") {
+      cpu.RunInstruction(CPU::LoadRegister<CPU::Register::A, AddressingMode::Immediate>{0x00});
+
+      THEN("only Z is set on top of the default flags") { REQUIRE(cpu.StatusFlags() == 0x26); }
+
+      AND_WHEN("a compare leaves a negative difference") {
+        cpu.RunInstruction(CPU::CompareRegister<CPU::Register::A, AddressingMode::Immediate>{0x01});
+
+        THEN("N comes from the difference, Z and C are clear") {
+          REQUIRE(cpu.TestStatusFlag(CPU::StatusFlag::Negative));
+          REQUIRE_FALSE(cpu.TestStatusFlag(CPU::StatusFlag::Zero));
+          REQUIRE_FALSE(cpu.TestStatusFlag(CPU::StatusFlag::Carry));
+          REQUIRE(cpu.StatusFlags() == 0xA4);
+        }
+      }
+    }
+
+    WHEN("BIT takes N and Z from different bytes") {
+      bus.Write(0x0010, 0xC0);
+      cpu.RunInstruction(CPU::BitTest<AddressingMode::ZeroPage>{0x10});
+
+      THEN("N, V and Z can all be set at once") { REQUIRE(cpu.StatusFlags() == 0xE6); }
+
+      AND_WHEN("the status is pushed and pulled back") {
+        cpu.RunInstruction(CPU::LoadRegister<CPU::Register::A, AddressingMode::Immediate>{0x01});
+        cpu.RunInstruction(CPU::PushStatusRegister{});
+        cpu.RunInstruction(CPU::LoadRegister<CPU::Register::A, AddressingMode::Immediate>{0x00});
+        cpu.RunInstruction(CPU::PullStatusRegister{});
+
+        THEN("the packed word goes through the stack unchanged") {
+          REQUIRE(bus.Read(0x01FD) == 0x64 + 0x10); // B is set in the pushed copy only
+          REQUIRE(cpu.StatusFlags() == 0x64);
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,411 @@
+#include "HW/CPU.h"
+#include "HW/PPU.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <algorithm>
+#include <vector>
+
+using namespace BNES::HW;
+
+class CPUMock : public CPU {
+  // This mock class is used to expose private methods for testing purposes.
+public:
+  CPUMock(BNES::HW::Bus &bus) : CPU(bus) {}
+
+  using CPU::ReadFromMemory;
+  using CPU::SetProgramStartAddress;
+  using CPU::WriteToMemory;
+};
+
+namespace {
+std::vector<uint8_t> MakeRom(const std::vector<uint8_t> &program) {
+  std::vector<uint8_t> rom(0x8000, 0x00);
+  std::ranges::copy(program, rom.begin());
+  // NMI vector -> 0x800A
+  rom[0x7FFA] = 0x0A;
+  rom[0x7FFB] = 0x80;
+  // IRQ/BRK vector -> 0x8000
+  rom[0x7FFE] = 0x00;
+  rom[0x7FFF] = 0x80;
+  return rom;
+}
+} // namespace
+
+SCENARIO("All execution engines produce the same results", "[CPU][Engine]") {
+  auto engine = GENERATE(CPU::ExecutionEngine::Variant, CPU::ExecutionEngine::Table, CPU::ExecutionEngine::Block,
+                        CPU::ExecutionEngine::Dynarec);
+
+  // clang-format off
+  auto program = GENERATE(
+      // Copy loop with arithmetic, a subroutine call and a jump back to the start
+      std::vector<uint8_t>{
+          0xA2, 0x00,       // LDX #$00
+          0xBD, 0x00, 0x02, // LDA $0200,X
+          0x18,             // CLC
+          0x69, 0x03,       // ADC #$03
+          0x9D, 0x00, 0x03, // STA $0300,X
+          0xE8,             // INX
+          0xD0, 0xF4,       // BNE $8002
+          0x20, 0x14, 0x80, // JSR $8014
+          0x4C, 0x00, 0x80, // JMP $8000
+          0xA0, 0x10,       // LDY #$10
+          0x88,             // DEY
+          0xD0, 0xFD,       // BNE $8016
+          0x60,             // RTS
+      },
+      // Stack, shifts, compares and undocumented opcodes
+      std::vector<uint8_t>{
+          0xA9, 0x81,       // LDA #$81
+          0x48,             // PHA
+          0x0A,             // ASL A
+          0x6A,             // ROR A
+          0x85, 0x10,       // STA $10
+          0xE6, 0x10,       // INC $10
+          0xC5, 0x10,       // CMP $10
+          0x08,             // PHP
+          0x68,             // PLA
+          0xA7, 0x10,       // *LAX $10
+          0xC7, 0x10,       // *DCP $10
+          0x38,             // SEC
+          0xE9, 0x01,       // SBC #$01
+          0x28,             // PLP
+          0x4C, 0x00, 0x80, // JMP $8000
+      },
+      // Straight-line main loop interrupted by vblank NMIs
+      std::vector<uint8_t>{
+          0xA9, 0x80,       // $8000 LDA #$80
+          0x8D, 0x00, 0x20, // $8002 STA $2000
+          0xE8,             // $8005 INX
+          0xC8,             // $8006 INY
+          0x4C, 0x05, 0x80, // $8007 JMP $8005
+          0xE6, 0x10,       // $800A INC $10 (NMI handler)
+          0xA5, 0x10,       // $800C LDA $10
+          0x40,             // $800E RTI
+      },
+      // Idioms that get fused into superinstructions
+      std::vector<uint8_t>{
+          0xA2, 0x10,       // $8000 LDX #$10
+          0xA0, 0x10,       // $8002 LDY #$10
+          0xBD, 0x00, 0x80, // $8004 LDA $8000,X
+          0x99, 0x00, 0x03, // $8007 STA $0300,Y
+          0xCA,             // $800A DEX
+          0xD0, 0xF7,       // $800B BNE $8004
+          0xE6, 0x10,       // $800D INC $10
+          0xA9, 0x42,       // $800F LDA #$42
+          0x85, 0x11,       // $8011 STA $11
+          0xA5, 0x10,       // $8013 LDA $10
+          0xC9, 0x80,       // $8015 CMP #$80
+          0xD0, 0xE7,       // $8017 BNE $8000
+          0xE6, 0x11,       // $8019 INC $11
+          0xD0, 0xE3,       // $801B BNE $8000
+      },
+      // Polling PPUSTATUS while waiting for vblank
+      std::vector<uint8_t>{
+          0xAD, 0x02, 0x20, // $8000 LDA $2002
+          0x10, 0xFB,       // $8003 BPL $8000
+          0xE8,             // $8005 INX
+          0x4C, 0x00, 0x80, // $8006 JMP $8000
+      },
+      // Spinning in place while NMIs do the work
+      std::vector<uint8_t>{
+          0xA9, 0x80,       // $8000 LDA #$80
+          0x8D, 0x00, 0x20, // $8002 STA $2000
+          0x4C, 0x05, 0x80, // $8005 JMP $8005
+          0xEA,             // $8008 NOP
+          0xEA,             // $8009 NOP
+          0xE6, 0x10,       // $800A INC $10 (NMI handler)
+          0xA5, 0x10,       // $800C LDA $10
+          0x40,             // $800E RTI
+      });
+  // clang-format on
+
+  // Only ticking the PPU when needed must not make any difference either
+  auto catch_up = GENERATE(false, true);
+
+  GIVEN("Two CPUs running the same program with different engines") {
+    Bus reference_bus;
+    REQUIRE(reference_bus.LoadIntoProgramRom(MakeRom(program)).has_value());
+    PPU reference_ppu{reference_bus};
+    CPUMock reference_cpu{reference_bus};
+    reference_cpu.SetEngine(CPU::ExecutionEngine::Variant);
+
+    Bus bus;
+    REQUIRE(bus.LoadIntoProgramRom(MakeRom(program)).has_value());
+    PPU ppu{bus};
+    CPUMock cpu{bus};
+    cpu.SetEngine(engine);
+    bus.SetCatchUpEnabled(catch_up);
+
+    WHEN("We step both CPUs through the program") {
+      THEN("The CPU state is identical at every step") {
+        for (unsigned int i = 0; i < 5000; ++i) {
+          cpu.Step();
+          // The block engine runs more than one instruction per step, catch up with the reference
+          while (reference_cpu.Cycles() < cpu.Cycles()) {
+            reference_cpu.Step();
+          }
+
+          REQUIRE(reference_cpu.ProgramCounter() == cpu.ProgramCounter());
+          REQUIRE(reference_cpu.Registers() == cpu.Registers());
+          REQUIRE(reference_cpu.StatusFlags() == cpu.StatusFlags());
+          REQUIRE(reference_cpu.StackPointer() == cpu.StackPointer());
+          REQUIRE(reference_cpu.Cycles() == cpu.Cycles());
+          if (!catch_up) {
+            REQUIRE(reference_ppu.CurrentScanline() == ppu.CurrentScanline());
+            REQUIRE(reference_ppu.Cycles() == ppu.Cycles());
+          }
+        }
+
+        bus.Sync();
+        REQUIRE(reference_ppu.CurrentScanline() == ppu.CurrentScanline());
+        REQUIRE(reference_ppu.Cycles() == ppu.Cycles());
+
+        for (CPU::Addr addr = 0; addr < 0x800; ++addr) {
+          REQUIRE(reference_cpu.ReadFromMemory(addr) == cpu.ReadFromMemory(addr));
+        }
+      }
+    }
+  }
+}
+
+SCENARIO("Block engine translates and invalidates basic blocks", "[CPU][Engine]") {
+  GIVEN("A CPU running self-modifying code from RAM with the block engine") {
+    Bus bus;
+    REQUIRE(bus.LoadIntoProgramRom(std::vector<uint8_t>(0x8000, 0x00)).has_value());
+    PPU ppu{bus};
+    CPUMock cpu{bus};
+    cpu.SetEngine(CPU::ExecutionEngine::Block);
+
+    // clang-format off
+    std::vector<uint8_t> program{
+        0xA9, 0x05,       // $0300 LDA #$05
+        0xE8,             // $0302 INX
+        0xEE, 0x01, 0x03, // $0303 INC $0301
+        0xC8,             // $0306 INY
+        0x4C, 0x00, 0x03, // $0307 JMP $0300
+    };
+    // clang-format on
+    for (CPU::Addr i = 0; i < program.size(); ++i) {
+      cpu.WriteToMemory(0x0300 + i, program[i]);
+    }
+    cpu.SetProgramStartAddress(0x0300);
+
+    WHEN("The block runs for the first time") {
+      cpu.Step();
+
+      THEN("It stops right after modifying itself") {
+        REQUIRE(cpu.ProgramCounter() == 0x0306);
+        REQUIRE(cpu.Registers()[CPU::Register::A] == 0x05);
+        REQUIRE(cpu.Registers()[CPU::Register::X] == 1);
+        REQUIRE(cpu.Registers()[CPU::Register::Y] == 0);
+        REQUIRE(cpu.GetBlockCacheStats().blocks_built == 1);
+        REQUIRE(cpu.GetBlockCacheStats().invalidations == 1);
+      }
+
+      AND_WHEN("The loop goes around again") {
+        cpu.Step();
+        cpu.Step();
+
+        THEN("The block is translated again with the new code") {
+          REQUIRE(cpu.ProgramCounter() == 0x0306);
+          REQUIRE(cpu.Registers()[CPU::Register::A] == 0x06);
+          REQUIRE(cpu.Registers()[CPU::Register::Y] == 1);
+          REQUIRE(cpu.GetBlockCacheStats().blocks_built == 3);
+          REQUIRE(cpu.GetBlockCacheStats().blocks_executed == 3);
+          REQUIRE(cpu.GetBlockCacheStats().instructions_built == 5 + 2 + 5);
+        }
+      }
+    }
+  }
+
+  GIVEN("A CPU running a loop from RAM that updates a variable in the same page") {
+    Bus bus;
+    REQUIRE(bus.LoadIntoProgramRom(std::vector<uint8_t>(0x8000, 0x00)).has_value());
+    PPU ppu{bus};
+    CPUMock cpu{bus};
+    cpu.SetEngine(CPU::ExecutionEngine::Block);
+
+    // clang-format off
+    std::vector<uint8_t> program{
+        0xEE, 0x20, 0x03, // $0300 INC $0320
+        0x4C, 0x00, 0x03, // $0303 JMP $0300
+    };
+    // clang-format on
+    for (CPU::Addr i = 0; i < program.size(); ++i) {
+      cpu.WriteToMemory(0x0300 + i, program[i]);
+    }
+    cpu.SetProgramStartAddress(0x0300);
+
+    WHEN("The loop runs several times") {
+      cpu.Step();
+      cpu.Step();
+      cpu.Step();
+
+      THEN("The block is kept, since the writes don't hit its bytes") {
+        REQUIRE(cpu.ReadFromMemory(0x0320) == 3);
+        REQUIRE(cpu.GetBlockCacheStats().blocks_built == 1);
+        REQUIRE(cpu.GetBlockCacheStats().invalidations == 0);
+      }
+    }
+  }
+}
+
+SCENARIO("Dynarec compiles hot blocks from PRG ROM", "[CPU][Engine]") {
+  GIVEN("A ROM loop patching and calling a subroutine in RAM") {
+    // clang-format off
+    std::vector<uint8_t> program{
+        0xA2, 0x00,       // $8000 LDX #$00
+        0xE8,             // $8002 INX
+        0x8E, 0x01, 0x03, // $8003 STX $0301
+        0x20, 0x00, 0x03, // $8006 JSR $0300
+        0x9D, 0x00, 0x04, // $8009 STA $0400,X
+        0xE0, 0x40,       // $800C CPX #$40
+        0xD0, 0xF2,       // $800E BNE $8002
+        0x4C, 0x10, 0x80, // $8010 JMP $8010
+    };
+    std::vector<uint8_t> subroutine{
+        0xA9, 0x00,       // $0300 LDA #$00
+        0x2A,             // $0302 ROL A
+        0x60,             // $0303 RTS
+    };
+    // clang-format on
+
+    Bus reference_bus;
+    REQUIRE(reference_bus.LoadIntoProgramRom(MakeRom(program)).has_value());
+    PPU reference_ppu{reference_bus};
+    CPUMock reference_cpu{reference_bus};
+    reference_cpu.SetEngine(CPU::ExecutionEngine::Variant);
+
+    Bus bus;
+    REQUIRE(bus.LoadIntoProgramRom(MakeRom(program)).has_value());
+    PPU ppu{bus};
+    CPUMock cpu{bus};
+    cpu.SetEngine(CPU::ExecutionEngine::Dynarec);
+
+    for (CPU::Addr i = 0; i < subroutine.size(); ++i) {
+      reference_cpu.WriteToMemory(0x0300 + i, subroutine[i]);
+      cpu.WriteToMemory(0x0300 + i, subroutine[i]);
+    }
+
+    WHEN("The loop runs to the end") {
+      while (cpu.ProgramCounter() != 0x8010) {
+        cpu.Step();
+      }
+      while (reference_cpu.Cycles() < cpu.Cycles()) {
+        reference_cpu.Step();
+      }
+
+      THEN("The results are the same as the interpreter's") {
+        REQUIRE(reference_cpu.ProgramCounter() == cpu.ProgramCounter());
+        REQUIRE(reference_cpu.Registers() == cpu.Registers());
+        REQUIRE(reference_cpu.StatusFlags() == cpu.StatusFlags());
+        REQUIRE(reference_cpu.StackPointer() == cpu.StackPointer());
+        REQUIRE(reference_cpu.Cycles() == cpu.Cycles());
+        for (CPU::Addr addr = 0; addr < 0x800; ++addr) {
+          REQUIRE(reference_cpu.ReadFromMemory(addr) == cpu.ReadFromMemory(addr));
+        }
+        REQUIRE(cpu.ReadFromMemory(0x0440) == 0x80);
+      }
+
+      THEN("The ROM blocks run as native code, the patched subroutine is still interpreted") {
+#ifdef BNES_DYNAREC
+        if constexpr (Dynarec::IsSupported()) {
+          REQUIRE(cpu.GetDynarecStats().compiled_blocks == 2);
+          REQUIRE(cpu.GetDynarecStats().flushes == 0);
+        }
+#else
+        REQUIRE(cpu.GetDynarecStats().compiled_blocks == 0);
+#endif
+        // Rebuilt every time the loop patches it
+        REQUIRE(cpu.GetBlockCacheStats().invalidations >= 0x40 - 1);
+      }
+    }
+  }
+}
+
+SCENARIO("Idle loops are fast-forwarded to the next PPU event", "[CPU][Engine]") {
+  auto engine = GENERATE(CPU::ExecutionEngine::Variant, CPU::ExecutionEngine::Table, CPU::ExecutionEngine::Block,
+                        CPU::ExecutionEngine::Dynarec);
+
+  GIVEN("A CPU waiting for vblank") {
+    // clang-format off
+    std::vector<uint8_t> program{
+        0xAD, 0x02, 0x20, // $8000 LDA $2002
+        0x10, 0xFB,       // $8003 BPL $8000
+        0x4C, 0x05, 0x80, // $8005 JMP $8005
+    };
+    // clang-format on
+
+    Bus bus;
+    REQUIRE(bus.LoadIntoProgramRom(MakeRom(program)).has_value());
+    PPU ppu{bus};
+    CPUMock cpu{bus};
+    cpu.SetEngine(engine);
+
+    WHEN("The loop runs for a while") {
+      // A few times around the loop, nowhere near enough to get to vblank one instruction at a time
+      for (unsigned int i = 0; i < 20; ++i) {
+        cpu.Step();
+      }
+
+      THEN("It jumps straight to vblank") {
+        REQUIRE(cpu.GetIdleLoopStats().fast_forwards > 0);
+        REQUIRE(cpu.ProgramCounter() == 0x8005);
+        // Vblank starts at scanline 241, 341 PPU dots per scanline
+        REQUIRE(cpu.Cycles() * 3 >= 241 * 341);
+      }
+    }
+  }
+}
+
+SCENARIO("Opcode pairs can be profiled", "[CPU][Engine]") {
+  GIVEN("A CPU with pair profiling enabled") {
+    // clang-format off
+    std::vector<uint8_t> program{
+        0xA2, 0x03,       // $8000 LDX #$03
+        0xCA,             // $8002 DEX
+        0xD0, 0xFD,       // $8003 BNE $8002
+        0x4C, 0x05, 0x80, // $8005 JMP $8005
+    };
+    // clang-format on
+
+    Bus bus;
+    REQUIRE(bus.LoadIntoProgramRom(MakeRom(program)).has_value());
+    PPU ppu{bus};
+    CPUMock cpu{bus};
+    cpu.SetEngine(CPU::ExecutionEngine::Block);
+    cpu.SetPairProfilingEnabled(true);
+
+    WHEN("The program runs") {
+      for (unsigned int i = 0; i < 8; ++i) {
+        cpu.Step();
+      }
+
+      THEN("Every pair of consecutive instructions is counted") {
+        REQUIRE(cpu.ProgramCounter() == 0x8005);
+
+        const auto *profile = cpu.GetPairProfile();
+        REQUIRE(profile != nullptr);
+        REQUIRE(profile->Count(0xA2, 0xCA) == 1);
+        REQUIRE(profile->Count(0xCA, 0xD0) == 3);
+        REQUIRE(profile->Count(0xD0, 0xCA) == 2);
+        REQUIRE(profile->Count(0xD0, 0x4C) == 1);
+
+        const auto most_frequent = profile->MostFrequent(2);
+        REQUIRE(most_frequent.size() == 2);
+        REQUIRE(most_frequent[0].first == 0xCA);
+        REQUIRE(most_frequent[0].second == 0xD0);
+        REQUIRE(most_frequent[0].count == 3);
+        REQUIRE(most_frequent[1].count == 2);
+      }
+    }
+
+    WHEN("Profiling is turned off") {
+      cpu.SetPairProfilingEnabled(false);
+
+      THEN("The profile is dropped") { REQUIRE(cpu.GetPairProfile() == nullptr); }
+    }
+  }
+}
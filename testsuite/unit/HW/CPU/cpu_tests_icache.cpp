@@ -0,0 +1,209 @@
+#include "HW/CPU.h"
+#include "HW/InstructionCache.h"
+#include "HW/PPU.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <vector>
+
+using namespace BNES::HW;
+
+class CPUMock : public CPU {
+  // This mock class is used to expose private methods for testing purposes.
+public:
+  CPUMock(BNES::HW::Bus &bus) : CPU(bus) {}
+
+  using CPU::ReadFromMemory;
+  using CPU::SetProgramStartAddress;
+  using CPU::WriteToMemory;
+};
+
+SCENARIO("Decoded instruction cache", "[CPU][InstructionCache]") {
+  auto engine = GENERATE(CPU::ExecutionEngine::Variant, CPU::ExecutionEngine::Table);
+
+  GIVEN("A CPU running a loop from PRG ROM") {
+    Bus bus;
+    // clang-format off
+    std::vector<uint8_t> rom{
+        0xE8,             // INX
+        0x4C, 0x00, 0x80, // JMP $8000
+    };
+    // clang-format on
+    REQUIRE(bus.LoadIntoProgramRom(rom).has_value());
+    PPU ppu{bus};
+    CPUMock cpu{bus};
+    cpu.SetEngine(engine);
+
+    WHEN("The loop runs several times") {
+      for (unsigned int i = 0; i < 20; ++i) {
+        cpu.Step();
+      }
+
+      THEN("Each instruction is decoded only once") {
+        REQUIRE(cpu.Registers()[CPU::Register::X] == 10);
+        REQUIRE(cpu.GetInstructionCacheStats().misses == 2);
+        REQUIRE(cpu.GetInstructionCacheStats().hits == 18);
+      }
+
+      AND_WHEN("A new program is loaded") {
+        // clang-format off
+        std::vector<uint8_t> new_rom{
+            0xC8,             // INY
+            0x4C, 0x00, 0x80, // JMP $8000
+        };
+        // clang-format on
+        REQUIRE(bus.LoadIntoProgramRom(new_rom).has_value());
+        for (unsigned int i = 0; i < 20; ++i) {
+          cpu.Step();
+        }
+
+        THEN("The cache is flushed and the new program runs") {
+          REQUIRE(cpu.Registers()[CPU::Register::X] == 10);
+          REQUIRE(cpu.Registers()[CPU::Register::Y] == 10);
+          REQUIRE(cpu.GetInstructionCacheStats().flushes == 1);
+        }
+      }
+    }
+
+    WHEN("The cache is disabled") {
+      cpu.SetInstructionCacheEnabled(false);
+      for (unsigned int i = 0; i < 20; ++i) {
+        cpu.Step();
+      }
+
+      THEN("The program still runs, without touching the cache") {
+        REQUIRE(cpu.Registers()[CPU::Register::X] == 10);
+        REQUIRE(cpu.GetInstructionCacheStats().misses == 0);
+        REQUIRE(cpu.GetInstructionCacheStats().hits == 0);
+      }
+    }
+  }
+
+  GIVEN("A CPU running self-modifying code from RAM") {
+    Bus bus;
+    REQUIRE(bus.LoadIntoProgramRom(std::vector<uint8_t>(0x8000, 0x00)).has_value());
+    PPU ppu{bus};
+    CPUMock cpu{bus};
+    cpu.SetEngine(engine);
+
+    // clang-format off
+    std::vector<uint8_t> program{
+        0xA9, 0x05,       // $0300 LDA #$05
+        0xEE, 0x01, 0x03, // $0302 INC $0301
+        0x4C, 0x00, 0x03, // $0305 JMP $0300
+    };
+    // clang-format on
+    for (CPU::Addr i = 0; i < program.size(); ++i) {
+      cpu.WriteToMemory(0x0300 + i, program[i]);
+    }
+    cpu.SetProgramStartAddress(0x0300);
+
+    WHEN("The loop runs several times") {
+      for (unsigned int i = 0; i < 3; ++i) {
+        cpu.Step();
+      }
+      REQUIRE(cpu.Registers()[CPU::Register::A] == 0x05);
+
+      for (unsigned int i = 0; i < 3; ++i) {
+        cpu.Step();
+      }
+
+      THEN("The modified instruction is decoded again") {
+        REQUIRE(cpu.Registers()[CPU::Register::A] == 0x06);
+        REQUIRE(cpu.GetInstructionCacheStats().misses == 4);
+        REQUIRE(cpu.GetInstructionCacheStats().hits == 2);
+        REQUIRE(cpu.GetInstructionCacheStats().invalidations >= 1);
+      }
+
+      AND_WHEN("The code is executed through a RAM mirror") {
+        cpu.SetProgramStartAddress(0x0B02);
+        cpu.Step();
+
+        THEN("The mirror shares the cached instructions") {
+          REQUIRE(cpu.ReadFromMemory(0x0301) == 0x08);
+          REQUIRE(cpu.GetInstructionCacheStats().misses == 4);
+          REQUIRE(cpu.GetInstructionCacheStats().hits == 3);
+        }
+      }
+    }
+  }
+}
+
+SCENARIO("Instruction cache invalidation across the end of RAM", "[CPU][InstructionCache]") {
+  GIVEN("Instructions cached at the end of RAM and at the end of PRG ROM") {
+    InstructionCache<int> cache;
+    cache.Insert(0x07FE, 1);
+    cache.Insert(0x07FF, 2);
+    cache.Insert(0xFFFE, 3);
+    cache.Insert(0xFFFF, 4);
+
+    WHEN("The first two bytes of RAM are written") {
+      cache.Invalidate(0x0000);
+      cache.Invalidate(0x0001);
+
+      THEN("The RAM instructions whose operands wrap around are dropped, the ROM ones are kept") {
+        REQUIRE(cache.Find(0x07FE) == nullptr);
+        REQUIRE(cache.Find(0x07FF) == nullptr);
+        REQUIRE(cache.Find(0xFFFE) != nullptr);
+        REQUIRE(cache.Find(0xFFFF) != nullptr);
+      }
+    }
+  }
+}
+
+SCENARIO("Pages holding decoded code", "[CPU][InstructionCache]") {
+  GIVEN("An instruction cache tracking its pages") {
+    CodePageMap code_pages;
+    InstructionCache<int> cache;
+    cache.TrackCodePages(code_pages, 0b01);
+
+    WHEN("An instruction is cached at the end of a RAM page") {
+      cache.Insert(0x02FF, 1);
+
+      THEN("Its page and the next one are marked, on every RAM mirror") {
+        REQUIRE(code_pages.HoldsCode(0x02FF));
+        REQUIRE(code_pages.HoldsCode(0x0300));
+        REQUIRE(code_pages.HoldsCode(0x0A00));
+        REQUIRE(code_pages.HoldsCode(0x1B00));
+        REQUIRE_FALSE(code_pages.HoldsCode(0x0400));
+        REQUIRE_FALSE(code_pages.HoldsCode(0x8000));
+      }
+
+      AND_WHEN("The cache is flushed") {
+        cache.Flush();
+
+        THEN("No page is marked anymore") {
+          REQUIRE_FALSE(code_pages.HoldsCode(0x02FF));
+          REQUIRE_FALSE(code_pages.HoldsCode(0x0300));
+        }
+      }
+    }
+  }
+
+  GIVEN("A CPU running from PRG ROM") {
+    Bus bus;
+    // clang-format off
+    std::vector<uint8_t> rom{
+        0xE6, 0x10,       // INC $10
+        0x4C, 0x00, 0x80, // JMP $8000
+    };
+    // clang-format on
+    REQUIRE(bus.LoadIntoProgramRom(rom).has_value());
+    PPU ppu{bus};
+    CPUMock cpu{bus};
+
+    WHEN("It only writes to RAM without code") {
+      for (unsigned int i = 0; i < 10; ++i) {
+        cpu.Step();
+      }
+
+      THEN("The writes don't invalidate anything") {
+        REQUIRE(cpu.ReadFromMemory(0x0010) == 5);
+        REQUIRE(bus.DecodedCodePages().HoldsCode(0x8000));
+        REQUIRE_FALSE(bus.DecodedCodePages().HoldsCode(0x0010));
+        REQUIRE(cpu.GetInstructionCacheStats().invalidations == 0);
+      }
+    }
+  }
+}
@@ -14,6 +14,7 @@ public:
   CPUMock(BNES::HW::Bus &bus) : CPU(bus) {}
 
   using CPU::ProcessNMI;
+  using CPU::ServiceInterrupts;
   using CPU::ReadFromMemory;
   using CPU::SetProgramStartAddress;
   using CPU::SetRegister;
@@ -171,3 +172,72 @@ SCENARIO("CPU NMI processing tests", "[CPU][NMI]") {
     }
   }
 }
+
+SCENARIO("CPU pending interrupts", "[CPU][NMI][IRQ]") {
+  GIVEN("A CPU with NMI and IRQ vectors") {
+    Bus bus;
+    CPUMock cpu{bus};
+    PPU ppu{bus};
+
+    std::vector<uint8_t> rom(0x8000, 0x00);
+    rom[0x7FFA] = 0x00; // NMI vector -> 0xC000
+    rom[0x7FFB] = 0xC0;
+    rom[0x7FFE] = 0x00; // IRQ vector -> 0xD000
+    rom[0x7FFF] = 0xD0;
+    REQUIRE(bus.LoadIntoProgramRom(rom).has_value());
+
+    cpu.SetProgramStartAddress(0x1234);
+    const auto original_sp = cpu.StackPointer();
+
+    WHEN("Nothing is pending") {
+      cpu.ServiceInterrupts();
+
+      THEN("Nothing happens") {
+        REQUIRE(cpu.ProgramCounter() == 0x1234);
+        REQUIRE(cpu.StackPointer() == original_sp);
+      }
+    }
+
+    WHEN("An IRQ is raised while interrupts are disabled") {
+      cpu.SetStatusFlagValue(CPU::StatusFlag::InterruptDisable, true);
+      cpu.RaiseInterrupt(CPU::Interrupt::IRQ);
+      cpu.ServiceInterrupts();
+
+      THEN("It stays pending") {
+        REQUIRE(cpu.ProgramCounter() == 0x1234);
+        REQUIRE(cpu.InterruptPending(CPU::Interrupt::IRQ));
+      }
+
+      AND_WHEN("Interrupts are enabled again") {
+        cpu.SetStatusFlagValue(CPU::StatusFlag::InterruptDisable, false);
+        cpu.ServiceInterrupts();
+
+        THEN("The IRQ handler is entered") {
+          REQUIRE(cpu.ProgramCounter() == 0xD000);
+          REQUIRE(cpu.StackPointer() == original_sp - 3);
+          REQUIRE(cpu.TestStatusFlag(CPU::StatusFlag::InterruptDisable) == true);
+        }
+
+        THEN("The IRQ line stays asserted until its source clears it") {
+          REQUIRE(cpu.InterruptPending(CPU::Interrupt::IRQ));
+          cpu.ClearInterrupt(CPU::Interrupt::IRQ);
+          REQUIRE_FALSE(cpu.InterruptPending(CPU::Interrupt::IRQ));
+        }
+      }
+    }
+
+    WHEN("NMI and IRQ are both pending") {
+      cpu.SetStatusFlagValue(CPU::StatusFlag::InterruptDisable, false);
+      cpu.RaiseInterrupt(CPU::Interrupt::IRQ);
+      cpu.RaiseInterrupt(CPU::Interrupt::NMI);
+      cpu.ServiceInterrupts();
+
+      THEN("The NMI is serviced first and the IRQ has to wait") {
+        REQUIRE(cpu.ProgramCounter() == 0xC000);
+        REQUIRE(cpu.StackPointer() == original_sp - 3);
+        REQUIRE_FALSE(cpu.InterruptPending(CPU::Interrupt::NMI));
+        REQUIRE(cpu.InterruptPending(CPU::Interrupt::IRQ));
+      }
+    }
+  }
+}
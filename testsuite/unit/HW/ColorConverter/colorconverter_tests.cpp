@@ -0,0 +1,70 @@
+//
+// Created by Valerio Formato on 17-Oct-26.
+//
+
+#include "HW/ColorConverter.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <cstdint>
+#include <vector>
+
+using namespace BNES::HW;
+
+SCENARIO("Color index conversion", "[ColorConverter]") {
+  auto implementation = GENERATE(ColorConverter::Implementation::Scalar, ColorConverter::Implementation::SSSE3,
+                                 ColorConverter::Implementation::AVX2);
+  // Nothing to check for instruction sets this CPU doesn't have
+  if (!ColorConverter::Supported(implementation)) {
+    return;
+  }
+
+  // Every byte of every entry is different, so that a byte landing in the wrong place shows up
+  ColorConverter::Palette palette{};
+  for (uint32_t color = 0; color < ColorConverter::N_COLORS; ++color) {
+    palette[color] = (color << 24) | ((color + 0x40) << 16) | ((color + 0x80) << 8) | (color + 0xC0);
+  }
+
+  GIVEN("A whole frame of color indices") {
+    // A simple LCG, with indices past 63 as well
+    std::vector<uint8_t> color_indices(256 * 240);
+    uint32_t state = 12345;
+    for (auto &index : color_indices) {
+      state = state * 1664525 + 1013904223;
+      index = static_cast<uint8_t>(state >> 24);
+    }
+
+    THEN("Every pixel is the palette entry of its index") {
+      std::vector<uint32_t> pixels(color_indices.size());
+      ColorConverter::Convert(implementation, color_indices, palette, pixels);
+      for (size_t i = 0; i < pixels.size(); ++i) {
+        REQUIRE(pixels[i] == palette[color_indices[i] & 0x3F]);
+      }
+    }
+
+    THEN("The dispatched implementation agrees") {
+      std::vector<uint32_t> expected(color_indices.size());
+      std::vector<uint32_t> pixels(color_indices.size());
+      ColorConverter::Convert(ColorConverter::Implementation::Scalar, color_indices, palette, expected);
+      ColorConverter::Convert(color_indices, palette, pixels);
+      REQUIRE(pixels == expected);
+    }
+  }
+
+  GIVEN("A length that is not a multiple of the vector width") {
+    std::vector<uint8_t> color_indices(45);
+    for (size_t i = 0; i < color_indices.size(); ++i) {
+      color_indices[i] = static_cast<uint8_t>(63 - i);
+    }
+
+    THEN("The tail is converted and nothing past it is written") {
+      std::vector<uint32_t> pixels(color_indices.size() + 1, 0xDEADBEEF);
+      ColorConverter::Convert(implementation, color_indices, palette, pixels);
+      for (size_t i = 0; i < color_indices.size(); ++i) {
+        REQUIRE(pixels[i] == palette[63 - i]);
+      }
+      REQUIRE(pixels.back() == 0xDEADBEEF);
+    }
+  }
+}
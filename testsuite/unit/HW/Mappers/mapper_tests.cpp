@@ -0,0 +1,469 @@
+//
+// Created by Valerio Formato on 17-Oct-26.
+//
+
+#include "HW/Bus.h"
+#include "HW/CPU.h"
+#include "HW/Mappers/Mapper.h"
+#include "HW/PPU.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <algorithm>
+#include <vector>
+
+using namespace BNES::HW;
+
+namespace {
+// Every 8KB of PRG and every 1KB of CHR starts with its own bank number, so that reads tell which bank is mapped
+Rom MakeRom(uint16_t mapper, size_t prg_size, size_t chr_size) {
+  Rom rom;
+  rom.mapper = mapper;
+  rom.program_rom.resize(prg_size);
+  for (size_t offset = 0; offset < prg_size; offset += 0x2000) {
+    rom.program_rom[offset] = static_cast<uint8_t>(offset / 0x2000);
+  }
+  rom.character_rom.resize(chr_size);
+  for (size_t offset = 0; offset < chr_size; offset += 0x400) {
+    rom.character_rom[offset] = static_cast<uint8_t>(offset / 0x400);
+  }
+  return rom;
+}
+
+// MMC1 registers are loaded one bit at a time, LSB first
+void WriteMMC1Register(Bus &bus, Bus::Addr address, uint8_t value) {
+  for (unsigned int bit = 0; bit < 5; ++bit) {
+    bus.Write(address, (value >> bit) & 0x1);
+  }
+}
+} // namespace
+
+SCENARIO("Mapper selection", "[Mapper]") {
+  GIVEN("A bus") {
+    Bus bus;
+
+    WHEN("A cartridge with a supported mapper is inserted") {
+      auto mapper = GENERATE(0, 1, 2, 3, 4);
+      REQUIRE(bus.LoadRom(MakeRom(mapper, 0x8000, 0x2000)).has_value());
+
+      THEN("The matching mapper is created") {
+        REQUIRE(bus.CartridgeMapper() != nullptr);
+        REQUIRE(bus.CartridgeMapper()->Number() == mapper);
+      }
+    }
+
+    WHEN("A cartridge with an unsupported mapper is inserted") {
+      auto result = bus.LoadRom(MakeRom(7, 0x8000, 0x2000));
+
+      THEN("We get an error and writes to ROM are ignored") {
+        REQUIRE(!result.has_value());
+        REQUIRE(result.error().Code() == std::errc::not_supported);
+        REQUIRE(bus.CartridgeMapper() == nullptr);
+        bus.Write(0x8000, 0x01);
+        REQUIRE(bus.Diagnostics().rom_writes == 1);
+      }
+    }
+  }
+}
+
+SCENARIO("NROM mapping", "[Mapper][NROM]") {
+  GIVEN("A cartridge with 16KB of PRG ROM") {
+    Bus bus;
+    REQUIRE(bus.LoadRom(MakeRom(0, 0x4000, 0x2000)).has_value());
+
+    THEN("The PRG ROM is mirrored at $C000") {
+      REQUIRE(bus.Read(0x8000) == 0);
+      REQUIRE(bus.Read(0xA000) == 1);
+      REQUIRE(bus.Read(0xC000) == 0);
+      REQUIRE(bus.Read(0xE000) == 1);
+    }
+
+    THEN("The CHR ROM is seen by the PPU") {
+      REQUIRE(bus.ReadCharacter(0x0000) == 0);
+      REQUIRE(bus.ReadCharacter(0x0C00) == 3);
+      REQUIRE(bus.ReadCharacter(0x1C00) == 7);
+    }
+  }
+}
+
+SCENARIO("UxROM bank switching", "[Mapper][UxROM]") {
+  GIVEN("A cartridge with 8 PRG banks of 16KB") {
+    Bus bus;
+    REQUIRE(bus.LoadRom(MakeRom(2, 0x20000, 0x2000)).has_value());
+
+    THEN("The first bank is at $8000 and the last one at $C000") {
+      REQUIRE(bus.Read(0x8000) == 0);
+      REQUIRE(bus.Read(0xC000) == 14);
+    }
+
+    WHEN("A bank is selected") {
+      bus.Write(0x8000, 3);
+
+      THEN("It shows up at $8000, while $C000 stays fixed") {
+        REQUIRE(bus.Read(0x8000) == 6);
+        REQUIRE(bus.Read(0xA000) == 7);
+        REQUIRE(bus.Read(0xC000) == 14);
+        REQUIRE(bus.Diagnostics().rom_writes == 0);
+      }
+    }
+  }
+}
+
+SCENARIO("CNROM bank switching", "[Mapper][CNROM]") {
+  GIVEN("A cartridge with 4 CHR banks of 8KB") {
+    Bus bus;
+    REQUIRE(bus.LoadRom(MakeRom(3, 0x8000, 0x8000)).has_value());
+
+    WHEN("A CHR bank is selected") {
+      bus.Write(0xFFFF, 2);
+
+      THEN("The PPU sees the new pattern tables") {
+        REQUIRE(bus.ReadCharacter(0x0000) == 16);
+        REQUIRE(bus.ReadCharacter(0x1C00) == 23);
+      }
+
+      THEN("PRG ROM does not move") {
+        REQUIRE(bus.Read(0x8000) == 0);
+        REQUIRE(bus.Read(0xE000) == 3);
+      }
+    }
+  }
+}
+
+SCENARIO("MMC1 bank switching", "[Mapper][MMC1]") {
+  GIVEN("A cartridge with 8 PRG banks of 16KB and 4 CHR banks of 8KB") {
+    Bus bus;
+    REQUIRE(bus.LoadRom(MakeRom(1, 0x20000, 0x8000)).has_value());
+
+    THEN("The last PRG bank is fixed at $C000 on power-on") { REQUIRE(bus.Read(0xC000) == 14); }
+
+    WHEN("The PRG bank register is written one bit at a time") {
+      bus.Write(0xE000, 0x1);
+      bus.Write(0xE000, 0x0);
+
+      THEN("Nothing happens until the fifth write") { REQUIRE(bus.Read(0x8000) == 0); }
+
+      AND_WHEN("A write with bit 7 set comes in") {
+        bus.Write(0xE000, 0x80);
+        WriteMMC1Register(bus, 0xE000, 2);
+
+        THEN("The shift register starts over") { REQUIRE(bus.Read(0x8000) == 4); }
+      }
+    }
+
+    WHEN("The switchable bank is moved to $C000") {
+      WriteMMC1Register(bus, 0x8000, 0b01000);
+      WriteMMC1Register(bus, 0xE000, 5);
+
+      THEN("The first bank is fixed at $8000") {
+        REQUIRE(bus.Read(0x8000) == 0);
+        REQUIRE(bus.Read(0xC000) == 10);
+      }
+    }
+
+    WHEN("32KB PRG mode is selected") {
+      WriteMMC1Register(bus, 0x8000, 0b00000);
+      WriteMMC1Register(bus, 0xE000, 3);
+
+      THEN("The low bit of the bank number is ignored") {
+        REQUIRE(bus.Read(0x8000) == 4);
+        REQUIRE(bus.Read(0xC000) == 6);
+      }
+    }
+
+    WHEN("4KB CHR mode is selected") {
+      WriteMMC1Register(bus, 0x8000, 0b10000);
+      WriteMMC1Register(bus, 0xA000, 3);
+      WriteMMC1Register(bus, 0xC000, 6);
+
+      THEN("The two pattern tables are switched independently") {
+        REQUIRE(bus.ReadCharacter(0x0000) == 12);
+        REQUIRE(bus.ReadCharacter(0x1000) == 24);
+      }
+    }
+
+    WHEN("The mirroring bits are written") {
+      auto [bits, mirroring] = GENERATE(std::pair{0, Rom::Mirroring::SingleScreenLower},
+                                        std::pair{1, Rom::Mirroring::SingleScreenUpper},
+                                        std::pair{2, Rom::Mirroring::Vertical},
+                                        std::pair{3, Rom::Mirroring::Horizontal});
+      WriteMMC1Register(bus, 0x8000, 0b01100 | bits);
+
+      THEN("The nametable mirroring changes") { REQUIRE(bus.NametableMirroring() == mirroring); }
+    }
+  }
+}
+
+SCENARIO("CHR-RAM", "[Mapper][CHR]") {
+  GIVEN("A UxROM cartridge without CHR ROM") {
+    Bus bus;
+    Bus::CharacterTileBitmap dirty_tiles;
+    bus.TrackCharacterTiles(&dirty_tiles);
+    REQUIRE(bus.LoadRom(MakeRom(2, 0x20000, 0)).has_value());
+
+    THEN("There is 8KB of CHR-RAM and every tile starts out dirty") {
+      REQUIRE(bus.CharacterRam().size() == 0x2000);
+      REQUIRE(dirty_tiles.all());
+    }
+
+    WHEN("The pattern tables are written") {
+      dirty_tiles.reset();
+      REQUIRE(bus.WriteCharacter(0x1234, 0xAB));
+
+      THEN("The PPU reads the new data back") { REQUIRE(bus.ReadCharacter(0x1234) == 0xAB); }
+
+      THEN("Only the tile that was written is dirty") {
+        REQUIRE(dirty_tiles.count() == 1);
+        REQUIRE(dirty_tiles[0x1234 / Bus::CHR_TILE_SIZE]);
+      }
+    }
+
+    WHEN("The bitmap is no longer tracked") {
+      bus.UntrackCharacterTiles(&dirty_tiles);
+      dirty_tiles.reset();
+      REQUIRE(bus.WriteCharacter(0x0000, 0xAB));
+
+      THEN("Writes do not touch it") { REQUIRE(dirty_tiles.none()); }
+    }
+    bus.UntrackCharacterTiles(&dirty_tiles);
+  }
+
+  GIVEN("An MMC1 cartridge with 32KB of CHR-RAM") {
+    Bus bus;
+    Bus::CharacterTileBitmap dirty_tiles;
+    bus.TrackCharacterTiles(&dirty_tiles);
+    auto rom = MakeRom(1, 0x20000, 0);
+    rom.chr_ram_size = 0x8000;
+    REQUIRE(bus.LoadRom(std::move(rom)).has_value());
+
+    THEN("The CHR-RAM size comes from the header") { REQUIRE(bus.CharacterRam().size() == 0x8000); }
+
+    WHEN("A different 4KB bank is switched in for the second pattern table") {
+      bus.CharacterRam()[0x3000] = 0x42;
+      WriteMMC1Register(bus, 0x8000, 0b10000);
+      dirty_tiles.reset();
+      WriteMMC1Register(bus, 0xC000, 3);
+
+      THEN("The PPU sees that bank, and all of its tiles are dirty") {
+        REQUIRE(bus.ReadCharacter(0x1000) == 0x42);
+        REQUIRE(dirty_tiles.count() == 256);
+        REQUIRE(dirty_tiles[256]);
+        REQUIRE(!dirty_tiles[255]);
+      }
+    }
+    bus.UntrackCharacterTiles(&dirty_tiles);
+  }
+
+  GIVEN("A cartridge with CHR ROM") {
+    Bus bus;
+    REQUIRE(bus.LoadRom(MakeRom(3, 0x8000, 0x8000)).has_value());
+
+    THEN("There is no CHR-RAM and the pattern tables can't be written") {
+      REQUIRE(bus.CharacterRam().empty());
+      REQUIRE(!bus.WriteCharacter(0x0000, 0xAB));
+      REQUIRE(bus.ReadCharacter(0x0000) == 0);
+    }
+  }
+}
+
+SCENARIO("MMC3 bank switching", "[Mapper][MMC3]") {
+  GIVEN("A cartridge with 16 PRG banks of 8KB and 32 CHR banks of 1KB") {
+    Bus bus;
+    REQUIRE(bus.LoadRom(MakeRom(4, 0x20000, 0x8000)).has_value());
+
+    THEN("The last two PRG banks are fixed at $C000 and $E000") {
+      REQUIRE(bus.Read(0xC000) == 14);
+      REQUIRE(bus.Read(0xE000) == 15);
+    }
+
+    WHEN("R6 and R7 are written") {
+      bus.Write(0x8000, 6);
+      bus.Write(0x8001, 3);
+      bus.Write(0x8000, 7);
+      bus.Write(0x8001, 9);
+
+      THEN("They select the banks at $8000 and $A000") {
+        REQUIRE(bus.Read(0x8000) == 3);
+        REQUIRE(bus.Read(0xA000) == 9);
+      }
+
+      AND_WHEN("The PRG mode bit is set") {
+        bus.Write(0x8000, 0x40);
+
+        THEN("The R6 bank and the second to last bank swap places") {
+          REQUIRE(bus.Read(0x8000) == 14);
+          REQUIRE(bus.Read(0xA000) == 9);
+          REQUIRE(bus.Read(0xC000) == 3);
+          REQUIRE(bus.Read(0xE000) == 15);
+        }
+      }
+    }
+
+    WHEN("The CHR registers are written") {
+      bus.Write(0x8000, 0);
+      bus.Write(0x8001, 9); // 2KB bank, the low bit is ignored
+      bus.Write(0x8000, 5);
+      bus.Write(0x8001, 20);
+
+      THEN("They select 2KB and 1KB banks") {
+        REQUIRE(bus.ReadCharacter(0x0000) == 8);
+        REQUIRE(bus.ReadCharacter(0x0400) == 9);
+        REQUIRE(bus.ReadCharacter(0x1C00) == 20);
+      }
+
+      AND_WHEN("The CHR inversion bit is set") {
+        bus.Write(0x8000, 0x80);
+
+        THEN("The two pattern tables swap places") {
+          REQUIRE(bus.ReadCharacter(0x1000) == 8);
+          REQUIRE(bus.ReadCharacter(0x0C00) == 20);
+        }
+      }
+    }
+
+    WHEN("The mirroring register is written") {
+      bus.Write(0xA000, 1);
+      THEN("The nametable mirroring changes") { REQUIRE(bus.NametableMirroring() == Rom::Mirroring::Horizontal); }
+    }
+  }
+}
+
+SCENARIO("Bank switching code that was already decoded", "[Mapper][CPU]") {
+  auto engine = GENERATE(CPU::ExecutionEngine::Variant, CPU::ExecutionEngine::Table, CPU::ExecutionEngine::Block,
+                        CPU::ExecutionEngine::Dynarec);
+
+  GIVEN("A UxROM program calling the same address in two different banks") {
+    Rom rom = MakeRom(2, 0xC000, 0x2000);
+    // clang-format off
+    std::ranges::copy(std::vector<uint8_t>{
+        0xA2, 0x11,       // $8000 LDX #$11
+        0x60,             // $8002 RTS
+    }, rom.program_rom.begin());
+    std::ranges::copy(std::vector<uint8_t>{
+        0xA2, 0x22,       // $8000 LDX #$22
+        0x60,             // $8002 RTS
+    }, rom.program_rom.begin() + 0x4000);
+    std::ranges::copy(std::vector<uint8_t>{
+        0x20, 0x00, 0x80, // $C000 JSR $8000
+        0x86, 0x00,       // $C003 STX $00
+        0xA9, 0x01,       // $C005 LDA #$01
+        0x8D, 0x00, 0xC0, // $C007 STA $C000
+        0x20, 0x00, 0x80, // $C00A JSR $8000
+        0x86, 0x01,       // $C00D STX $01
+        0x4C, 0x0F, 0xC0, // $C00F JMP $C00F
+    }, rom.program_rom.begin() + 0x8000);
+    // clang-format on
+    // Reset vector -> $C000
+    rom.program_rom[0xBFFC] = 0x00;
+    rom.program_rom[0xBFFD] = 0xC0;
+
+    Bus bus;
+    REQUIRE(bus.LoadRom(std::move(rom)).has_value());
+    PPU ppu{bus};
+    CPU cpu{bus};
+    cpu.Init();
+    cpu.SetEngine(engine);
+
+    WHEN("The program runs") {
+      for (unsigned int i = 0; i < 20; ++i) {
+        cpu.Step();
+      }
+
+      THEN("The second call runs the code of the new bank") {
+        REQUIRE(bus.Read(0x0000) == 0x11);
+        REQUIRE(bus.Read(0x0001) == 0x22);
+      }
+    }
+  }
+
+  GIVEN("A UxROM program switching banks in a loop from the fixed bank") {
+    Rom rom = MakeRom(2, 0xC000, 0x2000);
+    // clang-format off
+    std::ranges::copy(std::vector<uint8_t>{
+        0xE8,             // $8000 INX
+        0x60,             // $8001 RTS
+    }, rom.program_rom.begin());
+    std::ranges::copy(std::vector<uint8_t>{
+        0xC8,             // $8000 INY
+        0x60,             // $8001 RTS
+    }, rom.program_rom.begin() + 0x4000);
+    std::ranges::copy(std::vector<uint8_t>{
+        0xA9, 0x00,       // $C000 LDA #$00
+        0x8D, 0x00, 0xC0, // $C002 STA $C000
+        0x20, 0x00, 0x80, // $C005 JSR $8000
+        0xA9, 0x01,       // $C008 LDA #$01
+        0x8D, 0x00, 0xC0, // $C00A STA $C000
+        0x20, 0x00, 0x80, // $C00D JSR $8000
+        0x4C, 0x00, 0xC0, // $C010 JMP $C000
+    }, rom.program_rom.begin() + 0x8000);
+    // clang-format on
+    rom.program_rom[0xBFFC] = 0x00;
+    rom.program_rom[0xBFFD] = 0xC0;
+
+    Bus bus;
+    REQUIRE(bus.LoadRom(std::move(rom)).has_value());
+    PPU ppu{bus};
+    CPU cpu{bus};
+    cpu.Init();
+    cpu.SetEngine(engine);
+    const auto icache_flushes = cpu.GetInstructionCacheStats().flushes;
+    const auto block_flushes = cpu.GetBlockCacheStats().flushes;
+
+    WHEN("The loop runs 100 times") {
+      while (cpu.Registers()[CPU::Register::X] < 100) {
+        cpu.Step();
+      }
+
+      THEN("Both banks run every time, and only the code of the switched bank is dropped") {
+        REQUIRE(cpu.Registers()[CPU::Register::Y] == 99);
+        REQUIRE(cpu.GetInstructionCacheStats().flushes == icache_flushes);
+        REQUIRE(cpu.GetBlockCacheStats().flushes == block_flushes);
+        if (engine == CPU::ExecutionEngine::Block || engine == CPU::ExecutionEngine::Dynarec) {
+          // The blocks of the fixed bank are built once (five of them, since a block stops after a switch that drops
+          // code), the one at $8000 every time it runs after a switch
+          REQUIRE(cpu.GetBlockCacheStats().blocks_built == 5 + 199);
+        }
+      }
+    }
+  }
+}
+
+SCENARIO("MMC3 scanline counter", "[Mapper][MMC3]") {
+  GIVEN("An MMC3 cartridge with the IRQ latch set to 3") {
+    Bus bus;
+    REQUIRE(bus.LoadRom(MakeRom(4, 0x8000, 0x2000)).has_value());
+    CPU cpu{bus};
+    bus.Write(0xC000, 3);
+    bus.Write(0xC001, 0);
+
+    WHEN("IRQs are disabled") {
+      for (unsigned int i = 0; i < 8; ++i) {
+        bus.ClockScanlineCounter();
+      }
+
+      THEN("No IRQ is raised") { REQUIRE_FALSE(cpu.InterruptPending(CPU::Interrupt::IRQ)); }
+    }
+
+    WHEN("IRQs are enabled") {
+      bus.Write(0xE001, 0);
+      REQUIRE(bus.CartridgeMapper()->ClocksUntilIRQ() == 4u);
+
+      THEN("The IRQ is raised when the counter reaches zero, one clock after the reload") {
+        for (unsigned int i = 0; i < 3; ++i) {
+          bus.ClockScanlineCounter();
+        }
+        REQUIRE_FALSE(cpu.InterruptPending(CPU::Interrupt::IRQ));
+        REQUIRE(bus.CartridgeMapper()->ClocksUntilIRQ() == 1u);
+        bus.ClockScanlineCounter();
+        REQUIRE(cpu.InterruptPending(CPU::Interrupt::IRQ));
+
+        AND_THEN("Disabling IRQs acknowledges it") {
+          bus.Write(0xE000, 0);
+          REQUIRE_FALSE(cpu.InterruptPending(CPU::Interrupt::IRQ));
+          REQUIRE_FALSE(bus.CartridgeMapper()->ClocksUntilIRQ().has_value());
+        }
+      }
+    }
+  }
+}
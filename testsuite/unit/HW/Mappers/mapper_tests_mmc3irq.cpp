@@ -0,0 +1,156 @@
+//
+// Created by Valerio Formato on 17-Oct-26.
+//
+
+#include "HW/Bus.h"
+#include "HW/CPU.h"
+#include "HW/PPU.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <algorithm>
+#include <vector>
+
+using namespace BNES::HW;
+
+namespace {
+constexpr unsigned int DOTS_PER_SCANLINE = 341;
+
+// A game with a status bar at the top of the screen and another split further down, driven by the MMC3 IRQ: the NMI
+// handler arms the counter for the top split, the first IRQ re-arms it for the second one.
+Rom MakeSplitScreenRom(uint8_t ppu_ctrl, uint8_t ppu_mask) {
+  Rom rom;
+  rom.mapper = 4;
+  rom.program_rom.resize(0x8000);
+  rom.character_rom.resize(0x2000);
+
+  // clang-format off
+  const std::vector<uint8_t> program{
+      0x78,             // $E000 SEI
+      0xA2, 0xFF,       // $E001 LDX #$FF
+      0x9A,             // $E003 TXS
+      0x2C, 0x02, 0x20, // $E004 BIT $2002
+      0x10, 0xFB,       // $E007 BPL $E004
+      0xA9, ppu_ctrl,   // $E009 LDA #ppu_ctrl
+      0x8D, 0x00, 0x20, // $E00B STA $2000
+      0xA9, ppu_mask,   // $E00E LDA #ppu_mask
+      0x8D, 0x01, 0x20, // $E010 STA $2001
+      0x58,             // $E013 CLI
+      0x4C, 0x14, 0xE0, // $E014 JMP $E014
+      // NMI handler
+      0x48,             // $E017 PHA
+      0xA9, 0x20,       // $E018 LDA #$20
+      0x8D, 0x00, 0xC0, // $E01A STA $C000 (32 lines of status bar)
+      0x8D, 0x01, 0xC0, // $E01D STA $C001
+      0x8D, 0x01, 0xE0, // $E020 STA $E001
+      0xA9, 0x00,       // $E023 LDA #$00
+      0x85, 0x10,       // $E025 STA $10
+      0x68,             // $E027 PLA
+      0x40,             // $E028 RTI
+      // IRQ handler
+      0x48,             // $E029 PHA
+      0x8D, 0x00, 0xE0, // $E02A STA $E000
+      0xE6, 0x10,       // $E02D INC $10
+      0xA9, 0x00,       // $E02F LDA #$00
+      0x8D, 0x05, 0x20, // $E031 STA $2005
+      0x8D, 0x05, 0x20, // $E034 STA $2005
+      0xA5, 0x10,       // $E037 LDA $10
+      0xC9, 0x02,       // $E039 CMP #$02
+      0xF0, 0x08,       // $E03B BEQ $E045
+      0xA9, 0x9F,       // $E03D LDA #$9F
+      0x8D, 0x00, 0xC0, // $E03F STA $C000 (next split 160 lines below)
+      0x8D, 0x01, 0xE0, // $E042 STA $E001
+      0x68,             // $E045 PLA
+      0x40,             // $E046 RTI
+  };
+  // clang-format on
+  std::ranges::copy(program, rom.program_rom.begin() + 0x6000);
+
+  // NMI -> $E017, RESET -> $E000, IRQ -> $E029
+  rom.program_rom[0x7FFA] = 0x17;
+  rom.program_rom[0x7FFB] = 0xE0;
+  rom.program_rom[0x7FFC] = 0x00;
+  rom.program_rom[0x7FFD] = 0xE0;
+  rom.program_rom[0x7FFE] = 0x29;
+  rom.program_rom[0x7FFF] = 0xE0;
+
+  return rom;
+}
+
+struct RasterPosition {
+  unsigned int scanline;
+  unsigned int dot;
+};
+
+// Where the PPU is every time the IRQ line goes up
+std::vector<RasterPosition> RunFrames(Bus &bus, CPU &cpu, const PPU &ppu, unsigned int n_frames) {
+  std::vector<RasterPosition> irqs;
+
+  bool irq_pending = false;
+  const size_t end = cpu.Cycles() + n_frames * 29781;
+  while (cpu.Cycles() < end) {
+    cpu.Step();
+    if (cpu.InterruptPending(CPU::Interrupt::IRQ) && !irq_pending) {
+      bus.Sync();
+      irqs.push_back({ppu.CurrentScanline(), static_cast<unsigned int>(ppu.Cycles())});
+    }
+    irq_pending = cpu.InterruptPending(CPU::Interrupt::IRQ);
+  }
+
+  return irqs;
+}
+} // namespace
+
+SCENARIO("MMC3 IRQ timing on split-screen status bars", "[Mapper][MMC3][Integration]") {
+  auto catch_up = GENERATE(false, true);
+
+  GIVEN("An MMC3 game splitting the screen after scanlines 31 and 191") {
+    // The A12 rising edge depends on which pattern table the sprites and the background use
+    auto [ppu_ctrl, edge_dot] = GENERATE(std::pair{uint8_t{0x88}, 260u}, std::pair{uint8_t{0x90}, 324u});
+
+    Bus bus;
+    REQUIRE(bus.LoadRom(MakeSplitScreenRom(ppu_ctrl, 0x18)).has_value());
+    PPU ppu{bus};
+    CPU cpu{bus};
+    ppu.Init();
+    cpu.Init();
+    bus.SetCatchUpEnabled(catch_up);
+
+    WHEN("A few frames are rendered") {
+      // The first frame goes by waiting for vblank, the NMI handler arms the counter from the second one
+      const auto irqs = RunFrames(bus, cpu, ppu, 5);
+
+      THEN("Each IRQ fires on its scanline, right after the A12 edge") {
+        REQUIRE(irqs.size() >= 6);
+        REQUIRE(irqs.size() % 2 == 0);
+        for (size_t index = 0; index < irqs.size(); ++index) {
+          const auto &irq = irqs[index];
+          INFO("IRQ #" << index << " at scanline " << irq.scanline << ", dot " << irq.dot);
+          const unsigned int expected_scanline = (index % 2) ? 191 : 31;
+          const unsigned int position = irq.scanline * DOTS_PER_SCANLINE + irq.dot;
+          const unsigned int edge = expected_scanline * DOTS_PER_SCANLINE + edge_dot;
+          // The CPU notices at the end of the instruction crossing the edge (the 3-cycle JMP of the main loop)
+          REQUIRE(position > edge);
+          REQUIRE(position <= edge + 3 * 3);
+        }
+      }
+    }
+  }
+
+  GIVEN("The same game with rendering disabled") {
+    Bus bus;
+    REQUIRE(bus.LoadRom(MakeSplitScreenRom(0x88, 0x00)).has_value());
+    PPU ppu{bus};
+    CPU cpu{bus};
+    ppu.Init();
+    cpu.Init();
+    bus.SetCatchUpEnabled(catch_up);
+
+    WHEN("A few frames are run") {
+      const auto irqs = RunFrames(bus, cpu, ppu, 4);
+
+      THEN("A12 never toggles and no IRQ is raised") { REQUIRE(irqs.empty()); }
+    }
+  }
+}
@@ -4,6 +4,10 @@
 #include "HW/PPU.h"
 
 #include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <array>
+#include <utility>
 
 using namespace BNES::HW;
 
@@ -15,6 +19,7 @@ public:
   using PPU::PPU;
   using PPU::PPUMasterSlaveSelect;
   using PPU::ReadPPUDATA;
+  using PPU::SetMirroring;
   using PPU::SpritePatternTableAddress;
   using PPU::SpriteSize;
   using PPU::VblankNMIEnabled;
@@ -449,6 +454,14 @@ SCENARIO("PPUDATA register write tests", "[PPU]") {
       }
     }
 
+    WHEN("writing to the nametable mirror at 0x3123") {
+      ppu.WritePPUADDR(0x31);
+      ppu.WritePPUADDR(0x23);
+      ppu.WritePPUDATA(0x4B);
+
+      THEN("the value should land in the nametable at 0x2123") { REQUIRE(ppu.ReadFromVRAM(0x123) == 0x4B); }
+    }
+
     WHEN("writing multiple values to VRAM sequentially") {
       ppu.WritePPUADDR(0x21);
       ppu.WritePPUADDR(0x00);
@@ -492,29 +505,55 @@ SCENARIO("PPUDATA register write tests", "[PPU]") {
     }
 
     WHEN("writing to CHR ROM region (< 0x2000)") {
+      REQUIRE(bus.LoadIntoChrRom(std::vector<uint8_t>(0x2000)).has_value());
       ppu.WritePPUADDR(0x10);
       ppu.WritePPUADDR(0x00);
 
-      THEN("writing to PPUDATA should throw an exception") {
-        REQUIRE_THROWS_AS(ppu.WritePPUDATA(0xFF), std::runtime_error);
+      THEN("writing to PPUDATA is ignored") {
+        const auto address = ppu.AddressRegister();
+        ppu.WritePPUDATA(0xFF);
+        REQUIRE(ppu.IgnoredCHRWrites() == 1);
+        REQUIRE(ppu.AddressRegister() == address + 1);
       }
     }
 
     WHEN("writing to address 0x0000 (CHR ROM)") {
+      REQUIRE(bus.LoadIntoChrRom(std::vector<uint8_t>(0x2000)).has_value());
       ppu.WritePPUADDR(0x00);
       ppu.WritePPUADDR(0x00);
 
-      THEN("writing to PPUDATA should throw an exception") {
-        REQUIRE_THROWS_AS(ppu.WritePPUDATA(0xFF), std::runtime_error);
+      THEN("writing to PPUDATA is ignored") {
+        const auto address = ppu.AddressRegister();
+        ppu.WritePPUDATA(0xFF);
+        REQUIRE(ppu.IgnoredCHRWrites() == 1);
+        REQUIRE(ppu.AddressRegister() == address + 1);
       }
     }
 
     WHEN("writing to address 0x1FFF (last CHR ROM address)") {
+      REQUIRE(bus.LoadIntoChrRom(std::vector<uint8_t>(0x2000)).has_value());
       ppu.WritePPUADDR(0x1F);
       ppu.WritePPUADDR(0xFF);
 
-      THEN("writing to PPUDATA should throw an exception") {
-        REQUIRE_THROWS_AS(ppu.WritePPUDATA(0xFF), std::runtime_error);
+      THEN("writing to PPUDATA is ignored") {
+        const auto address = ppu.AddressRegister();
+        ppu.WritePPUDATA(0xFF);
+        REQUIRE(ppu.IgnoredCHRWrites() == 1);
+        REQUIRE(ppu.AddressRegister() == address + 1);
+      }
+    }
+
+    WHEN("writing to CHR-RAM (no CHR ROM loaded)") {
+      ppu.WritePPUADDR(0x12);
+      ppu.WritePPUADDR(0x34);
+      ppu.WritePPUDATA(0xAB);
+
+      THEN("the value can be read back through the read buffer") {
+        REQUIRE(ppu.IgnoredCHRWrites() == 0);
+        ppu.WritePPUADDR(0x12);
+        ppu.WritePPUADDR(0x34);
+        (void)ppu.ReadPPUDATA();
+        REQUIRE(ppu.ReadPPUDATA() == 0xAB);
       }
     }
 
@@ -554,3 +593,84 @@ SCENARIO("PPUDATA register write tests", "[PPU]") {
     }
   }
 }
+
+SCENARIO("Decoded pattern table tiles", "[PPU]") {
+  GIVEN("a PPU on a cartridge with CHR-RAM") {
+    Bus bus;
+    PPUMock ppu{bus};
+
+    // Tile $23 of the second pattern table: color 1 in the top-left corner, color 2 in the bottom-right one
+    constexpr Bus::Addr tile_address = 0x1000 + 0x23 * PPU::TILE_MEMORY_SIZE;
+    REQUIRE(bus.WriteCharacter(tile_address, 0b10000000));
+    REQUIRE(bus.WriteCharacter(tile_address + 15, 0b00000001));
+
+    THEN("the tile is decoded in all four orientations") {
+      const auto &tile = ppu.DecodedTile(1, 0x23);
+      REQUIRE(tile[0] == 1);
+      REQUIRE(tile[63] == 2);
+
+      const auto &flipped_h = ppu.DecodedTile(1, 0x23, true, false);
+      REQUIRE(flipped_h[7] == 1);
+      REQUIRE(flipped_h[56] == 2);
+
+      const auto &flipped_v = ppu.DecodedTile(1, 0x23, false, true);
+      REQUIRE(flipped_v[56] == 1);
+      REQUIRE(flipped_v[7] == 2);
+
+      const auto &flipped_hv = ppu.DecodedTile(1, 0x23, true, true);
+      REQUIRE(flipped_hv[63] == 1);
+      REQUIRE(flipped_hv[0] == 2);
+    }
+
+    WHEN("the tile has been decoded") {
+      REQUIRE(ppu.DecodedTile(1, 0x23)[0] == 1);
+
+      AND_WHEN("CHR-RAM changes behind the bus' back") {
+        bus.CharacterRam()[tile_address] = 0;
+
+        THEN("the cached tile is used") { REQUIRE(ppu.DecodedTile(1, 0x23)[0] == 1); }
+      }
+
+      AND_WHEN("the tile is written through PPUDATA") {
+        ppu.WritePPUADDR(tile_address >> 8);
+        ppu.WritePPUADDR(tile_address & 0xFF);
+        ppu.WritePPUDATA(0x00);
+
+        THEN("it is decoded again") {
+          REQUIRE(ppu.DecodedTile(1, 0x23)[0] == 0);
+          REQUIRE(ppu.DecodedTile(1, 0x23, true, true)[0] == 2);
+        }
+      }
+    }
+  }
+}
+
+SCENARIO("Nametable mirroring", "[PPU]") {
+  GIVEN("a PPU with a nametable layout") {
+    using Pages = std::array<unsigned int, 4>;
+    auto [mirroring, pages] = GENERATE(std::pair{Rom::Mirroring::Vertical, Pages{0, 1, 0, 1}},
+                                       std::pair{Rom::Mirroring::Horizontal, Pages{0, 0, 1, 1}},
+                                       std::pair{Rom::Mirroring::FourScreen, Pages{0, 1, 2, 3}},
+                                       std::pair{Rom::Mirroring::SingleScreenLower, Pages{0, 0, 0, 0}},
+                                       std::pair{Rom::Mirroring::SingleScreenUpper, Pages{1, 1, 1, 1}});
+    Bus bus;
+    PPUMock ppu{bus};
+    ppu.SetMirroring(mirroring);
+
+    WHEN("writing to each nametable and to its mirror at $3000") {
+      THEN("the value lands in the VRAM page the nametable maps to") {
+        for (uint8_t nametable = 0; nametable < 4; ++nametable) {
+          ppu.WritePPUADDR(0x20 + nametable * 4);
+          ppu.WritePPUADDR(0x05);
+          ppu.WritePPUDATA(0x10 + nametable);
+          REQUIRE(ppu.ReadFromVRAM(pages[nametable] * 0x400 + 0x05) == 0x10 + nametable);
+
+          ppu.WritePPUADDR(0x30 + nametable * 4);
+          ppu.WritePPUADDR(0x06);
+          ppu.WritePPUDATA(0x20 + nametable);
+          REQUIRE(ppu.ReadFromVRAM(pages[nametable] * 0x400 + 0x06) == 0x20 + nametable);
+        }
+      }
+    }
+  }
+}
@@ -9,6 +9,13 @@
 
 using namespace BNES::HW;
 
+// The CPU only services interrupts between instructions, these tests do it by hand right after the PPU could raise one
+class CPUMock : public CPU {
+public:
+  using CPU::CPU;
+  using CPU::ServiceInterrupts;
+};
+
 class PPUMock : public PPU {
 public:
   using PPU::IsInVblank;
@@ -21,7 +28,7 @@ public:
 SCENARIO("PPU NMI generation on VBlank entry", "[PPU][NMI]") {
   GIVEN("A PPU and CPU connected via Bus") {
     Bus bus;
-    CPU cpu{bus};
+    CPUMock cpu{bus};
     PPUMock ppu{bus};
 
     // Setup minimal ROM for NMI vector
@@ -46,7 +53,17 @@ SCENARIO("PPU NMI generation on VBlank entry", "[PPU][NMI]") {
       // Tick to scanline 241 (VBlank start)
       ppu.Tick(341);
 
+      // The NMI is only latched, the CPU takes it at the next instruction boundary
+      REQUIRE(cpu.InterruptPending(CPU::Interrupt::NMI));
+      REQUIRE(cpu.ProgramCounter() == original_pc);
+      const auto cpu_cycles = cpu.Cycles();
+      const auto ppu_cycles = ppu.Cycles();
+      cpu.ServiceInterrupts();
+      REQUIRE_FALSE(cpu.InterruptPending(CPU::Interrupt::NMI));
+
       THEN("NMI should be triggered and CPU state should reflect NMI processing") {
+        REQUIRE(cpu.Cycles() == cpu_cycles + 7);
+        REQUIRE(ppu.Cycles() == ppu_cycles + 7 * Bus::PPU_FREQ_RATIO);
         REQUIRE(ppu.CurrentScanline() == 241);
         REQUIRE(ppu.IsInVblank() == true);
         REQUIRE(cpu.ProgramCounter() == 0x1234);        // Jumped to NMI vector
@@ -64,6 +81,7 @@ SCENARIO("PPU NMI generation on VBlank entry", "[PPU][NMI]") {
 
       // Tick to scanline 241
       ppu.Tick(241 * 341);
+      cpu.ServiceInterrupts();
 
       THEN("NMI should not be triggered") {
         REQUIRE(ppu.CurrentScanline() == 241);
@@ -78,6 +96,7 @@ SCENARIO("PPU NMI generation on VBlank entry", "[PPU][NMI]") {
 
       // Enter VBlank
       ppu.Tick(241 * 341);
+      cpu.ServiceInterrupts();
       REQUIRE(ppu.IsInVblank() == true);
 
       // Complete the frame (scanline 261) and go to scanline 0
@@ -94,6 +113,7 @@ SCENARIO("PPU NMI generation on VBlank entry", "[PPU][NMI]") {
 
       // First frame
       ppu.Tick(241 * 341);
+      cpu.ServiceInterrupts();
       auto sp_after_first_nmi = cpu.StackPointer();
 
       // Complete first frame and start second
@@ -102,6 +122,7 @@ SCENARIO("PPU NMI generation on VBlank entry", "[PPU][NMI]") {
 
       // Second frame to VBlank
       ppu.Tick(241 * 341);
+      cpu.ServiceInterrupts();
       auto sp_after_second_nmi = cpu.StackPointer();
 
       THEN("NMI should trigger once per frame") { REQUIRE(sp_after_second_nmi == sp_after_first_nmi - 3); }
@@ -133,7 +154,7 @@ SCENARIO("PPU NMI generation on VBlank entry", "[PPU][NMI]") {
 SCENARIO("PPU NMI generation on PPUCTRL write", "[PPU][NMI]") {
   GIVEN("A PPU and CPU connected via Bus in VBlank") {
     Bus bus;
-    CPU cpu{bus};
+    CPUMock cpu{bus};
     PPUMock ppu{bus};
 
     // Setup minimal ROM for NMI vector
@@ -149,6 +170,7 @@ SCENARIO("PPU NMI generation on PPUCTRL write", "[PPU][NMI]") {
 
       // Enter VBlank with NMI disabled
       ppu.Tick(241 * 341);
+      cpu.ServiceInterrupts();
       REQUIRE(ppu.IsInVblank() == true);
 
       auto original_pc = cpu.ProgramCounter();
@@ -156,6 +178,7 @@ SCENARIO("PPU NMI generation on PPUCTRL write", "[PPU][NMI]") {
 
       // Enable NMI during VBlank
       ppu.WritePPUCTRL(0b10000000);
+      cpu.ServiceInterrupts();
 
       THEN("NMI should be triggered immediately") {
         REQUIRE(ppu.VblankNMIEnabled() == true);
@@ -169,10 +192,12 @@ SCENARIO("PPU NMI generation on PPUCTRL write", "[PPU][NMI]") {
 
       // Enter VBlank
       ppu.Tick(241 * 341);
+      cpu.ServiceInterrupts();
       auto sp_after_first_nmi = cpu.StackPointer();
 
       // Write to PPUCTRL again with NMI still enabled
       ppu.WritePPUCTRL(0b10000011); // NMI still enabled, change other bits
+      cpu.ServiceInterrupts();
 
       THEN("No additional NMI should be triggered") {
         REQUIRE(ppu.VblankNMIEnabled() == true);
@@ -185,10 +210,12 @@ SCENARIO("PPU NMI generation on PPUCTRL write", "[PPU][NMI]") {
 
       // Enter VBlank
       ppu.Tick(241 * 341);
+      cpu.ServiceInterrupts();
       auto sp_after_nmi = cpu.StackPointer();
 
       // Disable NMI during VBlank
       ppu.WritePPUCTRL(0b00000000);
+      cpu.ServiceInterrupts();
 
       THEN("No additional NMI should be triggered") {
         REQUIRE(ppu.VblankNMIEnabled() == false);
@@ -208,6 +235,7 @@ SCENARIO("PPU NMI generation on PPUCTRL write", "[PPU][NMI]") {
 
       // Enable NMI outside VBlank
       ppu.WritePPUCTRL(0b10000000);
+      cpu.ServiceInterrupts();
 
       THEN("NMI should not be triggered") {
         REQUIRE(ppu.VblankNMIEnabled() == true);
@@ -227,6 +255,7 @@ SCENARIO("PPU NMI generation on PPUCTRL write", "[PPU][NMI]") {
       ppu.WritePPUCTRL(0b00000000); // Disable
       ppu.WritePPUCTRL(0b10000000); // Enable again
       ppu.WritePPUCTRL(0b00000000); // Disable again
+      cpu.ServiceInterrupts();
 
       THEN("No NMI should be triggered outside VBlank") {
         REQUIRE(cpu.ProgramCounter() == original_pc);
@@ -239,12 +268,14 @@ SCENARIO("PPU NMI generation on PPUCTRL write", "[PPU][NMI]") {
 
       // Tick to exactly scanline 241, cycle 0
       ppu.Tick(241 * 341);
+      cpu.ServiceInterrupts();
       REQUIRE(ppu.CurrentScanline() == 241);
 
       auto original_sp = cpu.StackPointer();
 
       // Enable NMI at the very start of VBlank
       ppu.WritePPUCTRL(0b10000000);
+      cpu.ServiceInterrupts();
 
       THEN("NMI should be triggered immediately") { REQUIRE(cpu.StackPointer() == original_sp - 3); }
     }
@@ -254,16 +285,19 @@ SCENARIO("PPU NMI generation on PPUCTRL write", "[PPU][NMI]") {
 
       // Enter VBlank without NMI
       ppu.Tick(241 * 341);
+      cpu.ServiceInterrupts();
       REQUIRE(ppu.IsInVblank() == true);
 
       // Tick through most of VBlank (scanlines 241-260)
       ppu.Tick(19 * 341);
+      cpu.ServiceInterrupts();
       REQUIRE(ppu.CurrentScanline() == 260);
 
       auto original_sp = cpu.StackPointer();
 
       // Enable NMI near end of VBlank
       ppu.WritePPUCTRL(0b10000000);
+      cpu.ServiceInterrupts();
 
       THEN("NMI should still be triggered") { REQUIRE(cpu.StackPointer() == original_sp - 3); }
     }
@@ -273,7 +307,7 @@ SCENARIO("PPU NMI generation on PPUCTRL write", "[PPU][NMI]") {
 SCENARIO("PPU NMI edge cases", "[PPU][NMI]") {
   GIVEN("A PPU and CPU connected via Bus") {
     Bus bus;
-    CPU cpu{bus};
+    CPUMock cpu{bus};
     PPUMock ppu{bus};
 
     std::vector<uint8_t> rom(0x8000, 0x00);
@@ -291,12 +325,14 @@ SCENARIO("PPU NMI edge cases", "[PPU][NMI]") {
 
       // Disable NMI before VBlank
       ppu.WritePPUCTRL(0b00000000);
+      cpu.ServiceInterrupts();
 
       auto original_pc = cpu.ProgramCounter();
       auto original_sp = cpu.StackPointer();
 
       // Enter VBlank
       ppu.Tick(341);
+      cpu.ServiceInterrupts();
 
       THEN("No NMI should be triggered") {
         REQUIRE(ppu.CurrentScanline() == 241);
@@ -311,18 +347,22 @@ SCENARIO("PPU NMI edge cases", "[PPU][NMI]") {
 
       // Enter VBlank
       ppu.Tick(241 * 341);
+      cpu.ServiceInterrupts();
       REQUIRE(ppu.IsInVblank() == true);
 
       // Enable NMI (should trigger)
       ppu.WritePPUCTRL(0b10000000);
+      cpu.ServiceInterrupts();
       auto sp_after_first = cpu.StackPointer();
 
       // Disable NMI
       ppu.WritePPUCTRL(0b00000000);
+      cpu.ServiceInterrupts();
       REQUIRE(cpu.StackPointer() == sp_after_first);
 
       // Re-enable NMI (should trigger again due to 0->1 transition)
       ppu.WritePPUCTRL(0b10000000);
+      cpu.ServiceInterrupts();
 
       THEN("NMI should trigger again on second 0->1 transition") { REQUIRE(cpu.StackPointer() == sp_after_first - 3); }
     }
@@ -332,11 +372,13 @@ SCENARIO("PPU NMI edge cases", "[PPU][NMI]") {
 
       // Go through entire frame
       ppu.Tick(241 * 341); // Scanline 241 (VBlank starts, NMI triggered)
+      cpu.ServiceInterrupts();
       auto sp_after_nmi = cpu.StackPointer();
       REQUIRE(ppu.IsInVblank() == true);
 
       // Complete the VBlank period
       ppu.Tick(21 * 341); // Scanlines 242-261 and wrap to 0
+      cpu.ServiceInterrupts();
 
       THEN("VBlank should be cleared and scanline should wrap") {
         REQUIRE(ppu.CurrentScanline() == 0);
@@ -350,6 +392,7 @@ SCENARIO("PPU NMI edge cases", "[PPU][NMI]") {
 
       // Enter VBlank
       ppu.Tick(241 * 341);
+      cpu.ServiceInterrupts();
       REQUIRE(ppu.IsInVblank() == true);
 
       auto original_pc = cpu.ProgramCounter();
@@ -357,6 +400,7 @@ SCENARIO("PPU NMI edge cases", "[PPU][NMI]") {
 
       // Change other bits but keep NMI disabled
       ppu.WritePPUCTRL(0b01111111); // NMI still disabled (bit 7 = 0)
+      cpu.ServiceInterrupts();
 
       THEN("No NMI should be triggered") {
         REQUIRE(ppu.VblankNMIEnabled() == false);
@@ -0,0 +1,76 @@
+//
+// Created by Valerio Formato on 17-Oct-26.
+//
+
+#include "Tools/PPUPalette.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstdint>
+#include <vector>
+
+using namespace BNES;
+using namespace BNES::HW;
+
+SCENARIO("Palette variants for color emphasis and grayscale", "[PPU][Palette]") {
+  GIVEN("The built-in palette") {
+    WHEN("PPUMASK has no color effects") {
+      const auto &colors = PPUPaletteVariants[PaletteVariant(0b00011110)];
+
+      THEN("the colors are the plain ones") { REQUIRE(colors == PPUPalette); }
+    }
+
+    WHEN("PPUMASK selects grayscale") {
+      const auto &colors = PPUPaletteVariants[PaletteVariant(0b00000001)];
+
+      THEN("every color takes the one of its brightness column") {
+        REQUIRE(colors[0x16] == PPUPalette[0x10]);
+        REQUIRE(colors[0x2A] == PPUPalette[0x20]);
+        REQUIRE(colors[0x3F] == PPUPalette[0x30]);
+      }
+    }
+
+    WHEN("PPUMASK emphasizes red") {
+      const auto &colors = PPUPaletteVariants[PaletteVariant(0b00100000)];
+
+      THEN("red stays the same while green and blue get darker") {
+        REQUIRE(colors[0x20].color.r == PPUPalette[0x20].color.r);
+        REQUIRE(colors[0x20].color.g < PPUPalette[0x20].color.g);
+        REQUIRE(colors[0x20].color.b < PPUPalette[0x20].color.b);
+      }
+    }
+
+    WHEN("PPUMASK emphasizes all colors") {
+      const auto &colors = PPUPaletteVariants[PaletteVariant(0b11100000)];
+
+      THEN("every component gets darker") {
+        REQUIRE(colors[0x20].color.r < PPUPalette[0x20].color.r);
+        REQUIRE(colors[0x20].color.g < PPUPalette[0x20].color.g);
+        REQUIRE(colors[0x20].color.b < PPUPalette[0x20].color.b);
+      }
+    }
+  }
+
+  GIVEN("A .pal file with 512 colors") {
+    // Every color of emphasis set e is (e, index, 0)
+    std::vector<uint8_t> data;
+    for (uint8_t emphasis = 0; emphasis < 8; ++emphasis) {
+      for (uint8_t index = 0; index < 64; ++index) {
+        data.insert(data.end(), {emphasis, index, 0});
+      }
+    }
+    auto variants = PaletteFromPalFile(data);
+    REQUIRE(variants.has_value());
+
+    THEN("each emphasis set is used as it is") {
+      REQUIRE((*variants)[PaletteVariant(0b01000000)][0x12] == SDL::Pixel{{2, 0x12, 0}});
+      REQUIRE((*variants)[PaletteVariant(0b11000001)][0x12] == SDL::Pixel{{6, 0x10, 0}});
+    }
+  }
+
+  GIVEN("A .pal file of the wrong size") {
+    std::vector<uint8_t> data(100);
+
+    THEN("it is rejected") { REQUIRE_FALSE(PaletteFromPalFile(data).has_value()); }
+  }
+}
@@ -0,0 +1,248 @@
+//
+// Created by Valerio Formato on 17-Oct-26.
+//
+
+#include "HW/PPU.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <vector>
+
+using namespace BNES::HW;
+
+class PPUMock : public PPU {
+public:
+  using PPU::OAMDMATransfer;
+  using PPU::PPU;
+  using PPU::Tick;
+  using PPU::WritePPUADDR;
+  using PPU::WritePPUCTRL;
+  using PPU::WritePPUDATA;
+  using PPU::WritePPUMASK;
+  using PPU::WritePPUSCROLL;
+
+  void WriteToVRAM(Addr addr, uint8_t value) { m_vram[addr] = value; }
+  void WriteToPalette(uint8_t index, uint8_t value) { m_palette_table[index] = value; }
+
+  [[nodiscard]] uint8_t Pixel(unsigned int x, unsigned int y) const { return ScreenData()[y * 256 + x]; }
+};
+
+static constexpr unsigned int CYCLES_PER_SCANLINE = 341;
+static constexpr uint8_t BACKDROP = 0x0F;
+static constexpr uint8_t BG_COLOR = 0x21;
+static constexpr uint8_t BG_COLOR_PALETTE_2 = 0x2A;
+static constexpr uint8_t SPRITE_COLOR = 0x16;
+
+namespace {
+// Tile 1 is solid color 1, tile 2 is solid color 3 in the sprite pattern table
+std::vector<uint8_t> MakeCharacterRom() {
+  std::vector<uint8_t> chr(0x2000, 0x00);
+  std::fill_n(chr.begin() + 1 * PPU::TILE_MEMORY_SIZE, 8, 0xFF);
+  std::fill_n(chr.begin() + 0x1000 + 2 * PPU::TILE_MEMORY_SIZE, 16, 0xFF);
+  return chr;
+}
+
+void SetPalettes(PPUMock &ppu) {
+  ppu.WriteToPalette(0x00, BACKDROP);
+  ppu.WriteToPalette(0x01, BG_COLOR);
+  ppu.WriteToPalette(0x09, BG_COLOR_PALETTE_2);
+  ppu.WriteToPalette(0x13, SPRITE_COLOR);
+}
+} // namespace
+
+SCENARIO("Scanline rendering", "[PPU][Render]") {
+  GIVEN("A PPU with a single background tile at column 2, row 3") {
+    Bus bus;
+    REQUIRE(bus.LoadIntoChrRom(MakeCharacterRom()).has_value());
+    PPUMock ppu{bus};
+    ppu.Init();
+    SetPalettes(ppu);
+    ppu.WriteToVRAM(3 * 32 + 2, 1);
+
+    WHEN("rendering is disabled") {
+      ppu.Tick(240 * CYCLES_PER_SCANLINE);
+
+      THEN("the whole screen shows the backdrop color") {
+        REQUIRE(std::ranges::all_of(ppu.ScreenData(), [](uint8_t color) { return color == BACKDROP; }));
+      }
+    }
+
+    WHEN("the background is rendered") {
+      ppu.WritePPUMASK(0b00001010);
+      ppu.Tick(240 * CYCLES_PER_SCANLINE);
+
+      THEN("the tile is drawn in its place") {
+        REQUIRE(ppu.Pixel(16, 24) == BG_COLOR);
+        REQUIRE(ppu.Pixel(23, 31) == BG_COLOR);
+        REQUIRE(ppu.Pixel(15, 24) == BACKDROP);
+        REQUIRE(ppu.Pixel(24, 31) == BACKDROP);
+        REQUIRE(ppu.Pixel(16, 32) == BACKDROP);
+      }
+    }
+
+    WHEN("the attribute table selects another palette for that area") {
+      // Top-left 32x32 block, bottom-right quadrant
+      ppu.WriteToVRAM(0x3C0, 0b10000000);
+      ppu.WritePPUMASK(0b00001010);
+      ppu.Tick(240 * CYCLES_PER_SCANLINE);
+
+      THEN("the tile uses that palette") { REQUIRE(ppu.Pixel(16, 24) == BG_COLOR_PALETTE_2); }
+    }
+
+    WHEN("the background is scrolled") {
+      ppu.WritePPUSCROLL(12);
+      ppu.WritePPUSCROLL(0);
+      ppu.WritePPUMASK(0b00001010);
+      ppu.Tick(240 * CYCLES_PER_SCANLINE);
+
+      THEN("the tile moves left by the same amount") {
+        REQUIRE(ppu.Pixel(3, 24) == BACKDROP);
+        REQUIRE(ppu.Pixel(4, 24) == BG_COLOR);
+        REQUIRE(ppu.Pixel(11, 24) == BG_COLOR);
+        REQUIRE(ppu.Pixel(12, 24) == BACKDROP);
+      }
+    }
+
+    WHEN("the horizontal scroll changes halfway through the tile") {
+      ppu.WritePPUMASK(0b00001010);
+      ppu.Tick(28 * CYCLES_PER_SCANLINE);
+      ppu.WritePPUSCROLL(8);
+      ppu.WritePPUSCROLL(0);
+      ppu.Tick(212 * CYCLES_PER_SCANLINE);
+
+      THEN("only the scanlines after the change are scrolled") {
+        REQUIRE(ppu.Pixel(16, 27) == BG_COLOR);
+        REQUIRE(ppu.Pixel(8, 27) == BACKDROP);
+        REQUIRE(ppu.Pixel(16, 28) == BACKDROP);
+        REQUIRE(ppu.Pixel(8, 28) == BG_COLOR);
+      }
+    }
+
+    WHEN("the vertical scroll changes during the frame") {
+      ppu.WritePPUMASK(0b00001010);
+      ppu.WritePPUSCROLL(0);
+      ppu.WritePPUSCROLL(8);
+      ppu.Tick(240 * CYCLES_PER_SCANLINE);
+
+      THEN("it only takes effect from the next frame") {
+        REQUIRE(ppu.Pixel(16, 24) == BG_COLOR);
+
+        ppu.Tick(22 * CYCLES_PER_SCANLINE + 240 * CYCLES_PER_SCANLINE);
+        REQUIRE(ppu.Pixel(16, 16) == BG_COLOR);
+        REQUIRE(ppu.Pixel(16, 24) == BACKDROP);
+      }
+    }
+
+    WHEN("the nametable is written during vblank after a frame") {
+      ppu.WritePPUMASK(0b00001010);
+      ppu.Tick(241 * CYCLES_PER_SCANLINE);
+      const auto first_frame_tiles = ppu.TilesRedrawn();
+
+      // A new tile at column 5, row 3, and the one already there written again
+      ppu.WritePPUADDR(0x20);
+      ppu.WritePPUADDR(0x65);
+      ppu.WritePPUDATA(1);
+      ppu.WritePPUADDR(0x20);
+      ppu.WritePPUADDR(0x62);
+      ppu.WritePPUDATA(1);
+      ppu.Tick(21 * CYCLES_PER_SCANLINE + 240 * CYCLES_PER_SCANLINE);
+
+      THEN("only the changed tile is drawn again") {
+        REQUIRE(first_frame_tiles >= 960);
+        REQUIRE(ppu.TilesRedrawn() == 1);
+        REQUIRE(ppu.Pixel(40, 24) == BG_COLOR);
+        REQUIRE(ppu.Pixel(16, 24) == BG_COLOR);
+      }
+    }
+
+    WHEN("an attribute byte is written during vblank after a frame") {
+      ppu.WritePPUMASK(0b00001010);
+      ppu.Tick(241 * CYCLES_PER_SCANLINE);
+
+      ppu.WritePPUADDR(0x23);
+      ppu.WritePPUADDR(0xC0);
+      ppu.WritePPUDATA(0b10000000);
+      ppu.Tick(21 * CYCLES_PER_SCANLINE + 240 * CYCLES_PER_SCANLINE);
+
+      THEN("the 4x4 tiles it covers are drawn again") {
+        REQUIRE(ppu.TilesRedrawn() == 16);
+        REQUIRE(ppu.Pixel(16, 24) == BG_COLOR_PALETTE_2);
+      }
+    }
+
+    WHEN("the next frame is halfway drawn") {
+      ppu.WritePPUMASK(0b00001010);
+      ppu.Tick(240 * CYCLES_PER_SCANLINE);
+      const std::vector<uint8_t> frame(ppu.ScreenData().begin(), ppu.ScreenData().end());
+
+      ppu.WriteToPalette(0x01, BG_COLOR_PALETTE_2);
+      ppu.WritePPUMASK(0b10001010);
+      ppu.Tick(22 * CYCLES_PER_SCANLINE + 100 * CYCLES_PER_SCANLINE);
+
+      THEN("the screen still shows the last complete frame") {
+        REQUIRE(std::ranges::equal(ppu.ScreenData(), frame));
+        REQUIRE(ppu.ScanlineMasks()[0] == 0b00001010);
+
+        ppu.Tick(140 * CYCLES_PER_SCANLINE);
+        REQUIRE(ppu.Pixel(16, 24) == BG_COLOR_PALETTE_2);
+        REQUIRE(ppu.ScanlineMasks()[0] == 0b10001010);
+      }
+    }
+
+    WHEN("color emphasis is turned on during the frame") {
+      ppu.WritePPUMASK(0b00001010);
+      ppu.Tick(100 * CYCLES_PER_SCANLINE);
+      ppu.WritePPUMASK(0b10101010);
+      ppu.Tick(140 * CYCLES_PER_SCANLINE);
+
+      THEN("each scanline keeps the mask it was drawn with") {
+        REQUIRE(ppu.ScanlineMasks()[99] == 0b00001010);
+        REQUIRE(ppu.ScanlineMasks()[100] == 0b10101010);
+        REQUIRE(ppu.ScanlineMasks()[239] == 0b10101010);
+      }
+    }
+  }
+
+  GIVEN("A sprite overlapping the edge of a background tile") {
+    Bus bus;
+    REQUIRE(bus.LoadIntoChrRom(MakeCharacterRom()).has_value());
+    PPUMock ppu{bus};
+    ppu.Init();
+    SetPalettes(ppu);
+    ppu.WriteToVRAM(3 * 32 + 2, 1);
+
+    // Sprite at (20, 24) with tile 2 of the sprite pattern table ($1000 is selected by PPUCTRL below)
+    std::array<uint8_t, 256> oam{};
+    std::ranges::fill(oam, 0xFF);
+    oam[0] = 23;
+    oam[1] = 2;
+    oam[2] = 0x00;
+    oam[3] = 20;
+    ppu.WritePPUCTRL(0b00001000);
+
+    WHEN("the sprite is in front of the background") {
+      ppu.OAMDMATransfer(oam);
+      ppu.WritePPUMASK(0b00011110);
+      ppu.Tick(240 * CYCLES_PER_SCANLINE);
+
+      THEN("it covers the tile") {
+        REQUIRE(ppu.Pixel(19, 24) == BG_COLOR);
+        REQUIRE(ppu.Pixel(20, 24) == SPRITE_COLOR);
+        REQUIRE(ppu.Pixel(27, 31) == SPRITE_COLOR);
+      }
+    }
+
+    WHEN("the sprite is behind the background") {
+      oam[2] = 0b00100000;
+      ppu.OAMDMATransfer(oam);
+      ppu.WritePPUMASK(0b00011110);
+      ppu.Tick(240 * CYCLES_PER_SCANLINE);
+
+      THEN("it only shows where the background is transparent") {
+        REQUIRE(ppu.Pixel(20, 24) == BG_COLOR);
+        REQUIRE(ppu.Pixel(24, 24) == SPRITE_COLOR);
+      }
+    }
+  }
+}
@@ -13,9 +13,11 @@ public:
   using PPU::OAMDMATransfer;
   using PPU::PPU;
   using PPU::ReadPPUSTATUS;
+  using PPU::Sprite0HitDot;
   using PPU::Tick;
   using PPU::WritePPUCTRL;
   using PPU::WritePPUMASK;
+  using PPU::WritePPUSCROLL;
 
   void WriteToVRAM(Addr addr, uint8_t value) { m_vram[addr] = value; }
 };
@@ -247,3 +249,94 @@ SCENARIO("Sprite 0 hit flag detection", "[PPU][Sprite0]") {
     }
   }
 }
+
+// ─── Precomputed hit position ─────────────────────────────────────────────────
+
+SCENARIO("Sprite 0 hit position is known in advance", "[PPU][Sprite0]") {
+  GIVEN("sprite 0 over an opaque background") {
+    Bus bus;
+    std::vector<uint8_t> chr(CHR_ROM_SIZE, 0x00);
+    SetOpaqueTile(chr, 0);
+    REQUIRE(bus.LoadIntoChrRom(chr).has_value());
+    PPUMock ppu{bus};
+    ppu.Init();
+    ppu.WritePPUMASK(0b00011000);
+
+    auto oam = MakeOAM(40, 40, 0);
+    ppu.OAMDMATransfer(std::span<const uint8_t, 256>{oam});
+
+    THEN("the hit is at its top-left pixel") { REQUIRE(ppu.Sprite0HitDot() == 40 * CYCLES_PER_SCANLINE + 40); }
+
+    WHEN("the PPU goes past it in a single tick") {
+      ppu.Tick(100 * CYCLES_PER_SCANLINE);
+
+      THEN("the sprite 0 hit flag is set") { REQUIRE((ppu.ReadPPUSTATUS() & 0b01000000) != 0); }
+    }
+
+    WHEN("sprite 0 is moved") {
+      oam = MakeOAM(60, 50, 0);
+      ppu.OAMDMATransfer(std::span<const uint8_t, 256>{oam});
+
+      THEN("the hit moves with it") { REQUIRE(ppu.Sprite0HitDot() == 50 * CYCLES_PER_SCANLINE + 60); }
+    }
+
+    WHEN("rendering is disabled") {
+      ppu.WritePPUMASK(0b00000000);
+
+      THEN("there is no hit") { REQUIRE(!ppu.Sprite0HitDot().has_value()); }
+    }
+  }
+
+  GIVEN("sprite 0 next to the only opaque background tile") {
+    Bus bus;
+    std::vector<uint8_t> chr(CHR_ROM_SIZE, 0x00);
+    SetOpaqueTile(chr, 0);
+    REQUIRE(bus.LoadIntoChrRom(chr).has_value());
+    PPUMock ppu{bus};
+    ppu.Init();
+    ppu.WritePPUMASK(0b00011000);
+
+    // Everything is the transparent tile 1, except for the tile at column 6, row 5
+    for (Bus::Addr index = 0; index < 960; ++index) {
+      ppu.WriteToVRAM(index, 1);
+    }
+    ppu.WriteToVRAM(166, 0);
+
+    auto oam = MakeOAM(40, 40, 0);
+    ppu.OAMDMATransfer(std::span<const uint8_t, 256>{oam});
+
+    THEN("there is no hit") { REQUIRE(!ppu.Sprite0HitDot().has_value()); }
+
+    WHEN("the background is scrolled left by one tile") {
+      ppu.WritePPUSCROLL(8);
+      ppu.WritePPUSCROLL(0);
+
+      THEN("the opaque tile ends up under sprite 0") {
+        REQUIRE(ppu.Sprite0HitDot() == 40 * CYCLES_PER_SCANLINE + 40);
+      }
+    }
+  }
+
+  GIVEN("sprite 0 with a tile in CHR-RAM that is still blank") {
+    Bus bus;
+    PPUMock ppu{bus};
+    ppu.Init();
+    ppu.WritePPUMASK(0b00011000);
+
+    auto oam = MakeOAM(40, 40, 1);
+    ppu.OAMDMATransfer(std::span<const uint8_t, 256>{oam});
+    // Tile 0 (the background) is opaque, tile 1 (the sprite) is transparent
+    for (Bus::Addr row = 0; row < 8; ++row) {
+      REQUIRE(bus.WriteCharacter(row, 0xFF));
+    }
+
+    THEN("there is no hit") { REQUIRE(!ppu.Sprite0HitDot().has_value()); }
+
+    WHEN("the sprite tile is drawn") {
+      REQUIRE(!ppu.Sprite0HitDot().has_value());
+      REQUIRE(bus.WriteCharacter(PPU::TILE_MEMORY_SIZE + 2, 0b00010000));
+
+      THEN("the hit is found at the new pixel") { REQUIRE(ppu.Sprite0HitDot() == 42 * CYCLES_PER_SCANLINE + 43); }
+    }
+  }
+}
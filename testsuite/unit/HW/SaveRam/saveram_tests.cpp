@@ -0,0 +1,126 @@
+//
+// Created by Valerio Formato on 17-Oct-26.
+//
+
+#include "HW/Bus.h"
+#include "HW/SaveRam.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <array>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+using namespace BNES::HW;
+
+namespace {
+std::vector<uint8_t> ReadFile(const std::filesystem::path &path) {
+  std::ifstream file{path, std::ios::binary};
+  return {std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+}
+
+// An iNES 1.0 MMC1 ROM with the battery flag set, which gets the usual 8KB of battery-backed PRG-RAM
+std::filesystem::path WriteBatteryRom() {
+  auto path = std::filesystem::temp_directory_path() / "bnes_test_battery.nes";
+
+  // clang-format off
+  std::array<uint8_t, 16> header = {
+    0x4E, 0x45, 0x53, 0x1A, // "NES\x1A" tag
+    0x02,                   // 2 PRG ROM banks
+    0x01,                   // 1 CHR ROM bank
+    0x12,                   // flags6: mapper 1 (low nibble), battery
+    0x00,                   // flags7
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  };
+  // clang-format on
+
+  std::ofstream out{path, std::ios::binary};
+  out.write(reinterpret_cast<const char *>(header.data()), header.size());
+  std::vector<uint8_t> zeros(2 * 0x4000 + 0x2000, 0x00);
+  out.write(reinterpret_cast<const char *>(zeros.data()), static_cast<std::streamsize>(zeros.size()));
+
+  return path;
+}
+} // namespace
+
+SCENARIO("Battery-backed save RAM", "[SaveRam]") {
+  GIVEN("A save file that doesn't exist yet") {
+    auto path = std::filesystem::temp_directory_path() / "bnes_test_saveram.sav";
+    std::filesystem::remove(path);
+
+    WHEN("The save RAM is created") {
+      auto maybe_ram = SaveRam::FromFile(path, 0x2000);
+      REQUIRE(maybe_ram.has_value());
+      auto &ram = maybe_ram.value();
+
+      THEN("The file is created, zero-filled") {
+        REQUIRE(ram.IsBatteryBacked());
+        REQUIRE(ram.Size() == 0x2000);
+        REQUIRE(std::filesystem::file_size(path) == 0x2000);
+        REQUIRE(std::ranges::all_of(ReadFile(path), [](auto byte) { return byte == 0; }));
+      }
+
+      AND_WHEN("It is written to and flushed") {
+        ram.Data()[0x10] = 0x42;
+        REQUIRE(ram.Flush().has_value());
+
+        THEN("The file has the new contents") { REQUIRE(ReadFile(path)[0x10] == 0x42); }
+      }
+
+      AND_WHEN("It is written to and dropped without flushing") {
+        ram.Data()[0x1FFF] = 0x99;
+        ram = SaveRam{};
+
+        THEN("The contents are still saved") { REQUIRE(ReadFile(path)[0x1FFF] == 0x99); }
+
+        AND_THEN("They are there when the file is loaded again") {
+          auto reloaded = SaveRam::FromFile(path, 0x2000);
+          REQUIRE(reloaded.has_value());
+          REQUIRE(reloaded->Data()[0x1FFF] == 0x99);
+        }
+      }
+    }
+
+    std::filesystem::remove(path);
+  }
+
+  GIVEN("A cartridge with a battery") {
+    auto rom_path = WriteBatteryRom();
+    auto save_path = std::filesystem::path{rom_path}.replace_extension(".sav");
+    std::filesystem::remove(save_path);
+
+    WHEN("The game writes to PRG-RAM") {
+      {
+        Bus bus;
+        REQUIRE(bus.LoadRom(rom_path.string()).has_value());
+        REQUIRE(bus.PrgRam().IsBatteryBacked());
+        bus.Write(0x6000, 0x12);
+        bus.Write(0x7FFF, 0x34);
+        REQUIRE(bus.FlushSaveRam().has_value());
+      }
+
+      THEN("The save file is next to the ROM") {
+        const auto save = ReadFile(save_path);
+        REQUIRE(save.size() == 0x2000);
+        REQUIRE(save[0x0000] == 0x12);
+        REQUIRE(save[0x1FFF] == 0x34);
+      }
+
+      AND_WHEN("The cartridge is loaded again") {
+        Bus bus;
+        REQUIRE(bus.LoadRom(rom_path.string()).has_value());
+
+        THEN("The game finds its save") {
+          REQUIRE(bus.Read(0x6000) == 0x12);
+          REQUIRE(bus.Read(0x7FFF) == 0x34);
+        }
+      }
+    }
+
+    std::filesystem::remove(rom_path);
+    std::filesystem::remove(save_path);
+  }
+}
@@ -0,0 +1,86 @@
+#include "HW/Bus.h"
+#include "HW/PPU.h"
+#include "HW/Scheduler.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace BNES::HW;
+
+SCENARIO("Scheduler event queue", "[Scheduler]") {
+  GIVEN("An empty scheduler") {
+    Scheduler scheduler;
+
+    THEN("Nothing is due") {
+      REQUIRE(scheduler.Now() == 0);
+      REQUIRE(scheduler.NextEventTime() == Scheduler::Never);
+      REQUIRE_FALSE(scheduler.EventDue());
+      REQUIRE_FALSE(scheduler.PopDueEvent().has_value());
+    }
+
+    WHEN("Events are scheduled out of order") {
+      scheduler.Schedule(Event::FrameEnd, 300);
+      scheduler.Schedule(Event::VBlankStart, 100);
+      scheduler.Schedule(Event::Sprite0, 200);
+
+      THEN("The earliest one comes first") {
+        REQUIRE(scheduler.NextEventTime() == 100);
+        REQUIRE(scheduler.Deadline(Event::Sprite0) == 200);
+        REQUIRE_FALSE(scheduler.Deadline(Event::PreRender).has_value());
+      }
+
+      AND_WHEN("An event is scheduled again") {
+        scheduler.Schedule(Event::VBlankStart, 400);
+
+        THEN("Its old deadline is replaced") {
+          REQUIRE(scheduler.NextEventTime() == 200);
+          REQUIRE(scheduler.Deadline(Event::VBlankStart) == 400);
+        }
+      }
+
+      AND_WHEN("An event is cancelled") {
+        scheduler.Cancel(Event::VBlankStart);
+
+        THEN("It's gone from the queue") {
+          REQUIRE(scheduler.NextEventTime() == 200);
+          REQUIRE_FALSE(scheduler.Deadline(Event::VBlankStart).has_value());
+        }
+      }
+
+      AND_WHEN("The clock goes past some of them") {
+        scheduler.Advance(250);
+
+        THEN("Only those are popped, in order") {
+          REQUIRE(scheduler.EventDue());
+          REQUIRE(scheduler.PopDueEvent() == Event::VBlankStart);
+          REQUIRE(scheduler.PopDueEvent() == Event::Sprite0);
+          REQUIRE_FALSE(scheduler.PopDueEvent().has_value());
+          REQUIRE(scheduler.NextEventTime() == 300);
+        }
+      }
+    }
+  }
+}
+
+SCENARIO("PPU deadlines on the master clock", "[Scheduler][PPU]") {
+  GIVEN("A bus with a PPU attached") {
+    Bus bus;
+    PPU ppu{bus};
+
+    THEN("The PPU events are scheduled in PPU dots") {
+      const auto &scheduler = bus.GetScheduler();
+      REQUIRE(scheduler.Deadline(Event::VBlankStart) == 241 * 341);
+      REQUIRE(scheduler.Deadline(Event::PreRender) == 261 * 341);
+      REQUIRE(scheduler.Deadline(Event::FrameEnd) == 262 * 341);
+      REQUIRE(scheduler.NextEventTime() == 241 * 341);
+    }
+
+    WHEN("The CPU runs") {
+      bus.Tick(100);
+
+      THEN("The master clock moves by 3 dots per CPU cycle") {
+        REQUIRE(bus.GetScheduler().Now() == 300);
+        REQUIRE(bus.CyclesUntilNextEvent() == (241 * 341 - 300) / Bus::PPU_FREQ_RATIO);
+      }
+    }
+  }
+}
@@ -0,0 +1,66 @@
+//
+// Created by Valerio Formato on 17-Oct-26.
+//
+
+#include "HW/TileDecoder.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+using namespace BNES::HW;
+
+SCENARIO("Tile decoding", "[TileDecoder]") {
+  auto implementation = GENERATE(TileDecoder::Implementation::Reference, TileDecoder::Implementation::SpreadTable,
+                                 TileDecoder::Implementation::SSE2, TileDecoder::Implementation::AVX2);
+  // Nothing to check for instruction sets this CPU doesn't have
+  if (!TileDecoder::Supported(implementation)) {
+    return;
+  }
+
+  GIVEN("A tile with a different color in each corner") {
+    std::array<uint8_t, TileDecoder::TILE_BYTES> tile{};
+    // Low plane: top-left and bottom-left, high plane: top-right and bottom-left
+    tile[0] = 0b10000000;
+    tile[7] = 0b10000000;
+    tile[8] = 0b00000001;
+    tile[15] = 0b10000000;
+    std::array<uint8_t, TileDecoder::TILE_PIXELS> pixels{};
+    TileDecoder::Decode(implementation, tile, pixels);
+
+    THEN("Every pixel gets the color index of its two plane bits") {
+      REQUIRE(pixels[0] == 1);
+      REQUIRE(pixels[7] == 2);
+      REQUIRE(pixels[56] == 3);
+      REQUIRE(pixels[63] == 0);
+    }
+  }
+
+  GIVEN("Two whole pattern tables") {
+    // A simple LCG, so that every plane byte value shows up a few times
+    std::vector<uint8_t> chr_data(0x2000);
+    uint32_t state = 12345;
+    for (auto &byte : chr_data) {
+      state = state * 1664525 + 1013904223;
+      byte = static_cast<uint8_t>(state >> 24);
+    }
+
+    std::vector<uint8_t> expected(512 * TileDecoder::TILE_PIXELS);
+    TileDecoder::Decode(TileDecoder::Implementation::Reference, chr_data, expected);
+
+    THEN("All tiles decode the same as the reference implementation") {
+      std::vector<uint8_t> pixels(expected.size());
+      TileDecoder::Decode(implementation, chr_data, pixels);
+      REQUIRE(pixels == expected);
+    }
+
+    THEN("The dispatched implementation agrees too") {
+      std::vector<uint8_t> pixels(expected.size());
+      TileDecoder::Decode(chr_data, pixels);
+      REQUIRE(pixels == expected);
+    }
+  }
+}
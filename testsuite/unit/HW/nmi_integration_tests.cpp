@@ -28,19 +28,8 @@ public:
   using PPU::WritePPUCTRL;
 };
 
-// Helper to execute one CPU instruction
-void ExecuteOneInstruction(CPUMock &cpu) {
-  auto pc = cpu.ProgramCounter();
-
-  // Read instruction bytes
-  std::array<uint8_t, 3> instr_bytes{};
-  for (size_t i = 0; i < 3; ++i) {
-    instr_bytes[i] = cpu.ReadFromMemory(pc + i);
-  }
-
-  std::span bytes(instr_bytes.begin(), 3);
-  cpu.RunInstruction(cpu.DecodeInstruction(bytes));
-}
+// Helper to execute one CPU instruction, servicing any pending interrupt first
+void ExecuteOneInstruction(CPUMock &cpu) { cpu.Step(); }
 
 SCENARIO("NMI integration tests - Full system flow", "[NMI][Integration]") {
   GIVEN("A complete NES system with ROM containing an NMI handler") {
@@ -90,12 +79,19 @@ SCENARIO("NMI integration tests - Full system flow", "[NMI][Integration]") {
       // Tick through one frame to scanline 241 (VBlank)
       ppu.Tick(241 * 341);
 
-      THEN("NMI should be triggered") {
+      THEN("NMI should be latched until the next instruction") {
         REQUIRE(ppu.CurrentScanline() == 241);
         REQUIRE(ppu.IsInVblank() == true);
+        REQUIRE(cpu.InterruptPending(CPU::Interrupt::NMI));
+        REQUIRE(cpu.ProgramCounter() == 0x8000);
+      }
 
-        // CPU should have jumped to NMI handler
-        REQUIRE(cpu.ProgramCounter() == 0x9000);
+      THEN("NMI should be serviced before the next instruction") {
+        // Jump to the NMI handler and execute its first instruction (INC $0200)
+        ExecuteOneInstruction(cpu);
+
+        REQUIRE_FALSE(cpu.InterruptPending(CPU::Interrupt::NMI));
+        REQUIRE(cpu.ProgramCounter() == 0x9003);
 
         // Interrupt disable flag should be set
         REQUIRE(cpu.TestStatusFlag(CPU::StatusFlag::InterruptDisable) == true);
@@ -234,9 +230,12 @@ SCENARIO("NMI integration tests - Timing and edge cases", "[NMI][Integration]")
       // Enable NMI during VBlank
       ppu.WritePPUCTRL(0b10000000);
 
-      THEN("NMI should trigger immediately") {
-        REQUIRE(cpu.ProgramCounter() == 0x9000);
-        REQUIRE(cpu.ProgramCounter() != pc_before);
+      THEN("NMI should trigger at the next instruction") {
+        REQUIRE(cpu.ProgramCounter() == pc_before);
+
+        ExecuteOneInstruction(cpu); // INC $0200 in the handler
+        REQUIRE(cpu.ProgramCounter() == 0x9003);
+        REQUIRE(bus.Read(0x0200) == 0x01);
       }
     }
   }